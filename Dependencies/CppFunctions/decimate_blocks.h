@@ -0,0 +1,247 @@
+#ifndef DECIMATE_BLOCKS_H
+#define DECIMATE_BLOCKS_H
+// Edge collapse decimation of spatial blocks of a mesh in parallel, followed
+// by one global pass over the much smaller stitched mesh. Nothing here
+// depends on MATLAB.
+#include <igl/connect_boundary_to_infinity.h>
+#include <igl/decimate.h>
+#include <igl/is_edge_manifold.h>
+#include <igl/max_faces_stopping_condition.h>
+#include <igl/parallel_for.h>
+#include <igl/shortest_edge_and_midpoint.h>
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Decimated block, indexed into the input mesh
+struct DecimatedBlock
+{
+  std::vector<Eigen::RowVector3d> vertices;
+  // input vertex each vertex was born from
+  std::vector<int> birth_vertex;
+  std::vector<Eigen::RowVector3i> faces;
+  // input face each face was born from
+  std::vector<int> birth_face;
+};
+
+// Decimates the faces block_faces of (V,F) with igl::decimate's shortest edge
+// collapses and max_faces stopping condition, never collapsing an edge of a
+// locked vertex. Blocks that are not edge manifold once their boundary is
+// connected to infinity are returned unchanged.
+inline void decimate_block(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const std::vector<int> & block_faces,
+  const std::vector<char> & locked,
+  const double ratio,
+  DecimatedBlock & B)
+{
+  // local copy of the block
+  std::vector<int> global;
+  for(const int f : block_faces) for(int c = 0;c<3;c++) global.push_back(F(f,c));
+  std::sort(global.begin(),global.end());
+  global.erase(std::unique(global.begin(),global.end()),global.end());
+  const auto local = [&](const int v)
+  {
+    return (int)(std::lower_bound(global.begin(),global.end(),v)-global.begin());
+  };
+  const int nb = global.size(), mb = block_faces.size();
+  Eigen::MatrixXd VB(nb,3);
+  Eigen::MatrixXi FB(mb,3);
+  for(int v = 0;v<nb;v++) VB.row(v) = V.row(global[v]);
+  for(int f = 0;f<mb;f++) for(int c = 0;c<3;c++) FB(f,c) = local(F(block_faces[f],c));
+
+  Eigen::MatrixXd VO,U;
+  Eigen::MatrixXi FO,G;
+  Eigen::VectorXi J,I;
+  igl::connect_boundary_to_infinity(VB,FB,VO,FO);
+  bool decimated = false;
+  if(igl::is_edge_manifold(FO))
+  {
+    const auto cost_and_placement = [&](
+      const int e,
+      const Eigen::MatrixXd & W,
+      const Eigen::MatrixXi & WF,
+      const Eigen::MatrixXi & E,
+      const Eigen::VectorXi & EMAP,
+      const Eigen::MatrixXi & EF,
+      const Eigen::MatrixXi & EI,
+      double & cost,
+      Eigen::RowVectorXd & p)
+    {
+      igl::shortest_edge_and_midpoint(e,W,WF,E,EMAP,EF,EI,cost,p);
+      // E only indexes block vertices and the vertex at infinity (nb)
+      if((E(e,0)<nb && locked[global[E(e,0)]]) || (E(e,1)<nb && locked[global[E(e,1)]]))
+      {
+        cost = std::numeric_limits<double>::infinity();
+      }
+    };
+    int m = mb;
+    const int max_m = std::max(1,(int)std::lround(ratio*mb));
+    igl::decimate(
+      VO,FO,cost_and_placement,igl::max_faces_stopping_condition(m,mb,max_m),U,G,J,I);
+    decimated = true;
+  }
+  if(!decimated)
+  {
+    U = VB;
+    G = FB;
+    J = Eigen::VectorXi::LinSpaced(mb,0,mb-1);
+    I = Eigen::VectorXi::LinSpaced(nb,0,nb-1);
+  }
+
+  // drop the faces at infinity and the vertices they leave unreferenced
+  std::vector<int> index(U.rows(),-1);
+  B = DecimatedBlock();
+  for(int f = 0;f<G.rows();f++)
+  {
+    if(J(f)>=mb) continue;
+    Eigen::RowVector3i face;
+    for(int c = 0;c<3;c++)
+    {
+      int & u = index[G(f,c)];
+      if(u<0)
+      {
+        u = B.vertices.size();
+        B.vertices.push_back(U.row(G(f,c)));
+        B.birth_vertex.push_back(global[I(G(f,c))]);
+      }
+      face(c) = u;
+    }
+    B.faces.push_back(face);
+    B.birth_face.push_back(block_faces[J(f)]);
+  }
+}
+
+// Inputs:
+//   V  #V by 3 list of vertex positions
+//   F  #F by 3 list of triangle indices of a manifold mesh (possibly with
+//     boundary)
+//   max_m  number of faces to decimate to
+//   blocks  number of blocks along each axis of the bounding box
+// Outputs:
+//   U,G,J,I  as igl::decimate(V,F,max_m,U,G,J,I)
+// Returns whether the final pass reached max_m faces, as igl::decimate
+//
+// Faces belong to the block of their centroid. Each block is decimated by
+// the same fraction max_m/#F with the vertices it shares with other blocks
+// locked, so the blocks still match along the seams and are stitched back by
+// those vertices. The global igl::decimate pass then only has to remove the
+// faces left around the seams.
+inline bool decimate_blocks(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const size_t max_m,
+  const int blocks,
+  Eigen::MatrixXd & U,
+  Eigen::MatrixXi & G,
+  Eigen::VectorXi & J,
+  Eigen::VectorXi & I)
+{
+  const int n = V.rows(), m = F.rows();
+  if(blocks<=1 || m==0)
+  {
+    return igl::decimate(V,F,max_m,U,G,J,I);
+  }
+  const int num_blocks = blocks*blocks*blocks;
+  const Eigen::RowVector3d min_corner = V.colwise().minCoeff();
+  const Eigen::RowVector3d extent =
+    (V.colwise().maxCoeff()-min_corner).cwiseMax(std::numeric_limits<double>::min());
+
+  // Faces of every block (counting sort by block of centroid)
+  std::vector<int> face_block(m);
+  std::vector<std::vector<int> > block_faces(num_blocks);
+  for(int f = 0;f<m;f++)
+  {
+    const Eigen::RowVector3d c = (V.row(F(f,0))+V.row(F(f,1))+V.row(F(f,2)))/3.;
+    int b = 0;
+    for(int d = 2;d>=0;d--)
+    {
+      const int k = (int)std::floor((c(d)-min_corner(d))/extent(d)*blocks);
+      b = b*blocks+std::min(blocks-1,std::max(0,k));
+    }
+    face_block[f] = b;
+    block_faces[b].push_back(f);
+  }
+  // Vertices on faces of more than one block are locked
+  std::vector<int> vertex_block(n,-1);
+  std::vector<char> locked(n,0);
+  for(int f = 0;f<m;f++)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      int & b = vertex_block[F(f,c)];
+      if(b<0) b = face_block[f];
+      else if(b!=face_block[f]) locked[F(f,c)] = 1;
+    }
+  }
+
+  const double ratio = double(max_m)/m;
+  std::vector<DecimatedBlock> decimated(num_blocks);
+  igl::parallel_for(
+    num_blocks,
+    [&](const int b)
+    {
+      if(!block_faces[b].empty())
+      {
+        decimate_block(V,F,block_faces[b],locked,ratio,decimated[b]);
+      }
+    },
+    1);
+
+  // Stitch the blocks by their locked vertices
+  std::vector<int> stitched_index(n,-1);
+  std::vector<Eigen::RowVector3d> SV;
+  std::vector<int> SI, SJ;
+  std::vector<Eigen::RowVector3i> SF;
+  for(DecimatedBlock & B : decimated)
+  {
+    std::vector<int> index(B.vertices.size());
+    for(size_t u = 0;u<B.vertices.size();u++)
+    {
+      const int v = B.birth_vertex[u];
+      if(locked[v] && stitched_index[v]>=0)
+      {
+        index[u] = stitched_index[v];
+        continue;
+      }
+      index[u] = SV.size();
+      if(locked[v]) stitched_index[v] = index[u];
+      SV.push_back(B.vertices[u]);
+      SI.push_back(v);
+    }
+    for(size_t f = 0;f<B.faces.size();f++)
+    {
+      SF.emplace_back(index[B.faces[f](0)],index[B.faces[f](1)],index[B.faces[f](2)]);
+      SJ.push_back(B.birth_face[f]);
+    }
+    B = DecimatedBlock();
+  }
+  Eigen::MatrixXd W(SV.size(),3);
+  Eigen::MatrixXi H(SF.size(),3);
+  for(size_t v = 0;v<SV.size();v++) W.row(v) = SV[v];
+  for(size_t f = 0;f<SF.size();f++) H.row(f) = SF[f];
+
+  // Global pass over the seams
+  bool ret = true;
+  Eigen::VectorXi K,L;
+  if((size_t)H.rows()>max_m)
+  {
+    ret = igl::decimate(W,H,max_m,U,G,K,L);
+  }else
+  {
+    U = W;
+    G = H;
+    K = Eigen::VectorXi::LinSpaced(H.rows(),0,H.rows()-1);
+    L = Eigen::VectorXi::LinSpaced(W.rows(),0,W.rows()-1);
+  }
+  J.resize(K.size());
+  I.resize(L.size());
+  for(int f = 0;f<K.size();f++) J(f) = SJ[K(f)];
+  for(int v = 0;v<L.size();v++) I(v) = SI[L(v)];
+  return ret;
+}
+
+#endif
@@ -0,0 +1,26 @@
+% DECIMATE_BLOCKS Decimate a manifold mesh (V,F) block by block in parallel,
+% then over the seams between blocks
+%
+% [W,G] = decimate_blocks(V,F,ratio)
+% [W,G,J,I] = decimate_blocks(V,F,ratio,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   V  #V by 3 list of vertex positions
+%   F  #F by 3 list of triangle indices into V
+%   ratio   either a 1<number<#F  of max faces, or a 0<ratio<1 to be multiplied
+%     against #F to get max faces in output
+%   Optional:
+%     'Blocks' followed by the number of blocks along each axis of the
+%       bounding box {4}, 1 is decimate_libigl(V,F,ratio)
+% Outputs:
+%   W  #W by 3 list of vertex positions
+%   G  #G by 3 list of triangle indices into W
+%   J  #G list of indices into F of birth face
+%   I  #W list of indices into V of birth vertices
+%
+% Collapses the shortest edge to its midpoint, as decimate_libigl's 'naive'
+% method. Every block (the faces whose centroid falls in it) is decimated by
+% ratio on its own thread with the vertices it shares with other blocks
+% locked; a last pass over the stitched mesh, about ratio*#F faces plus the
+% seams, removes the faces left along the seams.
+%
@@ -0,0 +1,97 @@
+#include "vertex_frontier.h"
+#include <Eigen/Core>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs==4,"nrhs should be 4");
+  mexErrMsgTxt(mxIsDouble(prhs[1]) && !mxIsSparse(prhs[1]),"L should be a full double vector");
+  const int n = mxGetNumberOfElements(prhs[1]);
+  const double * L = mxGetPr(prhs[1]);
+  MeshGraph G;
+  if(mxIsSparse(prhs[0]))
+  {
+    mexErrMsgTxt(mxGetM(prhs[0])==(size_t)n && mxGetN(prhs[0])==(size_t)n,"A must be #L by #L");
+    mesh_graph_from_csc(mxGetJc(prhs[0]),mxGetIr(prhs[0]),n,G);
+  }else
+  {
+    MatrixXi F;
+    parse_rhs_index(prhs,F);
+    mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+    mexErrMsgTxt(F.size()==0 || (F.minCoeff()>=0 && F.maxCoeff()<n),"F must index L");
+    mesh_graph_from_faces(F,n,G);
+  }
+  mexErrMsgTxt(
+    mxIsDouble(prhs[2]) && mxGetNumberOfElements(prhs[2])==1,
+    "val should be scalar");
+  const double val = *mxGetPr(prhs[2]);
+  mexErrMsgTxt(
+    (mxIsLogical(prhs[3]) || mxIsDouble(prhs[3])) && !mxIsSparse(prhs[3]) &&
+    (int)mxGetNumberOfElements(prhs[3])==n,
+    "avoid should be a full #L logical vector");
+  std::vector<char> avoid(n);
+  for(int v = 0;v<n;v++)
+  {
+    avoid[v] = mxIsLogical(prhs[3]) ? ((mxLogical*)mxGetData(prhs[3]))[v] : mxGetPr(prhs[3])[v]!=0;
+  }
+
+  std::vector<int> seeds;
+  for(int v = 0;v<n;v++) if(L[v]==val) seeds.push_back(v);
+
+  plhs[0] = mxCreateDoubleMatrix(mxGetM(prhs[1]),mxGetN(prhs[1]),mxREAL);
+  double * D = mxGetPr(plhs[0]);
+  std::copy(L,L+n,D);
+  std::vector<double> H(nlhs>1 ? n : 0,std::numeric_limits<double>::infinity());
+  if(nlhs>1) for(const int s : seeds) H[s] = 0;
+
+  VertexFrontier frontier(G);
+  frontier.dilate(
+    seeds,
+    [&](const int v){ return !avoid[v]; },
+    [&](const int v, const int hop)
+    {
+      D[v] = val;
+      if(nlhs>1) H[v] = hop;
+    });
+
+  switch(nlhs)
+  {
+    case 2:
+    {
+      plhs[1] = mxCreateDoubleMatrix(n,1,mxREAL);
+      std::copy(H.begin(),H.end(),mxGetPr(plhs[1]));
+    }
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
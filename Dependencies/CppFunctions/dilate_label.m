@@ -0,0 +1,23 @@
+% DILATE_LABEL Grow the vertices of one label breadth first over a mesh into
+% all vertices reachable without crossing an avoided vertex
+%
+% L = dilate_label(F,L,val,avoid)
+% [L,H] = dilate_label(A,L,val,avoid)
+%
+% Inputs:
+%   F  #F by 3 list of triangle indices, or
+%   A  #V by #V symmetric sparse adjacency matrix
+%   L  #V list of vertex labels
+%   val  label to grow; the vertices with L == val are the seeds
+%   avoid  #V logical list of vertices that must not be grown into
+% Outputs:
+%   L  #V list of labels with every reached vertex labelled val
+%   H  #V list of hops at which each vertex was reached (0 for the seeds,
+%     Inf if never reached)
+%
+% This is the fixed point of the core growing loop of runPartsCleanUp,
+%   while any(front)
+%     front = any(A(:,front),2) & ~visited & ~avoid; L(front) = val; visited(front) = true;
+%   end
+% computed in time proportional to the reached vertices and their edges.
+%
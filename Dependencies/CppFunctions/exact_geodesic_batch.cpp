@@ -0,0 +1,176 @@
+// Compile with -I../gptoolbox/external/exactgeodesic/src
+#include <memory> // geodesic_memory.h uses std::auto_ptr
+#include <geodesic_algorithm_exact_batch.h>
+#include <Eigen/Core>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+  MatrixXd V;
+  MatrixXi F;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=3,"nrhs should be >= 3");
+  parse_rhs_double(prhs,V);
+  parse_rhs_index(prhs+1,F);
+  mexErrMsgTxt(V.cols()==3,"V must be #V by 3");
+  mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+  mexErrMsgTxt(F.minCoeff()>=0 && F.maxCoeff()<V.rows(),"F must index V");
+
+  // One list of source vertices per set: a cell of lists, or a list of single
+  // sources
+  std::vector<std::vector<unsigned> > sets;
+  if(mxIsCell(prhs[2]))
+  {
+    sets.resize(mxGetNumberOfElements(prhs[2]));
+    for(size_t s = 0;s<sets.size();s++)
+    {
+      const mxArray * c = mxGetCell(prhs[2],s);
+      mexErrMsgTxt(c && mxIsDouble(c),"source sets should be lists of vertex indices");
+      const double * cd = mxGetPr(c);
+      for(size_t j = 0;j<mxGetNumberOfElements(c);j++) sets[s].push_back((unsigned)(cd[j]-1));
+    }
+  }else
+  {
+    mexErrMsgTxt(mxIsDouble(prhs[2]),"sources should be a list or a cell of lists of vertex indices");
+    const double * sd = mxGetPr(prhs[2]);
+    sets.resize(mxGetNumberOfElements(prhs[2]));
+    for(size_t s = 0;s<sets.size();s++) sets[s].push_back((unsigned)(sd[s]-1));
+  }
+  for(const auto & set : sets)
+  {
+    mexErrMsgTxt(!set.empty(),"source sets should not be empty");
+    for(const unsigned v : set) mexErrMsgTxt(v<(unsigned)V.rows(),"sources must index V");
+  }
+
+  int k = 0;
+  double max_distance = geodesic::GEODESIC_INF;
+  double memory_limit = 0;
+  {
+    int i = 3;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("K",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        k = (int)*mxGetPr(prhs[++i]);
+        mexErrMsgTxt(k>=0,"K should be >= 0");
+      }else if(strcmp("MaxDistance",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        max_distance = std::min(*mxGetPr(prhs[++i]),geodesic::GEODESIC_INF);
+      }else if(strcmp("MemoryLimit",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        memory_limit = *mxGetPr(prhs[++i]);
+        mexErrMsgTxt(memory_limit>=0,"MemoryLimit should be >= 0");
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+
+  std::vector<double> points(V.size());
+  for(int v = 0;v<V.rows();v++)
+  {
+    for(int c = 0;c<3;c++) points[3*v+c] = V(v,c);
+  }
+  std::vector<unsigned> faces(F.size());
+  for(int f = 0;f<F.rows();f++)
+  {
+    for(int c = 0;c<3;c++) faces[3*f+c] = F(f,c);
+  }
+  geodesic::Mesh mesh;
+  mesh.initialize_mesh_data(points,faces);
+  std::vector<std::vector<geodesic::SurfacePoint> > source_sets(sets.size());
+  for(size_t s = 0;s<sets.size();s++)
+  {
+    for(const unsigned v : sets[s])
+    {
+      source_sets[s].push_back(geodesic::SurfacePoint(&mesh.vertices()[v]));
+    }
+  }
+  geodesic::GeodesicAlgorithmExactBatch algorithm(&mesh);
+  algorithm.set_memory_limit((size_t)memory_limit);
+
+  const size_t n = V.rows();
+  const auto to_matlab = [](const double d)
+  {
+    return d<geodesic::GEODESIC_INF ? d : std::numeric_limits<double>::infinity();
+  };
+  std::vector<double> distances;
+  if(k==0)
+  {
+    algorithm.distances(source_sets,distances,max_distance);
+    plhs[0] = mxCreateDoubleMatrix(n,sets.size(),mxREAL);
+    double * d = mxGetPr(plhs[0]);
+    for(size_t i = 0;i<distances.size();i++) d[i] = to_matlab(distances[i]);
+  }else
+  {
+    std::vector<unsigned> nearest;
+    algorithm.nearest_sources(source_sets,k,nearest,distances,max_distance);
+    switch(nlhs)
+    {
+      case 2:
+      {
+        plhs[1] = mxCreateDoubleMatrix(n,k,mxREAL);
+        double * d = mxGetPr(plhs[1]);
+        for(size_t i = 0;i<distances.size();i++) d[i] = to_matlab(distances[i]);
+      }
+      case 1:
+      case 0:
+      {
+        // sets that are not reached get 0
+        plhs[0] = mxCreateDoubleMatrix(n,k,mxREAL);
+        double * s = mxGetPr(plhs[0]);
+        for(size_t i = 0;i<nearest.size();i++)
+        {
+          s[i] = nearest[i]==geodesic::GeodesicAlgorithmExactBatch::NO_SOURCE ? 0 : nearest[i]+1;
+        }
+      }
+      default:break;
+    }
+  }
+
+  if(algorithm.limited_sets()>0)
+  {
+    cout<<algorithm.limited_sets()<<" source sets stopped at the memory limit"<<endl;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
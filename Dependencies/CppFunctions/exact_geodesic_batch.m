@@ -0,0 +1,35 @@
+% EXACT_GEODESIC_BATCH Exact geodesic distances over a mesh from many
+% independent sets of source vertices, propagated in parallel
+%
+% D = exact_geodesic_batch(V,F,sources)
+% [N,D] = exact_geodesic_batch(V,F,sources,'K',k,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   V  #V by 3 list of vertex positions
+%   F  #F by 3 list of triangle indices into V
+%   sources  #S list of source vertices, one set per vertex (e.g. tips), or
+%     #S cell of lists of source vertices
+%   Optional:
+%     'K' followed by the number of nearest source sets to return per vertex
+%       instead of all distances {0}
+%     'MaxDistance' followed by the distance at which every propagation stops
+%       {Inf}
+%     'MemoryLimit' followed by the bytes of intervals each thread may hold;
+%       a set that needs more stops early, leaving the vertices it has not
+%       settled at Inf {0: no limit}
+% Outputs:
+%   D  #V by #S matrix of distances to each source set (Inf if not reached),
+%     or with 'K', #V by k distances to the nearest sets
+%   N  #V by k list of nearest source sets, closest first, equally close ones
+%     by index (0 past the reached ones)
+%
+% Each set is propagated with the exact algorithm of exactgeodesic
+% (Mitchell, Mount and Papadimitriou, as geodesic_new_algorithm(mesh,'exact')
+% with geodesic_propagate and geodesic_distance_and_source), one algorithm
+% per thread on a shared mesh. With 'K' only the k nearest sets per vertex are
+% kept, so the #V by #S matrix is never held.
+%
+% Compile with the exactgeodesic sources on the include path, with OpenMP to
+% propagate in parallel:
+%   mex -I../gptoolbox/external/exactgeodesic/src exact_geodesic_batch.cpp ...
+%
@@ -0,0 +1,141 @@
+// Compile with -I../gptoolbox/external/exactgeodesic/src
+#include "geodesic_balls.h"
+#include <Eigen/Core>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=3,"nrhs should be >= 3");
+  MatrixXd V;
+  MatrixXi F;
+  parse_rhs_double(prhs,V);
+  parse_rhs_index(prhs+1,F);
+  mexErrMsgTxt(V.cols()==3,"V must be #V by 3");
+  mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+  mexErrMsgTxt(F.size()==0 || (F.minCoeff()>=0 && F.maxCoeff()<V.rows()),"F must index V");
+  mexErrMsgTxt(
+    mxIsDouble(prhs[2]) && mxGetM(prhs[2])==1 && mxGetN(prhs[2])==1,
+    "r should be scalar");
+  const double r = *mxGetPr(prhs[2]);
+  mexErrMsgTxt(r>=0,"r should be >= 0");
+  MeshGraph G;
+  mesh_graph_from_faces(F,V.rows(),G);
+
+  std::vector<int> sources;
+  GeodesicBallMethod method = GEODESIC_BALL_METHOD_DIJKSTRA;
+  {
+    int i = 3;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Query",name) == 0)
+      {
+        validate_arg_double(i,nrhs,prhs,name);
+        VectorXi Q;
+        parse_rhs_index(prhs+(++i),Q);
+        for(int q = 0;q<Q.size();q++)
+        {
+          mexErrMsgTxt(Q(q)>=0 && Q(q)<G.num_vertices(),"Query out of range");
+        }
+        sources.assign(Q.data(),Q.data()+Q.size());
+      }else if(strcmp("Method",name) == 0)
+      {
+        validate_arg_char(i,nrhs,prhs,name);
+        const char * type_name = mxArrayToString(prhs[++i]);
+        if(strcmp("dijkstra",type_name)==0)
+        {
+          method = GEODESIC_BALL_METHOD_DIJKSTRA;
+        }else if(strcmp("exact",type_name)==0)
+        {
+          method = GEODESIC_BALL_METHOD_EXACT;
+        }else
+        {
+          mexErrMsgTxt(false,C_STR("Unknown method: "<<type_name));
+        }
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+  if(sources.empty())
+  {
+    sources.resize(G.num_vertices());
+    for(int v = 0;v<G.num_vertices();v++) sources[v] = v;
+  }
+
+  geodesic::Mesh mesh;
+  if(method==GEODESIC_BALL_METHOD_EXACT)
+  {
+    std::vector<double> points(V.size());
+    for(int v = 0;v<V.rows();v++)
+    {
+      for(int c = 0;c<3;c++) points[3*v+c] = V(v,c);
+    }
+    std::vector<unsigned> faces(F.size());
+    for(int f = 0;f<F.rows();f++)
+    {
+      for(int c = 0;c<3;c++) faces[3*f+c] = F(f,c);
+    }
+    mesh.initialize_mesh_data(points,faces);
+  }
+
+  GeodesicBalls N;
+  geodesic_balls(G,V,&mesh,r,method,sources,N);
+
+  switch(nlhs)
+  {
+    case 3:
+    {
+      plhs[2] = mxCreateDoubleMatrix(N.distances.size(),1,mxREAL);
+      std::copy(N.distances.begin(),N.distances.end(),mxGetPr(plhs[2]));
+      std::vector<double>().swap(N.distances);
+    }
+    case 2:
+    {
+      plhs[1] = mxCreateNumericMatrix(N.ids.size(),1,mxUINT32_CLASS,mxREAL);
+      uint32_t * ids = (uint32_t*)mxGetData(plhs[1]);
+      for(size_t k = 0;k<N.ids.size();k++) ids[k] = N.ids[k]+1;
+      std::vector<uint32_t>().swap(N.ids);
+    }
+    case 1:
+    {
+      plhs[0] = mxCreateDoubleMatrix(N.offsets.size(),1,mxREAL);
+      std::copy(N.offsets.begin(),N.offsets.end(),mxGetPr(plhs[0]));
+    }
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
@@ -0,0 +1,234 @@
+#ifndef GEODESIC_BALLS_H
+#define GEODESIC_BALLS_H
+// Geodesic balls (the vertices within a radius of each source vertex) in
+// compressed sparse row form, by Dijkstra over the mesh edges or by the exact
+// algorithm of exactgeodesic, every search stopping at the radius so that its
+// cost scales with the ball and not with the mesh. Nothing here depends on
+// MATLAB; compile with -I../gptoolbox/external/exactgeodesic/src.
+#include "mesh_graph.h"
+#include <memory> // geodesic_memory.h uses std::auto_ptr
+#include <cstring> // memcpy, used by geodesic_algorithm_exact.h
+#include <geodesic_algorithm_exact.h>
+#include <Eigen/Core>
+#include <igl/parallel_for.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// ids[offsets[i]] ... ids[offsets[i+1]-1] are the vertices within the radius
+// of sources[i] by increasing distance (the source itself first) and
+// distances[] their geodesic distances.
+struct GeodesicBalls
+{
+  std::vector<int64_t> offsets;
+  std::vector<uint32_t> ids;
+  std::vector<double> distances;
+};
+
+enum GeodesicBallMethod
+{
+  // shortest paths along the edges, an upper bound of the geodesic distance
+  GEODESIC_BALL_METHOD_DIJKSTRA = 0,
+  // exact polyhedral geodesic distances
+  GEODESIC_BALL_METHOD_EXACT = 1
+};
+
+// (distance, vertex) pairs of one ball, by increasing distance
+typedef std::vector<std::pair<double,int> > GeodesicBall;
+
+// Dijkstra bounded by a distance. As HopBFS, the visited set is a stamp per
+// vertex, so one instance (per thread) serves any number of sources.
+class DijkstraBall
+{
+  public:
+    DijkstraBall(const MeshGraph & G, const Eigen::MatrixXd & V) :
+      G(&G), V(&V), stamp(G.num_vertices(),0), distance(G.num_vertices()), current(0) {}
+
+    void run(const int source, const double radius, GeodesicBall & ball)
+    {
+      if(++current==0)
+      {
+        // stamp wrapped around
+        std::fill(stamp.begin(),stamp.end(),0);
+        current = 1;
+      }
+      ball.clear();
+      typedef std::pair<double,int> Entry;
+      std::greater<Entry> order;
+      queue.assign(1,Entry(0,source));
+      stamp[source] = current;
+      distance[source] = 0;
+      while(!queue.empty())
+      {
+        std::pop_heap(queue.begin(),queue.end(),order);
+        const Entry top = queue.back();
+        queue.pop_back();
+        const int u = top.second;
+        // stale entry
+        if(top.first>distance[u]) continue;
+        ball.push_back(top);
+        // settled: never relaxed again
+        distance[u] = -1;
+        for(int64_t k = G->offsets[u];k<G->offsets[u+1];k++)
+        {
+          const int v = G->neighbours[k];
+          const double d = top.first+(V->row(u)-V->row(v)).norm();
+          if(d>radius) continue;
+          if(stamp[v]==current && !(d<distance[v])) continue;
+          stamp[v] = current;
+          distance[v] = d;
+          queue.push_back(Entry(d,v));
+          std::push_heap(queue.begin(),queue.end(),order);
+        }
+      }
+    }
+
+  private:
+    const MeshGraph * G;
+    const Eigen::MatrixXd * V;
+    std::vector<uint32_t> stamp;
+    // tentative distance of the stamped vertices, -1 once settled
+    std::vector<double> distance;
+    uint32_t current;
+    std::vector<std::pair<double,int> > queue;
+};
+
+// Exact geodesic ball. The exact algorithm propagates up to radius plus the
+// longest edge: a vertex within radius is reached by a geodesic crossing
+// faces whose vertices are all within that bound, so a breadth first search
+// through the vertices within it, starting at the source, finds every vertex
+// within radius without looking at the rest of the mesh.
+class ExactBall
+{
+  public:
+    ExactBall(const MeshGraph & G, geodesic::Mesh & mesh, const double max_edge) :
+      G(&G), mesh(&mesh), algorithm(&mesh), max_edge(max_edge),
+      stamp(G.num_vertices(),0), current(0) {}
+
+    void run(const int source, const double radius, GeodesicBall & ball)
+    {
+      if(++current==0)
+      {
+        // stamp wrapped around
+        std::fill(stamp.begin(),stamp.end(),0);
+        current = 1;
+      }
+      ball.clear();
+      const double reach = radius+max_edge;
+      std::vector<geodesic::SurfacePoint> sources(1,geodesic::SurfacePoint(&mesh->vertices()[source]));
+      algorithm.propagate(sources,reach);
+      frontier.assign(1,source);
+      stamp[source] = current;
+      while(!frontier.empty())
+      {
+        const int u = frontier.back();
+        frontier.pop_back();
+        geodesic::SurfacePoint point(&mesh->vertices()[u]);
+        double d;
+        algorithm.best_source(point,d);
+        if(u==source) d = 0;
+        if(!(d<=reach)) continue;
+        if(d<=radius) ball.push_back(std::make_pair(d,u));
+        for(int64_t k = G->offsets[u];k<G->offsets[u+1];k++)
+        {
+          const int v = G->neighbours[k];
+          if(stamp[v]==current) continue;
+          stamp[v] = current;
+          frontier.push_back(v);
+        }
+      }
+      std::sort(ball.begin(),ball.end());
+    }
+
+  private:
+    const MeshGraph * G;
+    geodesic::Mesh * mesh;
+    geodesic::GeodesicAlgorithmExact algorithm;
+    double max_edge;
+    std::vector<uint32_t> stamp;
+    uint32_t current;
+    std::vector<int> frontier;
+};
+
+// Inputs:
+//   G  mesh graph of (V,F)
+//   V  #V by 3 list of vertex positions
+//   mesh  exactgeodesic mesh of (V,F), only used by GEODESIC_BALL_METHOD_EXACT
+//   radius  radius of the balls
+//   method  GEODESIC_BALL_METHOD_DIJKSTRA or GEODESIC_BALL_METHOD_EXACT
+//   sources  list of source vertices
+// Outputs:
+//   N  balls of sources
+//
+// Every thread owns one search (and for the exact method one
+// GeodesicAlgorithmExact), reused for all of its sources.
+inline void geodesic_balls(
+  const MeshGraph & G,
+  const Eigen::MatrixXd & V,
+  geodesic::Mesh * mesh,
+  const double radius,
+  const GeodesicBallMethod method,
+  const std::vector<int> & sources,
+  GeodesicBalls & N)
+{
+  const int ns = (int)sources.size();
+  double max_edge = 0;
+  for(int u = 0;u<G.num_vertices();u++)
+  {
+    for(int64_t k = G.offsets[u];k<G.offsets[u+1];k++)
+    {
+      max_edge = std::max(max_edge,(V.row(u)-V.row(G.neighbours[k])).norm());
+    }
+  }
+
+  std::vector<GeodesicBall> balls(ns);
+  std::vector<std::unique_ptr<DijkstraBall> > dijkstra;
+  std::vector<std::unique_ptr<ExactBall> > exact;
+  igl::parallel_for(
+    ns,
+    [&](const size_t nt)
+    {
+      for(size_t t = 0;t<nt;t++)
+      {
+        if(method==GEODESIC_BALL_METHOD_EXACT)
+        {
+          exact.emplace_back(new ExactBall(G,*mesh,max_edge));
+        }else
+        {
+          dijkstra.emplace_back(new DijkstraBall(G,V));
+        }
+      }
+    },
+    [&](const int i, const size_t t)
+    {
+      if(method==GEODESIC_BALL_METHOD_EXACT)
+      {
+        exact[t]->run(sources[i],radius,balls[i]);
+      }else
+      {
+        dijkstra[t]->run(sources[i],radius,balls[i]);
+      }
+    },
+    [](const size_t){},
+    method==GEODESIC_BALL_METHOD_EXACT ? 10 : 1000);
+
+  N.offsets.assign(ns+1,0);
+  for(int i = 0;i<ns;i++) N.offsets[i+1] = N.offsets[i]+balls[i].size();
+  N.ids.resize(N.offsets[ns]);
+  N.distances.resize(N.offsets[ns]);
+  for(int i = 0;i<ns;i++)
+  {
+    int64_t k = N.offsets[i];
+    for(const auto & entry : balls[i])
+    {
+      N.ids[k] = entry.second;
+      N.distances[k] = entry.first;
+      k++;
+    }
+    GeodesicBall().swap(balls[i]);
+  }
+}
+
+#endif
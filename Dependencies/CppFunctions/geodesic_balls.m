@@ -0,0 +1,32 @@
+% GEODESIC_BALLS Vertices within a geodesic distance of each (query) vertex of
+% a mesh, with their distances, by a radius bounded search from every source
+% run in parallel
+%
+% offsets = geodesic_balls(V,F,r)
+% [offsets,ids,distances] = geodesic_balls(V,F,r,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   V  #V by 3 list of vertex positions
+%   F  #F by 3 list of triangle indices into V
+%   r  radius of the balls
+%   Optional:
+%     'Query' followed by #Q list of source vertices {1:#V}
+%     'Method' followed by one of:
+%       {'dijkstra'}  shortest paths along the mesh edges (an upper bound of
+%         the geodesic distance)
+%       'exact'  exact polyhedral geodesic distances (exactgeodesic), the
+%         propagation of every source stopping just past r
+% Outputs:
+%   offsets  #Q+1 list of offsets: ids(offsets(q)+1:offsets(q+1)) are the
+%     vertices within r of query q, by increasing distance, the query first
+%   ids  offsets(end) uint32 list of 1-based vertex ids
+%   distances  offsets(end) list of distances to the query
+%
+% A geodesic Gaussian smoothing matrix (see meshGaussian), with Q = 1:#V, is
+%   S = meshGaussian(repelem(Q(:),diff(offsets)), double(ids), distances, sigma);
+% with r about 3*sigma.
+%
+% Compile with the exactgeodesic sources on the include path, with OpenMP to
+% search in parallel:
+%   mex -I../gptoolbox/external/exactgeodesic/src geodesic_balls.cpp ...
+%
@@ -0,0 +1,312 @@
+#include "mesh_graph.h"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/parallel_for.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+// Per thread scratch space. Set membership is a tick per vertex: a vertex is
+// in a set iff its entry equals the tick the set was created with, so no
+// array is ever cleared between steps or tips.
+struct TipScratch
+{
+  std::vector<uint32_t> region, path, candidate, front, searched;
+  std::vector<int> parent;
+  uint32_t tick;
+
+  explicit TipScratch(const int n) :
+    region(n,0), path(n,0), candidate(n,0), front(n,0), searched(n,0), parent(n,-1), tick(0) {}
+
+  uint32_t next_tick()
+  {
+    if(++tick==0)
+    {
+      for(auto * a : {&region,&path,&candidate,&front,&searched}) std::fill(a->begin(),a->end(),0);
+      tick = 1;
+    }
+    return tick;
+  }
+};
+
+// Visits and per step statistics of the region grown from one tip
+struct TipRegion
+{
+  std::vector<std::pair<int,int> > visits; // (vertex, step)
+  std::vector<double> min_m, mean_m, min_t, mean_t;
+};
+
+// Breadth first (unit weight) shortest path from source to target; empty if
+// target is unreachable
+inline void bfs_path(
+  const MeshGraph & G, const int source, const int target, TipScratch & T, std::vector<int> & path)
+{
+  path.clear();
+  const uint32_t seen = T.next_tick();
+  std::vector<int> queue(1,source);
+  T.searched[source] = seen;
+  T.parent[source] = -1;
+  for(size_t q = 0;q<queue.size() && T.searched[target]!=seen;q++)
+  {
+    const int u = queue[q];
+    for(int64_t k = G.offsets[u];k<G.offsets[u+1];k++)
+    {
+      const int v = G.neighbours[k];
+      if(T.searched[v]==seen) continue;
+      T.searched[v] = seen;
+      T.parent[v] = u;
+      queue.push_back(v);
+    }
+  }
+  if(T.searched[target]!=seen) return;
+  for(int v = target;v>=0;v = T.parent[v]) path.push_back(v);
+  std::reverse(path.begin(),path.end());
+}
+
+// Grows the region of one tip as runPartsDecomp does: the initial front is
+// the 2-hop ball of the tip; each step the front becomes the connected part
+// of (1-hop neighbours of the front minus the region) that contains the
+// lowest numbered vertex on the tip's path to the core. Growth stops when no
+// such vertex exists.
+inline void grow_tip_region(
+  const MeshGraph & G,
+  const int tip,
+  const std::vector<int> & path,
+  const Eigen::VectorXd & M,
+  const Eigen::VectorXd & Th,
+  TipScratch & T,
+  TipRegion & R)
+{
+  const uint32_t region = T.next_tick();
+  const uint32_t on_path = T.next_tick();
+  for(const int v : path) T.path[v] = on_path;
+
+  std::vector<int> front, next;
+  double min_m = std::numeric_limits<double>::infinity();
+  double min_t = std::numeric_limits<double>::infinity();
+  // records the current front as step number `step'
+  const auto record = [&](const int step)
+  {
+    double sum_m = 0, sum_t = 0;
+    for(const int v : front)
+    {
+      min_m = std::min(min_m,M(v));
+      min_t = std::min(min_t,Th(v));
+      sum_m += M(v);
+      sum_t += Th(v);
+      R.visits.emplace_back(v,step);
+    }
+    R.min_m.push_back(min_m);
+    R.mean_m.push_back(sum_m/front.size());
+    R.min_t.push_back(min_t);
+    R.mean_t.push_back(sum_t/front.size());
+  };
+
+  // Step 1: 2-hop ball
+  T.region[tip] = region;
+  front.push_back(tip);
+  for(int hop = 0;hop<2;hop++)
+  {
+    const size_t end = front.size();
+    for(size_t f = 0;f<end;f++)
+    {
+      const int u = front[f];
+      for(int64_t k = G.offsets[u];k<G.offsets[u+1];k++)
+      {
+        const int v = G.neighbours[k];
+        if(T.region[v]==region) continue;
+        T.region[v] = region;
+        front.push_back(v);
+      }
+    }
+  }
+  record(1);
+
+  for(int step = 2;;step++)
+  {
+    // Candidates: neighbours of the front that are not in the region yet
+    const uint32_t candidate = T.next_tick();
+    int first = -1;
+    for(const int u : front)
+    {
+      for(int64_t k = G.offsets[u];k<G.offsets[u+1];k++)
+      {
+        const int v = G.neighbours[k];
+        if(T.region[v]==region || T.candidate[v]==candidate) continue;
+        T.candidate[v] = candidate;
+        if(T.path[v]==on_path && (first<0 || v<first)) first = v;
+      }
+    }
+    if(first<0) break;
+
+    // New front: the component of the candidates containing first
+    const uint32_t in_front = T.next_tick();
+    next.assign(1,first);
+    T.front[first] = in_front;
+    for(size_t q = 0;q<next.size();q++)
+    {
+      const int u = next[q];
+      for(int64_t k = G.offsets[u];k<G.offsets[u+1];k++)
+      {
+        const int v = G.neighbours[k];
+        if(T.candidate[v]!=candidate || T.front[v]==in_front) continue;
+        T.front[v] = in_front;
+        next.push_back(v);
+      }
+    }
+    for(const int v : next) T.region[v] = region;
+    front.swap(next);
+    record(step);
+  }
+}
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=5,"nrhs should be >= 5");
+  MeshGraph G;
+  if(mxIsSparse(prhs[0]))
+  {
+    mexErrMsgTxt(mxGetM(prhs[0])==mxGetN(prhs[0]),"A must be square");
+    mesh_graph_from_csc(mxGetJc(prhs[0]),mxGetIr(prhs[0]),(int)mxGetN(prhs[0]),G);
+  }else
+  {
+    MatrixXi F;
+    parse_rhs_index(prhs,F);
+    mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+    mesh_graph_from_faces(F,F.size()==0 ? 0 : F.maxCoeff()+1,G);
+  }
+  const int n = G.num_vertices();
+  VectorXi tips,targets;
+  VectorXd M,Th;
+  parse_rhs_index(prhs+1,tips);
+  parse_rhs_index(prhs+2,targets);
+  parse_rhs_double(prhs+3,M);
+  parse_rhs_double(prhs+4,Th);
+  mexErrMsgTxt(targets.size()==tips.size(),"targets must have one entry per tip");
+  mexErrMsgTxt(M.size()>=n && Th.size()>=n,"M and T must have one entry per vertex");
+  for(int i = 0;i<tips.size();i++)
+  {
+    // a target of 0 (-1 here) marks a tip that reaches no core
+    mexErrMsgTxt(tips(i)>=0 && tips(i)<n && targets(i)>=-1 && targets(i)<n,
+      "tips and targets must be vertex indices");
+  }
+
+  const int nt = tips.size();
+  std::vector<std::vector<int> > paths;
+  {
+    int i = 5;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Paths",name) == 0)
+      {
+        mexErrMsgTxt(i+1<nrhs,C_STR("Parameter '"<<name<<"' requires argument"));
+        const mxArray * cell = prhs[++i];
+        mexErrMsgTxt(mxIsCell(cell) && (int)mxGetNumberOfElements(cell)==nt,
+          "Paths must be a cell with one path per tip");
+        paths.resize(nt);
+        for(int t = 0;t<nt;t++)
+        {
+          const mxArray * p = mxGetCell(cell,t);
+          mexErrMsgTxt(p!=nullptr && mxIsDouble(p),"Paths must contain double vertex lists");
+          const double * pv = mxGetPr(p);
+          for(size_t k = 0;k<mxGetNumberOfElements(p);k++)
+          {
+            const int v = (int)pv[k]-1;
+            mexErrMsgTxt(v>=0 && v<n,"Paths must contain vertex indices");
+            paths[t].push_back(v);
+          }
+        }
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+  const bool given_paths = !paths.empty();
+  if(!given_paths) paths.resize(nt);
+
+  // Tips are independent; each thread reuses its scratch space across tips
+  std::vector<TipRegion> regions(nt);
+  std::vector<TipScratch> scratch;
+  parallel_for(
+    nt,
+    [&](const size_t threads){ scratch.assign(threads,TipScratch(n)); },
+    [&](const int t, const size_t thread)
+    {
+      if(!given_paths && targets(t)>=0) bfs_path(G,tips(t),targets(t),scratch[thread],paths[t]);
+      grow_tip_region(G,tips(t),paths[t],M,Th,scratch[thread],regions[t]);
+      std::vector<int>().swap(paths[t]);
+    },
+    [](const size_t){},
+    1);
+
+  // Visit records and step statistics (one zero row past the last step of
+  // each tip, as the preallocated arrays of runPartsDecomp have)
+  size_t num_visits = 0;
+  size_t num_steps = 0;
+  for(const auto & R : regions)
+  {
+    num_visits += R.visits.size();
+    num_steps = std::max(num_steps,R.min_m.size()+1);
+  }
+  for(int o = 1;o<std::min(nlhs,5);o++)
+  {
+    plhs[o] = mxCreateDoubleMatrix(num_steps,nt,mxREAL);
+    double * S = mxGetPr(plhs[o]);
+    for(int t = 0;t<nt;t++)
+    {
+      const std::vector<double> & s =
+        o==1 ? regions[t].min_m : o==2 ? regions[t].mean_m : o==3 ? regions[t].min_t : regions[t].mean_t;
+      std::copy(s.begin(),s.end(),S+(size_t)t*num_steps);
+    }
+  }
+  if(nlhs>=1)
+  {
+    plhs[0] = mxCreateNumericMatrix(num_visits,3,mxUINT32_CLASS,mxREAL);
+    uint32_t * V = (uint32_t*)mxGetData(plhs[0]);
+    size_t r = 0;
+    for(int t = 0;t<nt;t++)
+    {
+      for(const auto & v : regions[t].visits)
+      {
+        V[r] = t+1;
+        V[num_visits+r] = v.first+1;
+        V[2*num_visits+r] = v.second;
+        r++;
+      }
+    }
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
@@ -0,0 +1,33 @@
+% GROW_TIP_REGIONS Grow the tip to core flow regions of runPartsDecomp for
+% all tips at once, in parallel over tips
+%
+% visits = grow_tip_regions(F,tips,targets,M,T)
+% [visits,minMStep,meanMStep,minTStep,meanTStep] = grow_tip_regions(A,tips,targets,M,T,'ParameterName',ParameterValue, ...)
+%
+% Each region starts as the 2-hop ball of its tip. Each step the front
+% becomes the connected part of the new 1-hop neighbours of the front that
+% contains the lowest numbered vertex on the tip's shortest path to its
+% target; growth stops when the front no longer touches the path.
+%
+% Inputs:
+%   F  #F by 3 list of triangle indices, or
+%   A  #V by #V symmetric sparse adjacency matrix
+%   tips  #tips list of tip vertices
+%   targets  #tips list of core vertices closest to each tip, 0 for a tip that
+%     reaches no core (as nearest_core_paths returns); its region stops after
+%     the 2-hop ball, as runPartsDecomp's loop does with an empty path
+%   M  #V list of m-score values
+%   T  #V list of thinness values
+%   Optional:
+%     'Paths' followed by #tips cell of tip to target vertex paths (e.g. from
+%       shortestpath) {unit weight breadth first paths computed internally}
+% Outputs:
+%   visits  #R by 3 uint32 list of [tip, vertex, step]: vertex was added to
+%     the region of tips(tip) at step (N(tip,vertex) in runPartsDecomp)
+%   minMStep  #steps by #tips min M over the region after each step
+%   meanMStep  #steps by #tips mean M over the front of each step
+%   minTStep  #steps by #tips min T over the region after each step
+%   meanTStep  #steps by #tips mean T over the front of each step
+%   Step statistics are 0 after the last step of each tip; the per vertex
+%   cMin/cMean/cTMin/cTMean values are these statistics at each visit's step.
+%
@@ -0,0 +1,219 @@
+#include "vertex_frontier.h"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+// Mean of T over the vertices labelled val (NaN if there are none, as mean
+// of an empty list is in MATLAB)
+inline double mean_of_label(const double * L, const double * T, const int n, const double val)
+{
+  double sum = 0;
+  int count = 0;
+  for(int v = 0;v<n;v++)
+  {
+    if(L[v]!=val) continue;
+    sum += T[v];
+    count++;
+  }
+  return sum/count;
+}
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=5,"nrhs should be >= 5");
+  mexErrMsgTxt(mxIsDouble(prhs[1]) && !mxIsSparse(prhs[1]),"L should be a full double vector");
+  const int n = mxGetNumberOfElements(prhs[1]);
+  MeshGraph G;
+  if(mxIsSparse(prhs[0]))
+  {
+    mexErrMsgTxt(mxGetM(prhs[0])==(size_t)n && mxGetN(prhs[0])==(size_t)n,"A must be #L by #L");
+    mesh_graph_from_csc(mxGetJc(prhs[0]),mxGetIr(prhs[0]),n,G);
+  }else
+  {
+    MatrixXi F;
+    parse_rhs_index(prhs,F);
+    mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+    mexErrMsgTxt(F.size()==0 || (F.minCoeff()>=0 && F.maxCoeff()<n),"F must index L");
+    mesh_graph_from_faces(F,n,G);
+  }
+  mexErrMsgTxt(mxIsDouble(prhs[2]) && (int)mxGetNumberOfElements(prhs[2])==n,"R should have one entry per vertex");
+  mexErrMsgTxt(mxIsDouble(prhs[3]),"ids should be double");
+  mexErrMsgTxt(mxIsDouble(prhs[4]) && (int)mxGetNumberOfElements(prhs[4])>=n,"T should have one entry per vertex");
+  const double * R = mxGetPr(prhs[2]);
+  const double * T = mxGetPr(prhs[4]);
+  const int nids = mxGetNumberOfElements(prhs[3]);
+  std::vector<int> ids(nids);
+  for(int i = 0;i<nids;i++)
+  {
+    ids[i] = (int)mxGetPr(prhs[3])[i];
+    mexErrMsgTxt(ids[i]>=1,"ids should be positive region ids");
+  }
+
+  int small_size = 50;
+  double expansion = 0.5, constriction = 1;
+  {
+    int i = 5;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("SmallSize",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        small_size = (int)*mxGetPr(prhs[++i]);
+      }else if(strcmp("Expansion",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        expansion = *mxGetPr(prhs[++i]);
+      }else if(strcmp("Constriction",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        constriction = *mxGetPr(prhs[++i]);
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+
+  plhs[0] = mxCreateDoubleMatrix(mxGetM(prhs[1]),mxGetN(prhs[1]),mxREAL);
+  double * L = mxGetPr(plhs[0]);
+  std::copy(mxGetPr(prhs[1]),mxGetPr(prhs[1])+n,L);
+
+  // Vertices of each listed region, in increasing order (counting sort)
+  int max_id = 0;
+  for(const int id : ids) max_id = std::max(max_id,id);
+  std::vector<int> slot(max_id+1,-1);
+  for(int i = 0;i<nids;i++) slot[ids[i]] = i;
+  std::vector<int64_t> offsets(nids+1,0);
+  for(int v = 0;v<n;v++)
+  {
+    const int r = (int)R[v];
+    if(r>=1 && r<=max_id && slot[r]>=0) offsets[slot[r]+1]++;
+  }
+  for(int i = 0;i<nids;i++) offsets[i+1] += offsets[i];
+  std::vector<int> members(offsets[nids]);
+  {
+    std::vector<int64_t> fill(offsets.begin(),offsets.end()-1);
+    for(int v = 0;v<n;v++)
+    {
+      const int r = (int)R[v];
+      if(r>=1 && r<=max_id && slot[r]>=0) members[fill[slot[r]]++] = v;
+    }
+  }
+
+  const double expansion_thickness = mean_of_label(L,T,n,expansion);
+  const double constriction_thickness = mean_of_label(L,T,n,constriction);
+
+  // Regions are relabelled in the given order, each seeing the labels given
+  // to the regions before it, exactly as the loop of runPartsCleanUp does
+  int gulped = 0, new_expansions = 0, new_constrictions = 0;
+  VertexFrontier frontier(G);
+  std::vector<int> region, neighbours;
+  std::vector<std::pair<double,int> > counts;
+  for(int i = 0;i<nids;i++)
+  {
+    region.assign(members.begin()+offsets[i],members.begin()+offsets[i+1]);
+    frontier.start(region);
+    frontier.expand(region,[](const int){ return true; },neighbours);
+
+    // Number of labelled (> 0) neighbours per label, by increasing label
+    counts.clear();
+    for(const int v : neighbours) if(L[v]>0) counts.emplace_back(L[v],1);
+    std::sort(counts.begin(),counts.end());
+    int num_labelled = counts.size();
+    {
+      size_t u = 0;
+      for(size_t k = 0;k<counts.size();k++)
+      {
+        if(u>0 && counts[u-1].first==counts[k].first) counts[u-1].second++;
+        else counts[u++] = counts[k];
+      }
+      counts.resize(u);
+    }
+
+    if((int)region.size()<small_size && num_labelled>0)
+    {
+      // A single neighbouring label, or a lowest label that strictly
+      // outnumbers every other one (the only case in which the running
+      // most-frequent list of runPartsCleanUp ends with one entry)
+      bool gulp = true;
+      for(size_t k = 1;k<counts.size();k++) gulp = gulp && counts[k].second<counts[0].second;
+      if(gulp)
+      {
+        for(const int v : region) L[v] = counts[0].first;
+        gulped++;
+        continue;
+      }
+    }
+
+    // Else let average thickness decide
+    double thickness = 0;
+    for(const int v : region) thickness += T[v];
+    thickness /= region.size();
+    const double to_expansion = std::abs(thickness-expansion_thickness);
+    const double to_constriction = std::abs(thickness-constriction_thickness);
+    if(to_expansion<to_constriction)
+    {
+      for(const int v : region) L[v] = expansion;
+      new_expansions++;
+    }else if(to_expansion>to_constriction)
+    {
+      for(const int v : region) L[v] = constriction;
+      new_constrictions++;
+    }else
+    {
+      cout<<"can't decide label keep unlabelled"<<endl;
+    }
+  }
+
+  switch(nlhs)
+  {
+    case 2:
+    {
+      plhs[1] = mxCreateDoubleMatrix(1,3,mxREAL);
+      double * c = mxGetPr(plhs[1]);
+      c[0] = gulped;
+      c[1] = new_expansions;
+      c[2] = new_constrictions;
+    }
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
@@ -0,0 +1,27 @@
+% GULP_REGIONS Relabel unlabelled regions of a parts decomposition from their
+% neighbours or, failing that, from their average thickness
+%
+% L = gulp_regions(F,L,R,ids,T)
+% [L,counts] = gulp_regions(A,L,R,ids,T,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   F  #F by 3 list of triangle indices, or
+%   A  #V by #V symmetric sparse adjacency matrix
+%   L  #V list of vertex labels
+%   R  #V list of region ids (e.g. from label_components, 0 for none)
+%   ids  list of regions to relabel, processed in this order
+%   T  #V list of thinness values
+%   Optional:
+%     'SmallSize' followed by the number of vertices below which a region may
+%       take the label of its neighbours {50}
+%     'Expansion' followed by the expansion label {0.5}
+%     'Constriction' followed by the constriction label {1}
+% Outputs:
+%   L  #V list of labels after relabelling
+%   counts  [gulped, new expansions, new constrictions]
+%
+% Each region is handled as the final clean up step of runPartsCleanUp does,
+% seeing the labels given to the regions before it. Its neighbours are found
+% by expanding the region by one hop, in time proportional to the region and
+% its edges.
+%
@@ -0,0 +1,264 @@
+#ifndef HEAT_GEODESIC_H
+#define HEAT_GEODESIC_H
+// Geodesic distances by the heat method ("Geodesics in Heat" [Crane et al.
+// 2013], as gptoolbox's heat_geodesic.m) from many independent source sets
+// on one triangle mesh. The heat step, boundary and Poisson matrices are
+// factorised once per mesh; every source set then costs a few
+// back-substitutions, several sets at a time. Nothing here depends on MATLAB.
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <igl/parallel_for.h>
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+enum HeatGeodesicBoundary
+{
+  // uniform average of the Neumann and Dirichlet heat (heat_geodesic.m's
+  // default)
+  HEAT_GEODESIC_BOUNDARY_AVERAGE = 0,
+  HEAT_GEODESIC_BOUNDARY_NEUMANN = 1,
+  // heat fixed to 0 on the boundary (1 at boundary sources)
+  HEAT_GEODESIC_BOUNDARY_DIRICHLET = 2
+};
+
+struct HeatGeodesicData
+{
+  int num_vertices = 0;
+  double t = 0;
+  HeatGeodesicBoundary boundary = HEAT_GEODESIC_BOUNDARY_AVERAGE;
+  Eigen::MatrixXi F;
+  // #F*3 by 3 gradients of the hat functions of the corners of every face
+  Eigen::MatrixXd hat_gradients;
+  // #F areas
+  Eigen::VectorXd areas;
+  // M + t K, with K the (positive semidefinite) cotangent stiffness matrix
+  // and M the barycentric mass matrix
+  Eigen::SparseMatrix<double> Q;
+  Eigen::SimplicialLLT<Eigen::SparseMatrix<double> > neumann;
+  // Q restricted to the interior vertices, and its interior by boundary
+  // block
+  Eigen::SimplicialLLT<Eigen::SparseMatrix<double> > dirichlet;
+  Eigen::SparseMatrix<double> Q_interior_boundary;
+  // index of every vertex among the interior or the boundary vertices
+  std::vector<int> interior_index, boundary_index;
+  std::vector<int> interior, boundary_vertices;
+  // K plus a small regularisation, as heat_geodesic.m
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > poisson;
+};
+
+// Inputs:
+//   V  #V by 3 list of vertex positions
+//   F  #F by 3 list of triangle indices into V
+//   t  time of the heat step, <= 0 for 5 times the mean triangle area (as
+//     heat_geodesic.m)
+//   boundary  boundary conditions of the heat step
+// Outputs:
+//   data  factorised matrices
+// Returns false if a factorisation failed (e.g. degenerate triangles).
+inline bool heat_geodesic_precompute(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  double t,
+  const HeatGeodesicBoundary boundary,
+  HeatGeodesicData & data)
+{
+  typedef Eigen::Triplet<double> Triplet;
+  const int n = V.rows();
+  const int m = F.rows();
+  data.num_vertices = n;
+  data.F = F;
+  data.boundary = boundary;
+  data.hat_gradients.resize(3*m,3);
+  data.areas.resize(m);
+  std::vector<Triplet> K_ijv, M_ijv;
+  K_ijv.reserve(9*m);
+  M_ijv.reserve(3*m);
+  // Boundary edges are the edges of a single face
+  std::map<std::pair<int,int>,int> edge_count;
+  for(int f = 0;f<m;f++)
+  {
+    const Eigen::RowVector3d e[3] = {
+      V.row(F(f,2))-V.row(F(f,1)),
+      V.row(F(f,0))-V.row(F(f,2)),
+      V.row(F(f,1))-V.row(F(f,0))};
+    const Eigen::RowVector3d N = e[0].cross(e[1]);
+    const double double_area = N.norm();
+    data.areas(f) = 0.5*double_area;
+    for(int c = 0;c<3;c++)
+    {
+      // gradient of the hat function of corner c: the opposite edge turned
+      // inward, over twice the area
+      data.hat_gradients.row(3*f+c) =
+        double_area>0 ? Eigen::RowVector3d(N.cross(e[c])/(double_area*double_area))
+                      : Eigen::RowVector3d::Zero();
+      M_ijv.emplace_back(F(f,c),F(f,c),data.areas(f)/3.);
+      const int a = F(f,(c+1)%3), b = F(f,(c+2)%3);
+      edge_count[std::make_pair(std::min(a,b),std::max(a,b))]++;
+    }
+    for(int a = 0;a<3;a++)
+    {
+      for(int b = 0;b<3;b++)
+      {
+        K_ijv.emplace_back(F(f,a),F(f,b),
+          data.areas(f)*data.hat_gradients.row(3*f+a).dot(data.hat_gradients.row(3*f+b)));
+      }
+    }
+  }
+  Eigen::SparseMatrix<double> K(n,n), M(n,n);
+  K.setFromTriplets(K_ijv.begin(),K_ijv.end());
+  M.setFromTriplets(M_ijv.begin(),M_ijv.end());
+  if(t<=0)
+  {
+    t = m>0 ? 5.*data.areas.mean() : 1.;
+  }
+  data.t = t;
+  data.Q = M+t*K;
+
+  std::vector<bool> on_boundary(n,false);
+  for(const auto & entry : edge_count)
+  {
+    if(entry.second==1)
+    {
+      on_boundary[entry.first.first] = true;
+      on_boundary[entry.first.second] = true;
+    }
+  }
+  data.interior.clear();
+  data.boundary_vertices.clear();
+  data.interior_index.assign(n,-1);
+  data.boundary_index.assign(n,-1);
+  for(int v = 0;v<n;v++)
+  {
+    if(on_boundary[v])
+    {
+      data.boundary_index[v] = data.boundary_vertices.size();
+      data.boundary_vertices.push_back(v);
+    }else
+    {
+      data.interior_index[v] = data.interior.size();
+      data.interior.push_back(v);
+    }
+  }
+
+  if(boundary!=HEAT_GEODESIC_BOUNDARY_DIRICHLET || data.boundary_vertices.empty())
+  {
+    data.neumann.compute(data.Q);
+    if(data.neumann.info()!=Eigen::Success) return false;
+  }
+  if(boundary!=HEAT_GEODESIC_BOUNDARY_NEUMANN && !data.boundary_vertices.empty())
+  {
+    std::vector<Triplet> II, IB;
+    for(int k = 0;k<data.Q.outerSize();k++)
+    {
+      for(Eigen::SparseMatrix<double>::InnerIterator it(data.Q,k);it;++it)
+      {
+        const int i = data.interior_index[it.row()];
+        if(i<0) continue;
+        if(data.interior_index[it.col()]>=0)
+        {
+          II.emplace_back(i,data.interior_index[it.col()],it.value());
+        }else
+        {
+          IB.emplace_back(i,data.boundary_index[it.col()],it.value());
+        }
+      }
+    }
+    Eigen::SparseMatrix<double> Q_interior(data.interior.size(),data.interior.size());
+    Q_interior.setFromTriplets(II.begin(),II.end());
+    data.Q_interior_boundary.resize(data.interior.size(),data.boundary_vertices.size());
+    data.Q_interior_boundary.setFromTriplets(IB.begin(),IB.end());
+    data.dirichlet.compute(Q_interior);
+    if(data.dirichlet.info()!=Eigen::Success) return false;
+  }
+
+  Eigen::SparseMatrix<double> I(n,n);
+  I.setIdentity();
+  data.poisson.compute(K+1e-8*I);
+  return data.poisson.info()==Eigen::Success;
+}
+
+// Inputs:
+//   data  precomputed by heat_geodesic_precompute
+//   sets  #S lists of source vertices
+//   block  number of sets solved together as one multi-column solve
+// Outputs:
+//   D  #V by #S distances to every set, column major, 0 at the sources
+//     (on average over a set, as heat_geodesic.m)
+//
+// Blocks of sets are solved in parallel; the factorisations are only read.
+inline void heat_geodesic_solve(
+  const HeatGeodesicData & data,
+  const std::vector<std::vector<int> > & sets,
+  Eigen::MatrixXd & D,
+  const int block = 16)
+{
+  const int n = data.num_vertices;
+  const int m = data.F.rows();
+  const int ns = sets.size();
+  const int nb = (ns+block-1)/block;
+  const bool has_boundary = !data.boundary_vertices.empty();
+  const bool use_neumann = data.boundary!=HEAT_GEODESIC_BOUNDARY_DIRICHLET || !has_boundary;
+  const bool use_dirichlet = data.boundary!=HEAT_GEODESIC_BOUNDARY_NEUMANN && has_boundary;
+  D.resize(n,ns);
+  igl::parallel_for(
+    nb,
+    [&](const int b)
+    {
+      const int first = b*block;
+      const int nc = std::min(block,ns-first);
+      // Heat step: a literal one at the sources
+      Eigen::MatrixXd U0 = Eigen::MatrixXd::Zero(n,nc);
+      for(int c = 0;c<nc;c++)
+      {
+        for(const int s : sets[first+c]) U0(s,c) = 1;
+      }
+      Eigen::MatrixXd U = Eigen::MatrixXd::Zero(n,nc);
+      if(use_neumann)
+      {
+        U = data.neumann.solve(U0);
+      }
+      if(use_dirichlet)
+      {
+        Eigen::MatrixXd UB(data.boundary_vertices.size(),nc), BI(data.interior.size(),nc);
+        for(size_t k = 0;k<data.boundary_vertices.size();k++) UB.row(k) = U0.row(data.boundary_vertices[k]);
+        for(size_t k = 0;k<data.interior.size();k++) BI.row(k) = U0.row(data.interior[k]);
+        const Eigen::MatrixXd UI = data.dirichlet.solve(BI-data.Q_interior_boundary*UB);
+        const double w = use_neumann ? 0.5 : 1.0;
+        if(use_neumann) U *= 0.5;
+        for(size_t k = 0;k<data.boundary_vertices.size();k++) U.row(data.boundary_vertices[k]) += w*UB.row(k);
+        for(size_t k = 0;k<data.interior.size();k++) U.row(data.interior[k]) += w*UI.row(k);
+      }
+      // Normalised, reversed heat gradients integrated against the hat
+      // gradients: the right hand side of the Poisson equation K phi = G' A X
+      Eigen::MatrixXd B = Eigen::MatrixXd::Zero(n,nc);
+      for(int f = 0;f<m;f++)
+      {
+        const auto H = data.hat_gradients.middleRows<3>(3*f);
+        for(int c = 0;c<nc;c++)
+        {
+          Eigen::RowVector3d X = Eigen::RowVector3d::Zero();
+          for(int k = 0;k<3;k++) X += U(data.F(f,k),c)*H.row(k);
+          const double norm = X.norm();
+          if(!(norm>0)) continue;
+          X *= -data.areas(f)/norm;
+          for(int k = 0;k<3;k++) B(data.F(f,k),c) += H.row(k).dot(X);
+        }
+      }
+      const Eigen::MatrixXd Phi = data.poisson.solve(B);
+      for(int c = 0;c<nc;c++)
+      {
+        const std::vector<int> & set = sets[first+c];
+        double shift = 0;
+        for(const int s : set) shift += Phi(s,c);
+        shift = set.empty() ? Phi.col(c).minCoeff() : shift/set.size();
+        D.col(first+c) = Phi.col(c).array()-shift;
+      }
+    },
+    1);
+}
+
+#endif
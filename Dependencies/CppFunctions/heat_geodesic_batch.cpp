@@ -0,0 +1,153 @@
+#include "heat_geodesic.h"
+#include <Eigen/Core>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+// The factorisations of the last mesh, kept for subsequent calls with the
+// same (V,F), time and boundary conditions
+static HeatGeodesicData g_data;
+static Eigen::MatrixXd g_V;
+// Whether g_data.t was given as 'T' rather than the default for the mesh, so
+// that a call without 'T' after one with it does not reuse the explicit time
+static bool g_explicit_t = false;
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+  MatrixXd V;
+  MatrixXi F;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=3,"nrhs should be >= 3");
+  parse_rhs_double(prhs,V);
+  parse_rhs_index(prhs+1,F);
+  mexErrMsgTxt(V.cols()==3,"V must be #V by 3");
+  mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+  mexErrMsgTxt(F.minCoeff()>=0 && F.maxCoeff()<V.rows(),"F must index V");
+
+  // One list of source vertices per set: a cell of lists, or a list of single
+  // sources
+  std::vector<std::vector<int> > sets;
+  if(mxIsCell(prhs[2]))
+  {
+    sets.resize(mxGetNumberOfElements(prhs[2]));
+    for(size_t s = 0;s<sets.size();s++)
+    {
+      const mxArray * c = mxGetCell(prhs[2],s);
+      mexErrMsgTxt(c && mxIsDouble(c),"source sets should be lists of vertex indices");
+      const double * cd = mxGetPr(c);
+      for(size_t j = 0;j<mxGetNumberOfElements(c);j++) sets[s].push_back((int)cd[j]-1);
+    }
+  }else
+  {
+    mexErrMsgTxt(mxIsDouble(prhs[2]),"sources should be a list or a cell of lists of vertex indices");
+    const double * sd = mxGetPr(prhs[2]);
+    sets.resize(mxGetNumberOfElements(prhs[2]));
+    for(size_t s = 0;s<sets.size();s++) sets[s].push_back((int)sd[s]-1);
+  }
+  for(const auto & set : sets)
+  {
+    mexErrMsgTxt(!set.empty(),"source sets should not be empty");
+    for(const int v : set) mexErrMsgTxt(v>=0 && v<V.rows(),"sources must index V");
+  }
+
+  double t = 0;
+  HeatGeodesicBoundary boundary = HEAT_GEODESIC_BOUNDARY_AVERAGE;
+  int block = 16;
+  {
+    int i = 3;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("T",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        t = *mxGetPr(prhs[++i]);
+      }else if(strcmp("BoundaryConditions",name) == 0)
+      {
+        validate_arg_char(i,nrhs,prhs,name);
+        const char * type_name = mxArrayToString(prhs[++i]);
+        if(strcmp("average",type_name)==0 || strcmp("robin",type_name)==0)
+        {
+          boundary = HEAT_GEODESIC_BOUNDARY_AVERAGE;
+        }else if(strcmp("neumann",type_name)==0)
+        {
+          boundary = HEAT_GEODESIC_BOUNDARY_NEUMANN;
+        }else if(strcmp("dirichlet",type_name)==0)
+        {
+          boundary = HEAT_GEODESIC_BOUNDARY_DIRICHLET;
+        }else
+        {
+          mexErrMsgTxt(false,C_STR("Unknown BoundaryConditions: "<<type_name));
+        }
+      }else if(strcmp("Block",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        block = (int)*mxGetPr(prhs[++i]);
+        mexErrMsgTxt(block>=1,"Block should be >= 1");
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+
+  if(g_data.boundary != boundary ||
+    (t>0 ? g_data.t != t : g_explicit_t) ||
+    g_V.rows() != V.rows() || g_data.F.rows() != F.rows() ||
+    g_V != V || g_data.F != F)
+  {
+    g_V.resize(0,0);
+    mexErrMsgTxt(heat_geodesic_precompute(V,F,t,boundary,g_data),
+      "Factorisation failed, check for degenerate triangles");
+    g_V = V;
+    g_explicit_t = t>0;
+  }
+
+  MatrixXd D;
+  heat_geodesic_solve(g_data,sets,D,block);
+  switch(nlhs)
+  {
+    case 2:
+    {
+      plhs[1] = mxCreateDoubleScalar(g_data.t);
+    }
+    case 1:
+    case 0:
+    {
+      prepare_lhs_double(D,plhs+0);
+    }
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
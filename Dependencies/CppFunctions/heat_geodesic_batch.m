@@ -0,0 +1,35 @@
+% HEAT_GEODESIC_BATCH Approximate geodesic distances over a mesh from many
+% independent sets of source vertices by the heat method, with the matrices
+% factorised once per mesh
+%
+% D = heat_geodesic_batch(V,F,sources)
+% [D,t] = heat_geodesic_batch(V,F,sources,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   V  #V by 3 list of vertex positions
+%   F  #F by 3 list of triangle indices into V
+%   sources  #S list of source vertices, one set per vertex (e.g. tips), or
+%     #S cell of lists of source vertices
+%   Optional:
+%     'T' followed by the time of the heat step {5 times the mean triangle
+%       area, as heat_geodesic}
+%     'BoundaryConditions' followed by one of:
+%       {'average'}  uniform average of the Neumann and Dirichlet heat
+%       'neumann'  no heat flows out of the mesh
+%       'dirichlet'  heat fixed to 0 on the boundary
+%     'Block' followed by the number of sets solved together as one multi
+%       column back-substitution {16}
+% Outputs:
+%   D  #V by #S matrix of distances to each source set
+%   t  time of the heat step used
+%
+% This follows heat_geodesic ("Geodesics in Heat" [Crane et al. 2013]): the
+% heat step (M + t K), the Dirichlet heat step on the interior vertices and
+% the Poisson equation (K, regularised) are factorised once, then every source
+% set costs one heat solve (two with 'average') and one Poisson solve. Blocks
+% of sets are solved in parallel. The factorisations of the last (V,F), 'T'
+% and 'BoundaryConditions' are kept, so calling again with the same mesh only
+% pays the solves.
+%
+% See also: heat_geodesic_error, exact_geodesic_batch
+%
@@ -0,0 +1,47 @@
+function [E,DH,DE,times] = heat_geodesic_error(V,F,sources,varargin)
+  % HEAT_GEODESIC_ERROR Compare heat method distances (heat_geodesic_batch)
+  % with exact polyhedral distances (exact_geodesic_batch, the exact algorithm
+  % of exactgeodesic) from the same source sets
+  %
+  % E = heat_geodesic_error(V,F,sources)
+  % [E,DH,DE,times] = heat_geodesic_error(V,F,sources,'ParameterName',ParameterValue, ...)
+  %
+  % Inputs:
+  %   V  #V by 3 list of vertex positions
+  %   F  #F by 3 list of triangle indices into V
+  %   sources  #S list of source vertices or #S cell of lists of source
+  %     vertices, as heat_geodesic_batch
+  %   Optional:
+  %     parameters of heat_geodesic_batch ('T', 'BoundaryConditions', 'Block')
+  % Outputs:
+  %   E  struct of errors relative to the largest exact distance of each set:
+  %     E.max  #S list of largest errors
+  %     E.mean  #S list of mean errors
+  %   DH  #V by #S heat method distances
+  %   DE  #V by #S exact distances
+  %   times  struct of seconds spent: times.heat_first (with factorisation,
+  %     unless (V,F) was the last mesh of heat_geodesic_batch), times.heat
+  %     (factorisation reused) and times.exact
+  %
+  % Example:
+  %   [V,F] = subdivided_sphere(4);
+  %   E = heat_geodesic_error(V,F,randperm(size(V,1),50));
+  %   fprintf('max %g, mean %g\n',max(E.max),mean(E.mean));
+  %
+
+  tic;
+  DH = heat_geodesic_batch(V,F,sources,varargin{:});
+  times.heat_first = toc;
+  tic;
+  DH = heat_geodesic_batch(V,F,sources,varargin{:});
+  times.heat = toc;
+  tic;
+  DE = exact_geodesic_batch(V,F,sources);
+  times.exact = toc;
+
+  scale = max(DE,[],1);
+  scale(scale==0) = 1;
+  err = abs(DH-DE)./scale;
+  E.max = max(err,[],1)';
+  E.mean = mean(err,1)';
+end
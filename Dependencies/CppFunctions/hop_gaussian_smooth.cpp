@@ -0,0 +1,221 @@
+#include "mesh_graph.h"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/parallel_for.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMatrixXd;
+
+// Y = diag(W*1)^-1 * W * X where W(i,ids[k]-base) = w[hops[k]] for k in row
+// i of the k-hop neighbourhood, i.e. the row normalised smoothing matrix of
+// meshGaussian applied without being assembled. Adds sum(abs(Y-X)) of each
+// column to change when Y and X have the same rows.
+inline void apply_hop_kernel(
+  const std::vector<int64_t> & offsets,
+  const uint32_t * ids,
+  const uint8_t * hops,
+  const int base,
+  const std::vector<double> & w,
+  const std::vector<double> & inv_row_sum,
+  const RowMatrixXd & X,
+  RowMatrixXd & Y,
+  Eigen::RowVectorXd & change)
+{
+  const int nr = (int)offsets.size()-1;
+  const int nc = X.cols();
+  std::vector<Eigen::RowVectorXd> thread_change;
+  igl::parallel_for(
+    nr,
+    [&](const size_t nt){ thread_change.assign(nt,Eigen::RowVectorXd::Zero(nc)); },
+    [&](const int i, const size_t t)
+    {
+      Eigen::RowVectorXd acc = Eigen::RowVectorXd::Zero(nc);
+      for(int64_t k = offsets[i];k<offsets[i+1];k++)
+      {
+        acc += w[hops[k]]*X.row(ids[k]-base);
+      }
+      Y.row(i) = inv_row_sum[i]*acc;
+      if(X.rows()==nr) thread_change[t] += (Y.row(i)-X.row(i)).cwiseAbs();
+    },
+    [&](const size_t t){ change += thread_change[t]; },
+    1000);
+}
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  // Neighbourhoods either come from k_hop_neighbourhood or are computed here
+  // from the faces (and then never leave this function)
+  std::vector<int64_t> offsets;
+  const uint32_t * ids = nullptr;
+  const uint8_t * hops = nullptr;
+  int base = 1;
+  KHopNeighbourhood N;
+  int a = 0;
+  mexErrMsgTxt(nrhs>=5,"nrhs should be >= 5");
+  if(mxIsUint32(prhs[1]))
+  {
+    mexErrMsgTxt(nrhs>=6,"nrhs should be >= 6");
+    mexErrMsgTxt(mxIsDouble(prhs[0]),"offsets should be double");
+    mexErrMsgTxt(mxIsUint8(prhs[2]),"hops should be uint8");
+    const size_t no = mxGetNumberOfElements(prhs[0]);
+    mexErrMsgTxt(no>=1,"offsets should not be empty");
+    offsets.assign(mxGetPr(prhs[0]),mxGetPr(prhs[0])+no);
+    ids = (const uint32_t*)mxGetData(prhs[1]);
+    hops = (const uint8_t*)mxGetData(prhs[2]);
+    mexErrMsgTxt(
+      (int64_t)mxGetNumberOfElements(prhs[1])==offsets.back() &&
+      (int64_t)mxGetNumberOfElements(prhs[2])==offsets.back(),
+      "ids and hops should have offsets(end) elements");
+    a = 3;
+  }else
+  {
+    MatrixXi F;
+    parse_rhs_index(prhs,F);
+    mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+    mexErrMsgTxt(F.size()==0 || F.minCoeff()>=0,"F must contain positive indices");
+    mexErrMsgTxt(
+      mxIsDouble(prhs[1]) && mxGetM(prhs[1])==1 && mxGetN(prhs[1])==1,
+      "K should be scalar");
+    const int K = (int)*mxGetPr(prhs[1]);
+    mexErrMsgTxt(K>=0 && K<=255,"K should be in [0,255]");
+    // #V is the number of rows of X, which may exceed max(F(:))
+    const int n = mxGetM(prhs[2]);
+    mexErrMsgTxt(F.size()==0 || F.maxCoeff()<n,"X must have a row per vertex of F");
+    MeshGraph G;
+    mesh_graph_from_faces(F,n,G);
+    std::vector<int> sources(G.num_vertices());
+    for(int v = 0;v<G.num_vertices();v++) sources[v] = v;
+    k_hop_neighbourhood(G,K,sources,N);
+    offsets.swap(N.offsets);
+    ids = N.ids.data();
+    hops = N.hops.data();
+    base = 0;
+    a = 2;
+  }
+  const int nr = (int)offsets.size()-1;
+
+  MatrixXd X;
+  parse_rhs_double(prhs+a,X);
+  mexErrMsgTxt(
+    mxIsDouble(prhs[a+1]) && mxGetM(prhs[a+1])==1 && mxGetN(prhs[a+1])==1,
+    "sigma should be scalar");
+  const double sigma = *mxGetPr(prhs[a+1]);
+  mexErrMsgTxt(sigma>0,"sigma should be > 0");
+  VectorXi steps;
+  mexErrMsgTxt(mxIsDouble(prhs[a+2]),"steps should be double");
+  {
+    VectorXd stepsd;
+    parse_rhs_double(prhs+a+2,stepsd);
+    steps = stepsd.cast<int>();
+  }
+  mexErrMsgTxt(steps.size()>0 && steps.minCoeff()>=0,"steps should be non-negative");
+
+  bool reverse = false;
+  {
+    int i = a+3;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Reverse",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_logical(i,nrhs,prhs,name);
+        reverse = *(mxLogical*)mxGetData(prhs[++i]);
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+
+  const int64_t nnz = offsets.back();
+  int max_hop = 0;
+  for(int64_t k = 0;k<nnz;k++)
+  {
+    mexErrMsgTxt(ids[k]>=(uint32_t)base && ids[k]-base<(uint32_t)X.rows(),"ids out of range for X");
+    max_hop = std::max<int>(max_hop,hops[k]);
+  }
+  mexErrMsgTxt(X.rows()==nr || (steps.size()==1 && steps(0)==1),
+    "X must have one row per neighbourhood unless steps is 1");
+
+  // Per hop weights of meshGaussian (its constant factor cancels in the row
+  // normalisation). Reverse weighs hop h as max(hops)+1-h.
+  std::vector<double> w(256,0);
+  for(int h = 0;h<=max_hop;h++)
+  {
+    const double d = reverse ? max_hop+1-h : h;
+    w[h] = exp(-(d*d)/(2*sigma*sigma));
+  }
+  std::vector<double> inv_row_sum(nr);
+  parallel_for(nr,[&](const int i)
+  {
+    double s = 0;
+    for(int64_t k = offsets[i];k<offsets[i+1];k++) s += w[hops[k]];
+    inv_row_sum[i] = s>0 ? 1./s : 0;
+  },1000);
+
+  RowMatrixXd cur = X, next(nr,X.cols());
+  const int nc = X.cols();
+  const int ns = steps.size();
+  mwSize dims[3] = {(mwSize)nr,(mwSize)ns,(mwSize)nc};
+  plhs[0] = mxCreateNumericArray(3,dims,mxDOUBLE_CLASS,mxREAL);
+  double * S = mxGetPr(plhs[0]);
+  MatrixXd change(steps.sum(),nc);
+  int iter = 0;
+  for(int s = 0;s<ns;s++)
+  {
+    for(int j = 0;j<steps(s);j++,iter++)
+    {
+      RowVectorXd c = RowVectorXd::Zero(nc);
+      apply_hop_kernel(offsets,ids,hops,base,w,inv_row_sum,cur,next,c);
+      change.row(iter) = c;
+      cur.swap(next);
+    }
+    // Snapshot after sum(steps(1:s)) iterations
+    for(int c = 0;c<nc;c++)
+    {
+      Map<VectorXd>(S+((int64_t)c*ns+s)*nr,nr) = cur.col(c).head(nr);
+    }
+  }
+
+  switch(nlhs)
+  {
+    case 2:
+      prepare_lhs_double(change,plhs+1);
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
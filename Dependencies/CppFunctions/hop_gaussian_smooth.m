@@ -0,0 +1,28 @@
+% HOP_GAUSSIAN_SMOOTH Repeatedly apply the row normalised hop Gaussian of
+% meshGaussian to mesh signals, directly from k-hop neighbourhoods (the
+% sparse smoothing matrix is never built)
+%
+% S = hop_gaussian_smooth(offsets,ids,hops,X,sigma,steps)
+% S = hop_gaussian_smooth(F,K,X,sigma,steps)
+% [S,change] = hop_gaussian_smooth(...,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   offsets,ids,hops  k-hop neighbourhoods of every vertex from
+%     k_hop_neighbourhood, or
+%   F,K  #F by 3 list of triangle indices and number of hops; neighbourhoods
+%     are computed internally and discarded, for the #V = size(X,1) vertices
+%   X  #V by c list of signals, smoothed together (one column per signal)
+%   sigma  standard deviation of the Gaussian in hops
+%   steps  #steps list of iteration counts between snapshots, e.g.
+%     [5 5 10 10 10] stores the results after 5, 10, 20, 30 and 40 iterations
+%   Optional:
+%     'Reverse' followed by logical: weigh hop h as max(hops)+1-h, as the
+%       localAvg operator of computeSurfaceMeasures does {false}
+% Outputs:
+%   S  #V by #steps by c array of smoothed signals at each snapshot
+%   change  sum(steps) by c list of sum(abs(difference)) per iteration (as
+%     returned by contSmooth)
+%
+% A single application to a subset of rows (offsets from the 'Query'
+% option of k_hop_neighbourhood, steps = 1) returns #Q by 1 by c.
+%
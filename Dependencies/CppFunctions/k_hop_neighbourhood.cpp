@@ -0,0 +1,127 @@
+#include "mesh_graph.h"
+#include <Eigen/Core>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=2,"nrhs should be >= 2");
+  // Optional #V after K, so that vertices after the last one referenced by F
+  // still get (singleton) neighbourhoods
+  const bool has_n = nrhs>=3 && !mxIsChar(prhs[2]);
+  MeshGraph G;
+  if(mxIsSparse(prhs[0]))
+  {
+    mexErrMsgTxt(mxGetM(prhs[0])==mxGetN(prhs[0]),"A must be square");
+    mexErrMsgTxt(!has_n,"n is only used with F");
+    const int n = mxGetN(prhs[0]);
+    mesh_graph_from_csc(mxGetJc(prhs[0]),mxGetIr(prhs[0]),n,G);
+  }else
+  {
+    MatrixXi F;
+    parse_rhs_index(prhs,F);
+    mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+    mexErrMsgTxt(F.size()==0 || F.minCoeff()>=0,"F must contain positive indices");
+    int n = F.size()==0 ? 0 : F.maxCoeff()+1;
+    if(has_n)
+    {
+      mexErrMsgTxt(
+        mxIsDouble(prhs[2]) && mxGetM(prhs[2])==1 && mxGetN(prhs[2])==1,
+        "n should be scalar");
+      mexErrMsgTxt(*mxGetPr(prhs[2])>=n,"n should be >= max(F(:))");
+      n = (int)*mxGetPr(prhs[2]);
+    }
+    mesh_graph_from_faces(F,n,G);
+  }
+  mexErrMsgTxt(
+    mxIsDouble(prhs[1]) && mxGetM(prhs[1])==1 && mxGetN(prhs[1])==1,
+    "K should be scalar");
+  const int K = (int)*mxGetPr(prhs[1]);
+  mexErrMsgTxt(K>=0 && K<=255,"K should be in [0,255]");
+
+  std::vector<int> sources;
+  {
+    int i = has_n ? 3 : 2;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Query",name) == 0)
+      {
+        validate_arg_double(i,nrhs,prhs,name);
+        VectorXi Q;
+        parse_rhs_index(prhs+(++i),Q);
+        for(int q = 0;q<Q.size();q++)
+        {
+          mexErrMsgTxt(Q(q)>=0 && Q(q)<G.num_vertices(),"Query out of range");
+        }
+        sources.assign(Q.data(),Q.data()+Q.size());
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+  if(sources.empty())
+  {
+    sources.resize(G.num_vertices());
+    for(int v = 0;v<G.num_vertices();v++) sources[v] = v;
+  }
+
+  KHopNeighbourhood N;
+  k_hop_neighbourhood(G,K,sources,N);
+
+  switch(nlhs)
+  {
+    case 3:
+    {
+      plhs[2] = mxCreateNumericMatrix(N.hops.size(),1,mxUINT8_CLASS,mxREAL);
+      std::copy(N.hops.begin(),N.hops.end(),(uint8_t*)mxGetData(plhs[2]));
+      std::vector<uint8_t>().swap(N.hops);
+    }
+    case 2:
+    {
+      plhs[1] = mxCreateNumericMatrix(N.ids.size(),1,mxUINT32_CLASS,mxREAL);
+      uint32_t * ids = (uint32_t*)mxGetData(plhs[1]);
+      for(size_t k = 0;k<N.ids.size();k++) ids[k] = N.ids[k]+1;
+      std::vector<uint32_t>().swap(N.ids);
+    }
+    case 1:
+    {
+      plhs[0] = mxCreateDoubleMatrix(N.offsets.size(),1,mxREAL);
+      std::copy(N.offsets.begin(),N.offsets.end(),mxGetPr(plhs[0]));
+    }
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
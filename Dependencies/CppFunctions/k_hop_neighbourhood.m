@@ -0,0 +1,27 @@
+% K_HOP_NEIGHBOURHOOD Vertices within K hops of each (query) vertex of a mesh,
+% by a bounded breadth first search from every source run in parallel
+%
+% offsets = k_hop_neighbourhood(F,K)
+% offsets = k_hop_neighbourhood(F,K,n)
+% [offsets,ids,hops] = k_hop_neighbourhood(A,K,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   F  #F by 3 list of triangle indices, or
+%   A  #V by #V symmetric sparse adjacency matrix (e.g. triangulation2adjacency)
+%   K  maximum number of hops (<= 255)
+%   n  number of vertices #V (only with F) {max(F(:))}. Pass size(V,1) when
+%     the mesh may have vertices after the last one referenced by F
+%   Optional:
+%     'Query' followed by #Q list of source vertices {1:#V}. Use this to
+%       compute neighbourhoods of a subset on demand instead of storing the
+%       neighbourhoods of all vertices
+% Outputs:
+%   offsets  #Q+1 list of offsets: ids(offsets(q)+1:offsets(q+1)) are the
+%     vertices within K hops of query q, the query itself first
+%   ids  offsets(end) uint32 list of 1-based vertex ids
+%   hops  offsets(end) uint8 list of hop counts (0 for the query itself)
+%
+% The triplets returned by getStepVectors are
+%   sourceNodes = repelem(Q(:), diff(offsets)); targetNodes = ids; hopCounts = hops;
+% in a different order within each source.
+%
@@ -0,0 +1,152 @@
+#include "label_components.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=2,"nrhs should be >= 2");
+  mexErrMsgTxt(mxIsDouble(prhs[1]) && !mxIsSparse(prhs[1]),"L should be a full double vector");
+  const int n = mxGetNumberOfElements(prhs[1]);
+  std::vector<double> L(mxGetPr(prhs[1]),mxGetPr(prhs[1])+n);
+  MeshGraph G;
+  if(mxIsSparse(prhs[0]))
+  {
+    mexErrMsgTxt(mxGetM(prhs[0])==(size_t)n && mxGetN(prhs[0])==(size_t)n,"A must be #L by #L");
+    mesh_graph_from_csc(mxGetJc(prhs[0]),mxGetIr(prhs[0]),n,G);
+  }else
+  {
+    MatrixXi F;
+    parse_rhs_index(prhs,F);
+    mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+    mexErrMsgTxt(F.size()==0 || (F.minCoeff()>=0 && F.maxCoeff()<n),"F must index L");
+    mesh_graph_from_faces(F,n,G);
+  }
+
+  std::vector<double> order, erase;
+  int64_t min_size = 0;
+  double erase_to = 0;
+  {
+    int i = 2;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Order",name) == 0)
+      {
+        validate_arg_double(i,nrhs,prhs,name);
+        ++i;
+        order.assign(mxGetPr(prhs[i]),mxGetPr(prhs[i])+mxGetNumberOfElements(prhs[i]));
+      }else if(strcmp("Erase",name) == 0)
+      {
+        validate_arg_double(i,nrhs,prhs,name);
+        ++i;
+        erase.assign(mxGetPr(prhs[i]),mxGetPr(prhs[i])+mxGetNumberOfElements(prhs[i]));
+      }else if(strcmp("MinSize",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        min_size = (int64_t)*mxGetPr(prhs[++i]);
+      }else if(strcmp("EraseTo",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        erase_to = *mxGetPr(prhs[++i]);
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+  if(order.empty())
+  {
+    order = L;
+    if(!erase.empty()) order.push_back(erase_to);
+    std::sort(order.begin(),order.end());
+    order.erase(std::unique(order.begin(),order.end()),order.end());
+  }
+
+  LabelComponents C;
+  label_components(G,L,order,erase,min_size,erase_to,C);
+
+  switch(nlhs)
+  {
+    case 6:
+    {
+      plhs[5] = mxCreateDoubleMatrix(C.erased.size(),1,mxREAL);
+      std::copy(C.erased.begin(),C.erased.end(),mxGetPr(plhs[5]));
+    }
+    case 5:
+    {
+      // Number of mesh edges between each pair of components
+      std::vector<Triplet<double> > IJV;
+      for(int v = 0;v<n;v++)
+      {
+        for(int64_t k = G.offsets[v];k<G.offsets[v+1];k++)
+        {
+          const int a = C.component[v], b = C.component[G.neighbours[k]];
+          if(a>=0 && b>=0 && a!=b) IJV.emplace_back(a,b,1.0);
+        }
+      }
+      SparseMatrix<double> RA(C.sizes.size(),C.sizes.size());
+      RA.setFromTriplets(IJV.begin(),IJV.end());
+      prepare_lhs_double(RA,plhs+4);
+    }
+    case 4:
+    {
+      plhs[3] = mxCreateDoubleMatrix(C.labels.size(),1,mxREAL);
+      std::copy(C.labels.begin(),C.labels.end(),mxGetPr(plhs[3]));
+    }
+    case 3:
+    {
+      plhs[2] = mxCreateDoubleMatrix(C.sizes.size(),1,mxREAL);
+      std::copy(C.sizes.begin(),C.sizes.end(),mxGetPr(plhs[2]));
+    }
+    case 2:
+    {
+      plhs[1] = mxCreateDoubleMatrix(n,1,mxREAL);
+      double * c = mxGetPr(plhs[1]);
+      for(int v = 0;v<n;v++) c[v] = C.component[v]+1;
+    }
+    case 1:
+    {
+      // same shape as the input labels
+      plhs[0] = mxCreateDoubleMatrix(mxGetM(prhs[1]),mxGetN(prhs[1]),mxREAL);
+      std::copy(L.begin(),L.end(),mxGetPr(plhs[0]));
+    }
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
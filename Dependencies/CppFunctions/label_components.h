@@ -0,0 +1,180 @@
+#ifndef LABEL_COMPONENTS_H
+#define LABEL_COMPONENTS_H
+// Connected components of equally labelled vertices of a mesh graph, for all
+// labels at once, by a concurrent union-find. Nothing here depends on MATLAB.
+#include "mesh_graph.h"
+#include <igl/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Union-find forest that can be united from several threads at once. A root
+// is only ever linked below a lower numbered root, so parent[v] <= v and the
+// root of every tree is its lowest vertex, independent of the order in which
+// edges were united.
+class ConcurrentUnionFind
+{
+  public:
+    explicit ConcurrentUnionFind(const int n) : parent(n)
+    {
+      for(int v = 0;v<n;v++) parent[v].store(v,std::memory_order_relaxed);
+    }
+
+    int find(int x)
+    {
+      while(true)
+      {
+        const int p = parent[x].load();
+        if(p==x) return x;
+        const int gp = parent[p].load();
+        if(gp!=p)
+        {
+          // path halving; losing the race only skips a shortcut
+          int expected = p;
+          parent[x].compare_exchange_weak(expected,gp);
+        }
+        x = gp;
+      }
+    }
+
+    void unite(int a, int b)
+    {
+      while(true)
+      {
+        a = find(a);
+        b = find(b);
+        if(a==b) return;
+        if(a<b) std::swap(a,b);
+        int expected = a;
+        if(parent[a].compare_exchange_strong(expected,b)) return;
+      }
+    }
+
+  private:
+    std::vector<std::atomic<int> > parent;
+};
+
+struct LabelComponents
+{
+  // component[v] is the (0-based) component of vertex v, -1 if its label is
+  // not listed. Components are numbered label by label in the listed order
+  // and, within a label, by their lowest vertex (the order of conncomp on
+  // the subgraph of that label).
+  std::vector<int> component;
+  std::vector<int64_t> sizes;
+  std::vector<double> labels;
+  // erased[e] is the number of components of erase_labels[e] smaller than
+  // min_size, including those already labelled erase_to
+  std::vector<int> erased;
+};
+
+// Inputs:
+//   G  mesh graph
+//   L  #V list of vertex labels
+//   order  list of labels to number components of
+//   erase_labels  list of labels whose small components are erased
+//   min_size  components of erase_labels with fewer vertices are relabelled
+//   erase_to  label given to erased vertices
+// Outputs:
+//   L  labels with small components erased
+//   C  components of L
+//
+// Erasing all labels at once is the same as erasing them one after another
+// (as repeated calls to eraser do), since an erased component never changes
+// the components of another label being erased.
+inline void label_components(
+  const MeshGraph & G,
+  std::vector<double> & L,
+  const std::vector<double> & order,
+  const std::vector<double> & erase_labels,
+  const int64_t min_size,
+  const double erase_to,
+  LabelComponents & C)
+{
+  const int n = G.num_vertices();
+  const auto index_of = [](const std::vector<double> & list, const double l)
+  {
+    return (int)(std::find(list.begin(),list.end(),l)-list.begin());
+  };
+  ConcurrentUnionFind U(n);
+  // unites v with its equally labelled neighbours
+  const auto unite_neighbours = [&](const int v, const bool both_ways)
+  {
+    for(int64_t k = G.offsets[v];k<G.offsets[v+1];k++)
+    {
+      const int w = G.neighbours[k];
+      if((both_ways || w>v) && L[w]==L[v]) U.unite(v,w);
+    }
+  };
+  std::vector<int> root(n);
+  std::vector<int64_t> count(n);
+  const auto find_roots = [&]()
+  {
+    igl::parallel_for(n,[&](const int v){ root[v] = U.find(v); },1000);
+    std::fill(count.begin(),count.end(),0);
+    for(int v = 0;v<n;v++) count[root[v]]++;
+  };
+
+  igl::parallel_for(n,[&](const int v){ unite_neighbours(v,false); },1000);
+  find_roots();
+
+  C.erased.assign(erase_labels.size(),0);
+  if(!erase_labels.empty())
+  {
+    std::vector<char> erase(n,0);
+    bool any = false;
+    for(int v = 0;v<n;v++)
+    {
+      if(root[v]!=v || count[v]>=min_size) continue;
+      const int e = index_of(erase_labels,L[v]);
+      if(e==(int)erase_labels.size()) continue;
+      // counted like eraser does, but already labelled erase_to
+      C.erased[e]++;
+      if(L[v]==erase_to) continue;
+      erase[v] = 1;
+      any = true;
+    }
+    if(any)
+    {
+      std::vector<int> erased_vertices;
+      for(int v = 0;v<n;v++)
+      {
+        if(!erase[root[v]]) continue;
+        L[v] = erase_to;
+        erased_vertices.push_back(v);
+      }
+      // erased vertices join the components of their new label
+      igl::parallel_for(
+        (int)erased_vertices.size(),
+        [&](const int i){ unite_neighbours(erased_vertices[i],true); },
+        1000);
+      find_roots();
+    }
+  }
+
+  // Number the components label by label, each by its lowest vertex
+  std::vector<std::vector<int> > roots(order.size());
+  for(int v = 0;v<n;v++)
+  {
+    if(root[v]!=v) continue;
+    const int o = index_of(order,L[v]);
+    if(o<(int)order.size()) roots[o].push_back(v);
+  }
+  std::vector<int> id(n,-1);
+  C.sizes.clear();
+  C.labels.clear();
+  for(size_t o = 0;o<order.size();o++)
+  {
+    for(const int r : roots[o])
+    {
+      id[r] = C.sizes.size();
+      C.sizes.push_back(count[r]);
+      C.labels.push_back(order[o]);
+    }
+  }
+  C.component.resize(n);
+  igl::parallel_for(n,[&](const int v){ C.component[v] = id[root[v]]; },1000);
+}
+
+#endif
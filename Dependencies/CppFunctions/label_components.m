@@ -0,0 +1,30 @@
+% LABEL_COMPONENTS Connected components of equally labelled vertices of a mesh,
+% for all labels in one parallel union-find pass, optionally erasing small
+% components first
+%
+% L = label_components(F,L,'Erase',vals,'MinSize',n)
+% [L,C,S,CL,RA,E] = label_components(A,L,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   F  #F by 3 list of triangle indices, or
+%   A  #V by #V symmetric sparse adjacency matrix (e.g. adjacency(g))
+%   L  #V list of vertex labels
+%   Optional:
+%     'Order' followed by list of labels to number components of
+%       {unique(L)}. Vertices with other labels belong to no component.
+%     'Erase' followed by list of labels whose small components are erased
+%       {[]}, as eraser(g,L,val,n) does for each val
+%     'MinSize' followed by the number of vertices below which a component is
+%       small {0}
+%     'EraseTo' followed by the label given to erased vertices {0}
+% Outputs:
+%   L  #V list of labels after erasing
+%   C  #V list of components of L (0 for labels not in Order), numbered
+%     label by label in Order and within a label by lowest vertex, i.e. the
+%     region ids assigned by consecutive calls to listefy
+%   S  #C list of component sizes
+%   CL  #C list of component labels
+%   RA  #C by #C sparse number of mesh edges between components
+%   E  #Erase list of number of components erased per label (small
+%     components of EraseTo itself count, as in eraser)
+%
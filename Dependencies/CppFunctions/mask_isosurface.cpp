@@ -0,0 +1,129 @@
+// Compile with -I../../Tools/OldSkeltools/include
+#include <marchingCubes.h>
+#include <cstring>
+#include <iostream>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/validate_arg.h>
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=1,"nrhs should be >= 1");
+  const mxClassID input_class = mxGetClassID(prhs[0]);
+  mexErrMsgTxt(
+    input_class==mxLOGICAL_CLASS || input_class==mxUINT8_CLASS ||
+    input_class==mxSINGLE_CLASS || input_class==mxDOUBLE_CLASS,
+    "V should be logical, uint8, single or double");
+  mexErrMsgTxt(mxGetNumberOfDimensions(prhs[0])<=3,"V should be a volume");
+  const mwSize * dims = mxGetDimensions(prhs[0]);
+  const std::array<std::size_t,3> size = {{
+    (std::size_t)dims[0],
+    (std::size_t)dims[1],
+    mxGetNumberOfDimensions(prhs[0])==3 ? (std::size_t)dims[2] : 1}};
+
+  SurfaceOptions options;
+  {
+    int i = 1;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Level",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        options.level = *mxGetPr(prhs[++i]);
+      }else if(strcmp("Largest",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_logical(i,nrhs,prhs,name);
+        options.keepLargest = *mxGetLogicals(prhs[++i]);
+      }else if(strcmp("SlabDepth",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        options.slabDepth = (std::size_t)*mxGetPr(prhs[++i]);
+      }else if(strcmp("Threads",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        options.numThreads = (unsigned)*mxGetPr(prhs[++i]);
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+
+  const std::array<double,3> spacing = {{1,1,1}};
+  SurfaceMesh mesh;
+  switch(input_class)
+  {
+    case mxLOGICAL_CLASS:
+      mesh = extractSurface((const mxLogical*)mxGetData(prhs[0]),size,spacing,options);
+      break;
+    case mxUINT8_CLASS:
+      mesh = extractSurface((const uint8_t*)mxGetData(prhs[0]),size,spacing,options);
+      break;
+    case mxSINGLE_CLASS:
+      mesh = extractSurface((const float*)mxGetData(prhs[0]),size,spacing,options);
+      break;
+    default:
+      mesh = extractSurface((const double*)mxGetData(prhs[0]),size,spacing,options);
+      break;
+  }
+
+  // isosurface convention: x is the column (2nd) index, y the row (1st) one,
+  // 1-based. Swapping x and y mirrors the mesh, so faces are flipped to stay
+  // outward facing.
+  const size_t nv = mesh.vertices.size(), nf = mesh.faces.size();
+  plhs[0] = mxCreateDoubleMatrix(nv,3,mxREAL);
+  double * V = mxGetPr(plhs[0]);
+  for(size_t v = 0;v<nv;v++)
+  {
+    V[v+0*nv] = mesh.vertices[v][1]+1;
+    V[v+1*nv] = mesh.vertices[v][0]+1;
+    V[v+2*nv] = mesh.vertices[v][2]+1;
+  }
+  switch(nlhs)
+  {
+    case 3:
+      plhs[2] = mxCreateDoubleScalar(mesh.numComponents);
+    case 2:
+    {
+      plhs[1] = mxCreateDoubleMatrix(nf,3,mxREAL);
+      double * F = mxGetPr(plhs[1]);
+      for(size_t f = 0;f<nf;f++)
+      {
+        F[f+0*nf] = mesh.faces[f][0]+1;
+        F[f+1*nf] = mesh.faces[f][2]+1;
+        F[f+2*nf] = mesh.faces[f][1]+1;
+      }
+    }
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
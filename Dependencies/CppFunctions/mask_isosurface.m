@@ -0,0 +1,34 @@
+% MASK_ISOSURFACE Welded marching cubes surface of a volume, triangulated slab
+% by slab in parallel
+%
+% [V,F] = mask_isosurface(BW)
+% [V,F,numComponents] = mask_isosurface(BW,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   BW  #X by #Y by #Z logical, uint8, single or double volume
+%   Optional:
+%     'Level' followed by the iso value, voxels above it are inside {0.5}
+%     'Largest' followed by whether to keep only the connected component with
+%       the most vertices {false}
+%     'SlabDepth' followed by the number of cube layers triangulated at once
+%       by one thread {32}
+%     'Threads' followed by the number of threads {all cores}
+% Outputs:
+%   V  #V by 3 list of vertex positions, in the coordinates of isosurface(BW)
+%     (column, row, slice, 1-based)
+%   F  #F by 3 list of outward facing triangle indices into V
+%   numComponents  number of connected components before 'Largest' (0 if
+%     'Largest' is false)
+%
+% Voxels past the border (and NaN) count as 0, so objects touching it are
+% closed without padarray. Vertices are welded by grid edge while
+% triangulating, so the mesh has no duplicate or unreferenced vertices:
+%   [V,F] = mask_isosurface(BW,'Largest',true);
+% replaces
+%   mesh = isosurface(padarray(BW,[3 3 3]),0.5); mesh.vertices = mesh.vertices-3;
+%   mesh = removeSmallMeshes(mesh); [V,F] = checkAndRepairMesh(mesh.vertices,mesh.faces,'dup');
+% up to the triangulation of each cube.
+%
+% Compile with the skeltool headers on the include path:
+%   mex -I../../Tools/OldSkeltools/include mask_isosurface.cpp ...
+%
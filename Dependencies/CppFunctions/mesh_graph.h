@@ -0,0 +1,187 @@
+#ifndef MESH_GRAPH_H
+#define MESH_GRAPH_H
+// Vertex adjacency of a triangle mesh in compressed sparse row form and
+// bounded breadth first search over it. Shared by the k-hop neighbourhood mex
+// functions; nothing here depends on MATLAB.
+#include <Eigen/Core>
+#include <igl/parallel_for.h>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct MeshGraph
+{
+  // neighbours[offsets[v]] ... neighbours[offsets[v+1]-1] are the sorted
+  // neighbours of vertex v
+  std::vector<int64_t> offsets;
+  std::vector<int> neighbours;
+
+  int num_vertices() const { return offsets.empty() ? 0 : (int)offsets.size()-1; }
+};
+
+// Inputs:
+//   F  #F by 3 list of (0-based) triangle indices
+//   n  number of vertices (>= F.maxCoeff()+1)
+// Outputs:
+//   G  undirected edge graph of F
+inline void mesh_graph_from_faces(const Eigen::MatrixXi & F, const int n, MeshGraph & G)
+{
+  std::vector<std::pair<int,int> > E;
+  E.reserve(F.size()*2);
+  for(int f = 0;f<F.rows();f++)
+  {
+    for(int c = 0;c<F.cols();c++)
+    {
+      const int a = F(f,c), b = F(f,(c+1)%F.cols());
+      if(a==b) continue;
+      E.emplace_back(a,b);
+      E.emplace_back(b,a);
+    }
+  }
+  std::sort(E.begin(),E.end());
+  E.erase(std::unique(E.begin(),E.end()),E.end());
+  G.offsets.assign(n+1,0);
+  G.neighbours.resize(E.size());
+  for(size_t e = 0;e<E.size();e++)
+  {
+    G.offsets[E[e].first+1]++;
+    G.neighbours[e] = E[e].second;
+  }
+  for(int v = 0;v<n;v++) G.offsets[v+1] += G.offsets[v];
+}
+
+// Inputs:
+//   jc,ir  compressed sparse column pattern of a symmetric n by n adjacency
+//     matrix (e.g. the mxGetJc/mxGetIr arrays of a MATLAB sparse matrix)
+//   n  number of vertices
+// Outputs:
+//   G  graph with the diagonal dropped
+template <typename Index>
+inline void mesh_graph_from_csc(const Index * jc, const Index * ir, const int n, MeshGraph & G)
+{
+  G.offsets.assign(n+1,0);
+  G.neighbours.clear();
+  G.neighbours.reserve(jc[n]);
+  for(int v = 0;v<n;v++)
+  {
+    for(Index k = jc[v];k<jc[v+1];k++)
+    {
+      if((int)ir[k]!=v) G.neighbours.push_back((int)ir[k]);
+    }
+    G.offsets[v+1] = G.neighbours.size();
+  }
+}
+
+// Breadth first search bounded by a number of hops. The visited set is a
+// stamp per vertex, so one instance (per thread) serves any number of
+// sources without being cleared.
+class HopBFS
+{
+  public:
+    explicit HopBFS(const MeshGraph & G) : G(&G), stamp(G.num_vertices(),0), current(0) {}
+
+    // Calls visit(v,hop) for every vertex v within max_hops of source in
+    // nondecreasing hop order, starting with visit(source,0).
+    template <typename Visit>
+    void run(const int source, const int max_hops, Visit && visit)
+    {
+      if(++current==0)
+      {
+        // stamp wrapped around
+        std::fill(stamp.begin(),stamp.end(),0);
+        current = 1;
+      }
+      frontier.assign(1,source);
+      stamp[source] = current;
+      visit(source,0);
+      for(int hop = 1;hop<=max_hops && !frontier.empty();hop++)
+      {
+        next.clear();
+        for(const int u : frontier)
+        {
+          for(int64_t k = G->offsets[u];k<G->offsets[u+1];k++)
+          {
+            const int v = G->neighbours[k];
+            if(stamp[v]==current) continue;
+            stamp[v] = current;
+            next.push_back(v);
+            visit(v,hop);
+          }
+        }
+        frontier.swap(next);
+      }
+    }
+
+  private:
+    const MeshGraph * G;
+    std::vector<uint32_t> stamp;
+    uint32_t current;
+    std::vector<int> frontier, next;
+};
+
+// k-hop neighbourhoods of a list of source vertices in compressed sparse row
+// form: ids[offsets[i]] ... ids[offsets[i+1]-1] are the vertices within K hops
+// of sources[i] (the source itself first, with hop 0) and hops[] their hop
+// counts.
+struct KHopNeighbourhood
+{
+  std::vector<int64_t> offsets;
+  std::vector<uint32_t> ids;
+  std::vector<uint8_t> hops;
+};
+
+// Inputs:
+//   G  mesh graph
+//   K  maximum number of hops (<= 255)
+//   sources  list of source vertices
+// Outputs:
+//   N  neighbourhoods of sources
+//
+// Runs the searches twice in parallel over the sources, once to size each
+// row and once to fill it, so the output is allocated exactly once.
+inline void k_hop_neighbourhood(
+  const MeshGraph & G,
+  const int K,
+  const std::vector<int> & sources,
+  KHopNeighbourhood & N)
+{
+  const int ns = (int)sources.size();
+  std::vector<HopBFS> searches;
+  const auto prep = [&](const size_t nt){ searches.assign(nt,HopBFS(G)); };
+  const auto accum = [](const size_t){};
+
+  N.offsets.assign(ns+1,0);
+  igl::parallel_for(
+    ns,
+    prep,
+    [&](const int i, const size_t t)
+    {
+      int64_t count = 0;
+      searches[t].run(sources[i],K,[&](const int, const int){ count++; });
+      N.offsets[i+1] = count;
+    },
+    accum,
+    1000);
+  for(int i = 0;i<ns;i++) N.offsets[i+1] += N.offsets[i];
+
+  N.ids.resize(N.offsets[ns]);
+  N.hops.resize(N.offsets[ns]);
+  igl::parallel_for(
+    ns,
+    prep,
+    [&](const int i, const size_t t)
+    {
+      int64_t k = N.offsets[i];
+      searches[t].run(sources[i],K,[&](const int v, const int hop)
+      {
+        N.ids[k] = v;
+        N.hops[k] = (uint8_t)hop;
+        k++;
+      });
+    },
+    accum,
+    1000);
+}
+
+#endif
@@ -0,0 +1,175 @@
+// Compile with -I../gptoolbox/external/exactgeodesic/src
+#include <memory> // geodesic_memory.h uses std::auto_ptr
+#include <geodesic_algorithm_dijkstra_batch.h>
+#include <Eigen/Core>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+  MatrixXd V;
+  MatrixXi F;
+  VectorXi S,T;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=4,"nrhs should be >= 4");
+  parse_rhs_double(prhs,V);
+  parse_rhs_index(prhs+1,F);
+  parse_rhs_index(prhs+2,S);
+  parse_rhs_index(prhs+3,T);
+  mexErrMsgTxt(V.cols()==3,"V must be #V by 3");
+  mexErrMsgTxt(F.cols()==3,"F must be #F by 3");
+  mexErrMsgTxt(F.minCoeff()>=0 && F.maxCoeff()<V.rows(),"F must index V");
+  mexErrMsgTxt(S.size()==0 || (S.minCoeff()>=0 && S.maxCoeff()<V.rows()),"sources must index V");
+  mexErrMsgTxt(T.size()>0 && T.minCoeff()>=0 && T.maxCoeff()<V.rows(),"targets must index V");
+
+  enum PathMethod
+  {
+    PATH_METHOD_FORWARD = 0,
+    PATH_METHOD_REVERSE = 1
+  } method = PATH_METHOD_FORWARD;
+  bool unit = true;
+  {
+    int i = 4;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Method",name) == 0)
+      {
+        validate_arg_char(i,nrhs,prhs,name);
+        const char * type_name = mxArrayToString(prhs[++i]);
+        if(strcmp("forward",type_name)==0)
+        {
+          method = PATH_METHOD_FORWARD;
+        }else if(strcmp("reverse",type_name)==0)
+        {
+          method = PATH_METHOD_REVERSE;
+        }else
+        {
+          mexErrMsgTxt(false,C_STR("Unknown method: "<<type_name));
+        }
+      }else if(strcmp("Metric",name) == 0)
+      {
+        validate_arg_char(i,nrhs,prhs,name);
+        const char * type_name = mxArrayToString(prhs[++i]);
+        if(strcmp("hops",type_name)==0)
+        {
+          unit = true;
+        }else if(strcmp("euclidean",type_name)==0)
+        {
+          unit = false;
+        }else
+        {
+          mexErrMsgTxt(false,C_STR("Unknown metric: "<<type_name));
+        }
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+
+  std::vector<double> points(V.size());
+  for(int v = 0;v<V.rows();v++)
+  {
+    for(int c = 0;c<3;c++) points[3*v+c] = V(v,c);
+  }
+  std::vector<unsigned> faces(F.size());
+  for(int f = 0;f<F.rows();f++)
+  {
+    for(int c = 0;c<3;c++) faces[3*f+c] = F(f,c);
+  }
+  geodesic::Mesh mesh;
+  mesh.initialize_mesh_data(points,faces);
+  geodesic::GeodesicAlgorithmDijkstraBatch algorithm(&mesh,unit);
+
+  std::vector<unsigned> sources(S.data(),S.data()+S.size());
+  std::vector<unsigned> targets(T.data(),T.data()+T.size());
+  std::vector<unsigned> nearest;
+  std::vector<double> distances;
+  std::vector<std::vector<unsigned> > paths;
+  switch(method)
+  {
+    case PATH_METHOD_FORWARD:
+      algorithm.nearest_targets(sources,targets,nearest,distances,nlhs>2 ? &paths : NULL);
+      break;
+    case PATH_METHOD_REVERSE:
+      algorithm.propagate_from_targets(targets);
+      nearest.resize(sources.size());
+      distances.resize(sources.size());
+      if(nlhs>2) paths.resize(sources.size());
+      for(size_t s = 0;s<sources.size();s++)
+      {
+        const unsigned t = algorithm.nearest_target_of(sources[s],distances[s]);
+        nearest[s] = t==geodesic::GeodesicAlgorithmDijkstraBatch::NO_VERTEX ? t : targets[t];
+        if(nlhs>2) algorithm.trace_back(sources[s],paths[s]);
+      }
+      break;
+  }
+
+  switch(nlhs)
+  {
+    case 3:
+    {
+      plhs[2] = mxCreateCellMatrix(sources.size(),1);
+      for(size_t s = 0;s<sources.size();s++)
+      {
+        mxArray * p = mxCreateDoubleMatrix(1,paths[s].size(),mxREAL);
+        double * pd = mxGetPr(p);
+        for(size_t k = 0;k<paths[s].size();k++) pd[k] = paths[s][k]+1;
+        mxSetCell(plhs[2],s,p);
+      }
+    }
+    case 2:
+    {
+      plhs[1] = mxCreateDoubleMatrix(sources.size(),1,mxREAL);
+      double * d = mxGetPr(plhs[1]);
+      for(size_t s = 0;s<sources.size();s++)
+      {
+        d[s] = distances[s]<geodesic::GEODESIC_INF ? distances[s] : std::numeric_limits<double>::infinity();
+      }
+    }
+    case 1:
+    {
+      // unreachable sources get 0
+      plhs[0] = mxCreateDoubleMatrix(sources.size(),1,mxREAL);
+      double * n = mxGetPr(plhs[0]);
+      for(size_t s = 0;s<sources.size();s++)
+      {
+        n[s] = nearest[s]==geodesic::GeodesicAlgorithmDijkstraBatch::NO_VERTEX ? 0 : nearest[s]+1;
+      }
+    }
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
@@ -0,0 +1,30 @@
+% NEAREST_CORE_PATHS For each source vertex find the closest target vertex and
+% the shortest path to it along the edges of a mesh
+%
+% closest = nearest_core_paths(V,F,sources,targets)
+% [closest,D,paths] = nearest_core_paths(V,F,sources,targets,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   V  #V by 3 list of vertex positions
+%   F  #F by 3 list of triangle indices into V
+%   sources  #S list of source vertices (e.g. tips)
+%   targets  #T list of target vertices (e.g. core)
+%   Optional:
+%     'Method' followed by one of:
+%        {'forward'}  one Dijkstra per source, run in parallel, each stopping
+%          at the first target it reaches
+%        'reverse'  a single Dijkstra from all targets at once
+%     'Metric' followed by one of:
+%        {'hops'}  every edge has length 1 (as graph(triangulation2adjacency(F)))
+%        'euclidean'  edge lengths
+% Outputs:
+%   closest  #S list of closest targets, 0 if no target is reachable (an
+%     empty path, which grow_tip_regions accepts); equally close
+%     targets resolve to the lowest vertex id, as min(distances(...),[],2) over a
+%     sorted target list does
+%   D  #S list of distances to closest
+%   paths  #S cell of vertex lists from each source to its closest target
+%
+% Compile with the exactgeodesic sources on the include path:
+%   mex -I../gptoolbox/external/exactgeodesic/src nearest_core_paths.cpp ...
+%
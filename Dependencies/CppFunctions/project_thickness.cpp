@@ -0,0 +1,330 @@
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/parallel_for.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/parse_rhs.h>
+#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+
+// Static k-d tree over the rows of a #P by 3 matrix. Nodes split the widest
+// axis of their bounding box at the median; leaves hold up to LEAF_SIZE
+// points. Candidates are ordered by (squared distance, index) so equidistant
+// points always resolve to the lowest index, as dsearchn does.
+class KDTree
+{
+  public:
+    typedef std::pair<double,int> Candidate;
+    static const int LEAF_SIZE = 16;
+
+    explicit KDTree(const Eigen::MatrixXd & P) : P(P), order(P.rows())
+    {
+      for(int i = 0;i<(int)P.rows();i++) order[i] = i;
+      nodes.reserve(2*(P.rows()/LEAF_SIZE+1));
+      if(P.rows()>0) build(0,(int)P.rows());
+    }
+
+    // Nearest point to q; returns (squared distance, index)
+    Candidate nearest(const double * q) const
+    {
+      Candidate best(std::numeric_limits<double>::infinity(),-1);
+      nearest(0,q,best);
+      return best;
+    }
+
+    // k nearest points to q sorted by increasing distance
+    void knn(const double * q, const int k, std::vector<Candidate> & heap) const
+    {
+      heap.clear();
+      knn(0,q,k,heap);
+      std::sort_heap(heap.begin(),heap.end());
+    }
+
+    // All points within sqrt(r2) of q (unsorted)
+    void radius(const double * q, const double r2, std::vector<Candidate> & found) const
+    {
+      found.clear();
+      radius(0,q,r2,found);
+    }
+
+  private:
+    struct Node
+    {
+      int begin, end;
+      int left, right;
+      int axis;
+      double split;
+    };
+
+    const Eigen::MatrixXd & P;
+    std::vector<int> order;
+    std::vector<Node> nodes;
+
+    int build(const int begin, const int end)
+    {
+      const int id = (int)nodes.size();
+      nodes.push_back({begin,end,-1,-1,0,0});
+      if(end-begin <= LEAF_SIZE) return id;
+
+      Eigen::RowVector3d lo = P.row(order[begin]), hi = lo;
+      for(int i = begin+1;i<end;i++)
+      {
+        lo = lo.cwiseMin(P.row(order[i]));
+        hi = hi.cwiseMax(P.row(order[i]));
+      }
+      int axis;
+      (hi-lo).maxCoeff(&axis);
+      const int mid = begin+(end-begin)/2;
+      std::nth_element(order.begin()+begin,order.begin()+mid,order.begin()+end,
+        [&](const int a, const int b)
+        {
+          return P(a,axis)<P(b,axis) || (P(a,axis)==P(b,axis) && a<b);
+        });
+      const double split = P(order[mid],axis);
+      const int left = build(begin,mid);
+      const int right = build(mid,end);
+      nodes[id].left = left;
+      nodes[id].right = right;
+      nodes[id].axis = axis;
+      nodes[id].split = split;
+      return id;
+    }
+
+    double sqr_dist(const int i, const double * q) const
+    {
+      const double dx = P(i,0)-q[0], dy = P(i,1)-q[1], dz = P(i,2)-q[2];
+      return dx*dx+dy*dy+dz*dz;
+    }
+
+    void nearest(const int id, const double * q, Candidate & best) const
+    {
+      const Node & n = nodes[id];
+      if(n.left<0)
+      {
+        for(int i = n.begin;i<n.end;i++)
+        {
+          const Candidate c(sqr_dist(order[i],q),order[i]);
+          if(c<best) best = c;
+        }
+        return;
+      }
+      const double d = q[n.axis]-n.split;
+      const int near = d<0 ? n.left : n.right;
+      const int far = d<0 ? n.right : n.left;
+      nearest(near,q,best);
+      // <= so that a tie on the far side can still win on index
+      if(d*d<=best.first) nearest(far,q,best);
+    }
+
+    void knn(const int id, const double * q, const int k, std::vector<Candidate> & heap) const
+    {
+      const Node & n = nodes[id];
+      if(n.left<0)
+      {
+        for(int i = n.begin;i<n.end;i++)
+        {
+          const Candidate c(sqr_dist(order[i],q),order[i]);
+          if((int)heap.size()<k)
+          {
+            heap.push_back(c);
+            std::push_heap(heap.begin(),heap.end());
+          }else if(c<heap.front())
+          {
+            std::pop_heap(heap.begin(),heap.end());
+            heap.back() = c;
+            std::push_heap(heap.begin(),heap.end());
+          }
+        }
+        return;
+      }
+      const double d = q[n.axis]-n.split;
+      const int near = d<0 ? n.left : n.right;
+      const int far = d<0 ? n.right : n.left;
+      knn(near,q,k,heap);
+      if((int)heap.size()<k || d*d<=heap.front().first) knn(far,q,k,heap);
+    }
+
+    void radius(const int id, const double * q, const double r2, std::vector<Candidate> & found) const
+    {
+      const Node & n = nodes[id];
+      if(n.left<0)
+      {
+        for(int i = n.begin;i<n.end;i++)
+        {
+          const double d2 = sqr_dist(order[i],q);
+          if(d2<=r2) found.emplace_back(d2,order[i]);
+        }
+        return;
+      }
+      const double d = q[n.axis]-n.split;
+      radius(d<0 ? n.left : n.right,q,r2,found);
+      if(d*d<=r2) radius(d<0 ? n.right : n.left,q,r2,found);
+    }
+};
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+  using namespace Eigen;
+  MatrixXd P,T,Q;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=3,"nrhs should be >= 3");
+  parse_rhs_double(prhs,P);
+  parse_rhs_double(prhs+1,T);
+  parse_rhs_double(prhs+2,Q);
+  mexErrMsgTxt(P.cols()==3,"P must be #P by 3");
+  mexErrMsgTxt(P.rows()>0,"P must not be empty");
+  mexErrMsgTxt(T.rows()==P.rows(),"T must have one row per point in P");
+  mexErrMsgTxt(Q.cols()==3,"Q must be #Q by 3");
+
+  enum ProjectionMethod
+  {
+    PROJECTION_METHOD_NEAREST = 0,
+    PROJECTION_METHOD_KNN = 1,
+    PROJECTION_METHOD_RADIUS = 2
+  } method = PROJECTION_METHOD_NEAREST;
+  int k = 1;
+  double r = 0;
+  double sigma = -1;
+  {
+    int i = 3;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("K",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        k = (int)*mxGetPr(prhs[++i]);
+        mexErrMsgTxt(k>=1,"K should be >= 1");
+        method = k>1 ? PROJECTION_METHOD_KNN : PROJECTION_METHOD_NEAREST;
+      }else if(strcmp("Radius",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        r = *mxGetPr(prhs[++i]);
+        mexErrMsgTxt(r>0,"Radius should be > 0");
+        method = PROJECTION_METHOD_RADIUS;
+      }else if(strcmp("Sigma",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        sigma = *mxGetPr(prhs[++i]);
+        mexErrMsgTxt(sigma>0,"Sigma should be > 0");
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+  k = std::min<int>(k,P.rows());
+  if(sigma<0) sigma = r>0 ? 0.5*r : 1;
+
+  const KDTree tree(P);
+  // Point data is row major so each query touches contiguous memory
+  const Matrix<double,Dynamic,3,RowMajor> Qr = Q;
+  const int nq = Q.rows();
+  const int nk = method==PROJECTION_METHOD_KNN ? k : 1;
+  MatrixXd S = MatrixXd::Zero(nq,T.cols());
+  MatrixXd D(nq,nk);
+  MatrixXi I(nq,nk);
+
+  // One candidate buffer per thread
+  std::vector<std::vector<KDTree::Candidate> > buffers;
+  parallel_for(
+    nq,
+    [&](const size_t nt){ buffers.resize(nt); },
+    [&](const int q, const size_t t)
+    {
+      const double * x = Qr.data()+3*q;
+      std::vector<KDTree::Candidate> & found = buffers[t];
+      switch(method)
+      {
+        case PROJECTION_METHOD_NEAREST:
+        {
+          const KDTree::Candidate c = tree.nearest(x);
+          S.row(q) = T.row(c.second);
+          I(q,0) = c.second;
+          D(q,0) = sqrt(c.first);
+          break;
+        }
+        case PROJECTION_METHOD_KNN:
+        {
+          tree.knn(x,k,found);
+          for(int j = 0;j<k;j++)
+          {
+            S.row(q) += T.row(found[j].second);
+            I(q,j) = found[j].second;
+            D(q,j) = sqrt(found[j].first);
+          }
+          S.row(q) /= k;
+          break;
+        }
+        case PROJECTION_METHOD_RADIUS:
+        {
+          const KDTree::Candidate c = tree.nearest(x);
+          I(q,0) = c.second;
+          D(q,0) = sqrt(c.first);
+          tree.radius(x,r*r,found);
+          double wsum = 0;
+          for(const auto & f : found)
+          {
+            const double w = exp(-f.first/(2*sigma*sigma));
+            S.row(q) += w*T.row(f.second);
+            wsum += w;
+          }
+          if(wsum>0)
+          {
+            S.row(q) /= wsum;
+          }else
+          {
+            // Nothing (with weight) within the radius: use the nearest point
+            S.row(q) = T.row(c.second);
+          }
+          break;
+        }
+      }
+    },
+    [](const size_t){},
+    1000);
+
+  switch(nlhs)
+  {
+    case 3:
+      prepare_lhs_double(D,plhs+2);
+    case 2:
+      prepare_lhs_index(I,plhs+1);
+    case 1:
+      prepare_lhs_double(S,plhs+0);
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
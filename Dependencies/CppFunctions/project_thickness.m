@@ -0,0 +1,21 @@
+% PROJECT_THICKNESS Project values stored on skeleton points onto query points
+% (e.g. mesh vertices) using a parallel k-d tree over the skeleton points
+%
+% S = project_thickness(P,T,Q)
+% [S,I,D] = project_thickness(P,T,Q,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   P  #P by 3 list of skeleton point positions
+%   T  #P by c list of values per skeleton point (e.g. medial thickness)
+%   Q  #Q by 3 list of query positions
+%   Optional:
+%     'K' followed by number of nearest points to average {1}. K=1 returns
+%       the same indices as dsearchn(P,Q) (ties go to the lowest index)
+%     'Radius' followed by r: Gaussian weighted average of all points within
+%       r of each query; queries with no point within r use the nearest point
+%     'Sigma' followed by the standard deviation of the radius weights {r/2}
+% Outputs:
+%   S  #Q by c list of projected values
+%   I  #Q by K list of indices into P of nearest points (K=1 for 'Radius')
+%   D  #Q by K list of distances to those points
+%
@@ -0,0 +1,90 @@
+// Compile with -I../../Tools/OldSkeltools/include
+#include <streamingComponents.h>
+#include <cstring>
+#include <iostream>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/validate_arg.h>
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=1,"nrhs should be >= 1");
+  mexErrMsgTxt(mxIsLogical(prhs[0]) || mxIsUint8(prhs[0]),"BW should be logical or uint8");
+  mexErrMsgTxt(mxGetNumberOfDimensions(prhs[0])<=3,"BW should be a volume");
+  const mwSize * dims = mxGetDimensions(prhs[0]);
+  const std::array<std::size_t,3> size = {{
+    (std::size_t)dims[0],
+    (std::size_t)dims[1],
+    mxGetNumberOfDimensions(prhs[0])==3 ? (std::size_t)dims[2] : 1}};
+
+  ComponentFilterOptions options;
+  options.keepLargest = true;
+  {
+    int i = 1;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("MinSize",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        options.minSize = (uint64_t)*mxGetPr(prhs[++i]);
+        options.keepLargest = false;
+      }else if(strcmp("SlabDepth",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        options.slabDepth = (std::size_t)*mxGetPr(prhs[++i]);
+      }else if(strcmp("Threads",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        options.numThreads = (unsigned)*mxGetPr(prhs[++i]);
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+
+  plhs[0] = mxCreateNumericArray(
+    mxGetNumberOfDimensions(prhs[0]),dims,mxUINT8_CLASS,mxREAL);
+  uint8_t * out = (uint8_t*)mxGetData(plhs[0]);
+  const ComponentFilterStatistics statistics = mxIsLogical(prhs[0]) ?
+    removeSmallComponents((const mxLogical*)mxGetData(prhs[0]),out,size,options) :
+    removeSmallComponents((const uint8_t*)mxGetData(prhs[0]),out,size,options);
+
+  switch(nlhs)
+  {
+    case 3:
+      plhs[2] = mxCreateDoubleScalar(statistics.numKept);
+    case 2:
+      plhs[1] = mxCreateDoubleScalar(statistics.numComponents);
+    default:break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
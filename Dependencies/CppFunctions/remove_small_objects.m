@@ -0,0 +1,25 @@
+% REMOVE_SMALL_OBJECTS Remove small 26-connected objects from a binary volume
+% slab by slab, without building a label volume
+%
+% BW = remove_small_objects(BW)
+% [BW,numObjects,numKept] = remove_small_objects(BW,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   BW  #X by #Y by #Z logical or uint8 volume (non zero is foreground)
+%   Optional:
+%     'MinSize' followed by the number of voxels below which an object is
+%       removed {keep only the largest object}
+%     'SlabDepth' followed by the number of slices labelled at once by one
+%       thread {32}
+%     'Threads' followed by the number of threads {all cores}
+% Outputs:
+%   BW  #X by #Y by #Z uint8 volume, 1 on the kept objects
+%   numObjects  number of objects in the input
+%   numKept  number of objects kept
+%
+% Same result as removeSmallObjects(BW, MinSize) with binary output. Peak
+% memory is the input and output plus one 32-bit slab per thread.
+%
+% Compile with the skeltool headers on the include path:
+%   mex -I../../Tools/OldSkeltools/include remove_small_objects.cpp ...
+%
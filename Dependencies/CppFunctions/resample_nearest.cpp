@@ -0,0 +1,147 @@
+// Compile with -I../../Tools/OldSkeltools/include
+#include <resampleNearest.h>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#undef assert
+#define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
+
+#include <igl/matlab/MexStream.h>
+#include <igl/matlab/validate_arg.h>
+
+// Resamples V into a new array of class output_class
+template <typename TInput>
+mxArray * resample_array(
+  const mxArray * V,
+  const std::array<std::size_t,3> & in_size,
+  const std::array<double,3> & in_spacing,
+  const std::array<std::size_t,3> & out_size,
+  const std::array<double,3> & out_spacing,
+  const mxClassID output_class,
+  const unsigned num_threads)
+{
+  const mwSize dims[3] = {(mwSize)out_size[0],(mwSize)out_size[1],(mwSize)out_size[2]};
+  const TInput * in = (const TInput*)mxGetData(V);
+  mxArray * R = output_class==mxLOGICAL_CLASS ?
+    mxCreateLogicalArray(3,dims) : mxCreateNumericArray(3,dims,output_class,mxREAL);
+  switch(output_class)
+  {
+    case mxSINGLE_CLASS:
+      resampleNearest(in,in_size,in_spacing,(float*)mxGetData(R),out_size,out_spacing,
+        std::numeric_limits<float>::quiet_NaN(),num_threads);
+      break;
+    case mxDOUBLE_CLASS:
+      resampleNearest(in,in_size,in_spacing,(double*)mxGetData(R),out_size,out_spacing,
+        std::numeric_limits<double>::quiet_NaN(),num_threads);
+      break;
+    default:
+      // same class as the input; samples past the input are 0
+      resampleNearest(in,in_size,in_spacing,(TInput*)mxGetData(R),out_size,out_spacing,
+        TInput(0),num_threads);
+      break;
+  }
+  return R;
+}
+
+void mexFunction(
+         int          nlhs,
+         mxArray      *plhs[],
+         int          nrhs,
+         const mxArray *prhs[]
+         )
+{
+  using namespace std;
+  using namespace igl;
+  using namespace igl::matlab;
+
+  igl::matlab::MexStream mout;
+  std::streambuf *outbuf = std::cout.rdbuf(&mout);
+
+  mexErrMsgTxt(nrhs>=3,"nrhs should be >= 3");
+  mexErrMsgTxt(mxGetNumberOfDimensions(prhs[0])<=3,"V should be a volume");
+  const mxClassID input_class = mxGetClassID(prhs[0]);
+  mexErrMsgTxt(
+    input_class==mxLOGICAL_CLASS || input_class==mxUINT8_CLASS ||
+    input_class==mxSINGLE_CLASS || input_class==mxDOUBLE_CLASS,
+    "V should be logical, uint8, single or double");
+  mexErrMsgTxt(
+    mxIsDouble(prhs[1]) && mxGetNumberOfElements(prhs[1])==3 &&
+    mxIsDouble(prhs[2]) && mxGetNumberOfElements(prhs[2])==3,
+    "voxOriginal and voxInterp should have 3 entries");
+  const mwSize * dims = mxGetDimensions(prhs[0]);
+  const std::array<std::size_t,3> in_size = {{
+    (std::size_t)dims[0],
+    (std::size_t)dims[1],
+    mxGetNumberOfDimensions(prhs[0])==3 ? (std::size_t)dims[2] : 1}};
+  std::array<double,3> in_spacing, out_spacing;
+  for(int d = 0;d<3;d++)
+  {
+    in_spacing[d] = mxGetPr(prhs[1])[d];
+    out_spacing[d] = mxGetPr(prhs[2])[d];
+    mexErrMsgTxt(in_spacing[d]>0 && out_spacing[d]>0,"voxel dimensions should be positive");
+  }
+
+  mxClassID output_class = mxSINGLE_CLASS;
+  unsigned num_threads = 0;
+  {
+    int i = 3;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Class",name) == 0)
+      {
+        validate_arg_char(i,nrhs,prhs,name);
+        const char * type_name = mxArrayToString(prhs[++i]);
+        if(strcmp("single",type_name)==0)
+        {
+          output_class = mxSINGLE_CLASS;
+        }else if(strcmp("double",type_name)==0)
+        {
+          output_class = mxDOUBLE_CLASS;
+        }else if(strcmp("same",type_name)==0)
+        {
+          output_class = input_class;
+        }else
+        {
+          mexErrMsgTxt(false,C_STR("Unknown class: "<<type_name));
+        }
+      }else if(strcmp("Threads",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_double(i,nrhs,prhs,name);
+        num_threads = (unsigned)*mxGetPr(prhs[++i]);
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
+  }
+
+  const std::array<std::size_t,3> out_size = resampledSize(in_size,in_spacing,out_spacing);
+  switch(input_class)
+  {
+    case mxLOGICAL_CLASS:
+      plhs[0] = resample_array<mxLogical>(prhs[0],in_size,in_spacing,out_size,out_spacing,output_class,num_threads);
+      break;
+    case mxUINT8_CLASS:
+      plhs[0] = resample_array<uint8_t>(prhs[0],in_size,in_spacing,out_size,out_spacing,output_class,num_threads);
+      break;
+    case mxSINGLE_CLASS:
+      plhs[0] = resample_array<float>(prhs[0],in_size,in_spacing,out_size,out_spacing,output_class,num_threads);
+      break;
+    default:
+      plhs[0] = resample_array<double>(prhs[0],in_size,in_spacing,out_size,out_spacing,output_class,num_threads);
+      break;
+  }
+
+  // Restore the std stream buffer Important!
+  std::cout.rdbuf(outbuf);
+  return;
+}
@@ -0,0 +1,23 @@
+% RESAMPLE_NEAREST Nearest neighbour resampling of a volume to new voxel
+% dimensions, without coordinate arrays
+%
+% R = resample_nearest(V,voxOriginal,voxInterp)
+% R = resample_nearest(V,voxOriginal,voxInterp,'ParameterName',ParameterValue, ...)
+%
+% Inputs:
+%   V  #X by #Y by #Z logical, uint8, single or double volume
+%   voxOriginal  3 voxel dimensions of V (along its 1st, 2nd, 3rd dimension)
+%   voxInterp  3 voxel dimensions of R
+%   Optional:
+%     'Class' followed by one of:
+%        {'single'}  NaN past the last voxel of V, as resampleVoxelDimensions
+%        'double'  as 'single'
+%        'same'  class of V, 0 past the last voxel of V
+%     'Threads' followed by the number of threads {all cores}
+% Outputs:
+%   R  ceil((size(V)-1).*voxOriginal./voxInterp)+1 volume
+%
+% Same result as interp3(..., 'nearest') on the meshgrid coordinates of
+% resampleVoxelDimensions: each axis has its own nearest index map and the
+% output slices are filled in parallel.
+%
@@ -0,0 +1,78 @@
+#ifndef VERTEX_FRONTIER_H
+#define VERTEX_FRONTIER_H
+// One hop expansion of a vertex set over a mesh graph, and breadth first
+// dilation built from it. Shared by the parts clean up mex functions; nothing
+// here depends on MATLAB.
+#include "mesh_graph.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Sets are a stamp per vertex, so expanding touches only the set and its
+// neighbours, never all vertices.
+class VertexFrontier
+{
+  public:
+    explicit VertexFrontier(const MeshGraph & G) : G(&G), stamp(G.num_vertices(),0), current(0) {}
+
+    // Starts a new set containing vertices
+    void start(const std::vector<int> & vertices)
+    {
+      if(++current==0)
+      {
+        // stamp wrapped around
+        std::fill(stamp.begin(),stamp.end(),0);
+        current = 1;
+      }
+      for(const int v : vertices) stamp[v] = current;
+    }
+
+    bool contains(const int v) const { return stamp[v]==current; }
+
+    // Outputs:
+    //   next  the neighbours of front that are not in the set and for which
+    //     accept(v) holds, each once, in order of discovery. They are added
+    //     to the set.
+    template <typename Accept>
+    void expand(const std::vector<int> & front, Accept && accept, std::vector<int> & next)
+    {
+      next.clear();
+      for(const int u : front)
+      {
+        for(int64_t k = G->offsets[u];k<G->offsets[u+1];k++)
+        {
+          const int v = G->neighbours[k];
+          if(stamp[v]==current || !accept(v)) continue;
+          stamp[v] = current;
+          next.push_back(v);
+        }
+      }
+    }
+
+    // Breadth first dilation of seeds through the vertices for which
+    // accept(v) holds; calls visit(v,hop) for every vertex reached (not the
+    // seeds) and returns the number of hops taken.
+    template <typename Accept, typename Visit>
+    int dilate(const std::vector<int> & seeds, Accept && accept, Visit && visit)
+    {
+      start(seeds);
+      std::vector<int> front = seeds, next;
+      int hop = 0;
+      while(!front.empty())
+      {
+        expand(front,accept,next);
+        if(next.empty()) break;
+        hop++;
+        for(const int v : next) visit(v,hop);
+        front.swap(next);
+      }
+      return hop;
+    }
+
+  private:
+    const MeshGraph * G;
+    std::vector<uint32_t> stamp;
+    uint32_t current;
+};
+
+#endif
@@ -2,6 +2,24 @@ function [regionList, coreIDs, unclassIDs, expansionIDs, constrictionIDs, unvisi
     % Initialize map object
     regionList = containers.Map('KeyType','int32', 'ValueType','any');
     
+    if exist('label_components', 'file') == 3
+        % all labels in one pass; region ids are numbered in the same order
+        % as the listefy calls below
+        [~, assigned, regionSizes, regionVals] = label_components(mesh.faces, vertexPartType, 'Order', [0.1, 0.25, 0.5, 1, 0, 10]);
+        [sortedRegions, vertexOrder] = sort(assigned);
+        regionVertices = mat2cell(vertexOrder(sortedRegions > 0), regionSizes, 1);
+        for i = 1:length(regionSizes)
+            regionList(i) = regionVertices{i};
+        end
+        coreIDs = find(regionVals == 0.1)';
+        unclassIDs = find(regionVals == 0.25)';
+        expansionIDs = find(regionVals == 0.5)';
+        constrictionIDs = find(regionVals == 1)';
+        unvisitedIDs = find(regionVals == 0)';
+        someIDs = find(regionVals == 10)';
+        return;
+    end
+
     regionId = 1;
     assigned = zeros(size(mesh.vertices, 1), 1); 
     
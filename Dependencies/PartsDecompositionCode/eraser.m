@@ -22,14 +22,19 @@
 % Example:
 %   c = eraser(g, c, 2, 50);  % Removes all regions labeled 2 with fewer than 50 nodes
 function c = eraser(g, c, val, size)
-    reg = find(c == val); 
-    sg = subgraph(g, reg); 
-    [cc, sz] = conncomp(sg);
-    
-    smallRegions = find(sz<size); 
+    if exist('label_components', 'file') == 3
+        [c, ~, ~, ~, ~, numErased] = label_components(adjacency(g), c, 'Erase', val, 'MinSize', size);
+    else
+        reg = find(c == val); 
+        sg = subgraph(g, reg); 
+        [cc, sz] = conncomp(sg);
+        
+        smallRegions = find(sz<size); 
 
-    for erase = smallRegions 
-        c(reg(cc==erase)) = 0; 
+        for erase = smallRegions 
+            c(reg(cc==erase)) = 0; 
+        end
+        numErased = length(smallRegions);
     end
 
     if val == 0 
@@ -46,6 +51,6 @@ function c = eraser(g, c, val, size)
         regionName = "Unknown";
     end
 
-    fprintf('Deleted %d %s regions\n', length(smallRegions), regionName);
+    fprintf('Deleted %d %s regions\n', numErased, regionName);
 end
 
@@ -27,22 +27,28 @@ function [cleanedVertexPartType, vertexDeletedSmall] = runPartsCleanUp(mesh, mes
     avoidVertices = vertexPartType ~= 0 | allThinnessVals(:, 3) > thinnessThresh;
 
 
-    % while core can be expanded
-    while sum(isCoreVertex) > 0
-        % expand core front by one hop
-        isCoreVertex = (max(oneHopNeighbourhood(:, isCoreVertex), [], 2));
-
-        % do not include already visited core vertices
-        isCoreVertex(visitedCoreVertices) = 0;
-
-        % do not include assigned and thin vertices
-        isCoreVertex(avoidVertices) = 0;
-
-        % label remaining vertices as cores
-        vertexPartType(isCoreVertex) = coreVal;
-
-        % updated visited core vertices
-        visitedCoreVertices(isCoreVertex) = true;
+    if exist('dilate_label', 'file') == 3
+        % grow core breadth first from its boundary instead of sweeping the
+        % whole one hop matrix once per hop
+        vertexPartType = dilate_label(mesh.faces, vertexPartType, coreVal, avoidVertices);
+    else
+        % while core can be expanded
+        while sum(isCoreVertex) > 0
+            % expand core front by one hop
+            isCoreVertex = (max(oneHopNeighbourhood(:, isCoreVertex), [], 2));
+
+            % do not include already visited core vertices
+            isCoreVertex(visitedCoreVertices) = 0;
+
+            % do not include assigned and thin vertices
+            isCoreVertex(avoidVertices) = 0;
+
+            % label remaining vertices as cores
+            vertexPartType(isCoreVertex) = coreVal;
+
+            % updated visited core vertices
+            visitedCoreVertices(isCoreVertex) = true;
+        end
     end
 
     % for each type --> label vertex as unassigned (0) if it belongs to a
@@ -50,107 +56,127 @@ function [cleanedVertexPartType, vertexDeletedSmall] = runPartsCleanUp(mesh, mes
     % threshold
     disp("Labelling small connected components as unassigned!")
 
-    vertexPartType = eraser(meshGraph, vertexPartType, coreVal, 50);
-    vertexPartType = eraser(meshGraph, vertexPartType, unclassVal, 50);
-    vertexPartType = eraser(meshGraph, vertexPartType, expansionVal, 50);
-    vertexPartType = eraser(meshGraph, vertexPartType, constrictionVal, 50);
+    if exist('label_components', 'file') == 3
+        % erase the small components of all four types in one pass
+        eraseVals = [coreVal, unclassVal, expansionVal, constrictionVal];
+        eraseNames = ["Core", "Unclassified", "Expansion", "Constriction"];
+        [vertexPartType, ~, ~, ~, ~, numErased] = label_components(mesh.faces, vertexPartType, 'Erase', eraseVals, 'MinSize', 50);
+        for i = 1:length(eraseVals)
+            fprintf('Deleted %d %s regions\n', numErased(i), eraseNames(i));
+        end
+    else
+        vertexPartType = eraser(meshGraph, vertexPartType, coreVal, 50);
+        vertexPartType = eraser(meshGraph, vertexPartType, unclassVal, 50);
+        vertexPartType = eraser(meshGraph, vertexPartType, expansionVal, 50);
+        vertexPartType = eraser(meshGraph, vertexPartType, constrictionVal, 50);
+    end
 
     vertexDeletedSmall = vertexPartType;
-    %% STEP 5: CREATE REGION LIST MAP (key = coisCoreVertexected component ID [integer], value = array of vertex indices within given coisCoreVertexected component)
-    % Note: xxxIDs variables are used to index regionList map
-    [regionList, ~, unclassIDs, ~, ~, unvisitedIDs, ~] = buildRegionList(mesh, meshGraph, vertexPartType);
-
-    %% STEP 6: FINAL CLEAN UP STEP
-    % Obtain vertex indices for expansions and constrictions
-    expansionVertexIdx = find(vertexPartType==expansionVal);
-    constrictionVertexIdx = find(vertexPartType==constrictionVal);
-
-    % Obtain unsmoothed thinness values
-    thinnessVals = allThinnessVals(:,1);
-
-    % Compute average thickness for each part
-    expansionAvgThickness = mean(thinnessVals(expansionVertexIdx));
-    constrictionAvgThickness = mean(thinnessVals(constrictionVertexIdx));
-
-    % Obtain all unlabelled region indices
-    unlabelledRegionIDs = [unclassIDs, unvisitedIDs];
-
-    % Counter to keep track of changes
-    gulpCount = 0;
-    newExp = 0;
-    newCons = 0;
-    newCores = 0;
-
-    % For each unlabelled region --> assign label
-    for i = 1:length(unlabelledRegionIDs)
-
-        % Obtain vertex idx for current region
-        curRegionVertexIdx = regionList(unlabelledRegionIDs(i));
-
-        % Get 1-hop neighbors of current region
-        neighborIdx = find(any(oneHopNeighbourhood(:, curRegionVertexIdx), 2))';
-        neighborIdx = setdiff(neighborIdx, curRegionVertexIdx);  % Exclude current region's own vertices
-
-        neighborVals = vertexPartType(neighborIdx);
-        neighborVals = neighborVals(neighborVals > 0);  % Remove unlabelled (zero) values
-        uniqueNeighbourVals = unique(neighborVals);
-
-        % If current region is small and has neighbours with assigned values
-        if length(curRegionVertexIdx) < smallSize && ~isempty(neighborVals)
-            % If all neighbours are same part type --> assign this region
-            % that part type
-            if numel(uniqueNeighbourVals) == 1
-                vertexPartType(curRegionVertexIdx) = uniqueNeighbourVals;
-                gulpCount = gulpCount + 1;
-                continue;  % Skip to next region
-
-            % If neighbours are different part types --> assign this region
-            % the part type that the majority of the neighbours are
-            elseif numel(uniqueNeighbourVals) > 1
-                % Initialize counter variables
-                mostFreqTypes = [];
-                maxTypeCounter = -inf;
-
-                % For each neighbour value --> count how many occurences
-                % there are and update variables above
-                for j = 1:length(uniqueNeighbourVals)
-                    % Count occurences
-                    curNumNeighbours = nnz(neighborVals == uniqueNeighbourVals(j));
-
-                    % If the most frequent --> update variables
-                    if curNumNeighbours >= maxTypeCounter
-                        mostFreqTypes = [mostFreqTypes , uniqueNeighbourVals(j)];
-                        maxTypeCounter = curNumNeighbours;
-                    end
-                end
-
-                % If there is one type with the most occurences --> assign
-                % this region that type
-                if length(mostFreqTypes) == 1
-                    vertexPartType(curRegionVertexIdx) = mostFreqTypes(1);
+    if exist('gulp_regions', 'file') == 3 && exist('label_components', 'file') == 3
+        % STEP 5+6: REGION IDS AND FINAL CLEAN UP
+        % region ids numbered as buildRegionList does; each unlabelled region
+        % only visits its own one hop boundary
+        [~, regionOf, ~, regionVals] = label_components(mesh.faces, vertexPartType, 'Order', [coreVal, unclassVal, expansionVal, constrictionVal, 0, 10]);
+        unlabelledRegionIDs = [find(regionVals == unclassVal)', find(regionVals == 0)'];
+        vertexPartType = gulp_regions(mesh.faces, vertexPartType, regionOf, unlabelledRegionIDs, allThinnessVals(:,1), ...
+            'SmallSize', smallSize, 'Expansion', expansionVal, 'Constriction', constrictionVal);
+    else
+        %% STEP 5: CREATE REGION LIST MAP (key = coisCoreVertexected component ID [integer], value = array of vertex indices within given coisCoreVertexected component)
+        % Note: xxxIDs variables are used to index regionList map
+        [regionList, ~, unclassIDs, ~, ~, unvisitedIDs, ~] = buildRegionList(mesh, meshGraph, vertexPartType);
+
+        %% STEP 6: FINAL CLEAN UP STEP
+        % Obtain vertex indices for expansions and constrictions
+        expansionVertexIdx = find(vertexPartType==expansionVal);
+        constrictionVertexIdx = find(vertexPartType==constrictionVal);
+
+        % Obtain unsmoothed thinness values
+        thinnessVals = allThinnessVals(:,1);
+
+        % Compute average thickness for each part
+        expansionAvgThickness = mean(thinnessVals(expansionVertexIdx));
+        constrictionAvgThickness = mean(thinnessVals(constrictionVertexIdx));
+
+        % Obtain all unlabelled region indices
+        unlabelledRegionIDs = [unclassIDs, unvisitedIDs];
+
+        % Counter to keep track of changes
+        gulpCount = 0;
+        newExp = 0;
+        newCons = 0;
+        newCores = 0;
+
+        % For each unlabelled region --> assign label
+        for i = 1:length(unlabelledRegionIDs)
+
+            % Obtain vertex idx for current region
+            curRegionVertexIdx = regionList(unlabelledRegionIDs(i));
+
+            % Get 1-hop neighbors of current region
+            neighborIdx = find(any(oneHopNeighbourhood(:, curRegionVertexIdx), 2))';
+            neighborIdx = setdiff(neighborIdx, curRegionVertexIdx);  % Exclude current region's own vertices
+
+            neighborVals = vertexPartType(neighborIdx);
+            neighborVals = neighborVals(neighborVals > 0);  % Remove unlabelled (zero) values
+            uniqueNeighbourVals = unique(neighborVals);
+
+            % If current region is small and has neighbours with assigned values
+            if length(curRegionVertexIdx) < smallSize && ~isempty(neighborVals)
+                % If all neighbours are same part type --> assign this region
+                % that part type
+                if numel(uniqueNeighbourVals) == 1
+                    vertexPartType(curRegionVertexIdx) = uniqueNeighbourVals;
                     gulpCount = gulpCount + 1;
                     continue;  % Skip to next region
+
+                % If neighbours are different part types --> assign this region
+                % the part type that the majority of the neighbours are
+                elseif numel(uniqueNeighbourVals) > 1
+                    % Initialize counter variables
+                    mostFreqTypes = [];
+                    maxTypeCounter = -inf;
+
+                    % For each neighbour value --> count how many occurences
+                    % there are and update variables above
+                    for j = 1:length(uniqueNeighbourVals)
+                        % Count occurences
+                        curNumNeighbours = nnz(neighborVals == uniqueNeighbourVals(j));
+
+                        % If the most frequent --> update variables
+                        if curNumNeighbours >= maxTypeCounter
+                            mostFreqTypes = [mostFreqTypes , uniqueNeighbourVals(j)];
+                            maxTypeCounter = curNumNeighbours;
+                        end
+                    end
+
+                    % If there is one type with the most occurences --> assign
+                    % this region that type
+                    if length(mostFreqTypes) == 1
+                        vertexPartType(curRegionVertexIdx) = mostFreqTypes(1);
+                        gulpCount = gulpCount + 1;
+                        continue;  % Skip to next region
+                    end
                 end
             end
-        end
 
-        % Else --> let average thickness determine type
-        curAvgThickness = mean(thinnessVals(curRegionVertexIdx));
+            % Else --> let average thickness determine type
+            curAvgThickness = mean(thinnessVals(curRegionVertexIdx));
 
-        % If curAvgThickness closer to expansionAvgThickness --> label region expansion
-        if abs(curAvgThickness - expansionAvgThickness) < abs(curAvgThickness - constrictionAvgThickness)
-            vertexPartType(curRegionVertexIdx) = expansionVal;
-            newExp = newExp + 1;
+            % If curAvgThickness closer to expansionAvgThickness --> label region expansion
+            if abs(curAvgThickness - expansionAvgThickness) < abs(curAvgThickness - constrictionAvgThickness)
+                vertexPartType(curRegionVertexIdx) = expansionVal;
+                newExp = newExp + 1;
 
-        % If curAvgThickness closer to constrictionAvgThickness --> label region constriction
-        elseif abs(curAvgThickness - expansionAvgThickness) > abs(curAvgThickness - constrictionAvgThickness)
-            vertexPartType(curRegionVertexIdx) = constrictionVal;
-            newCons = newCons + 1;
+            % If curAvgThickness closer to constrictionAvgThickness --> label region constriction
+            elseif abs(curAvgThickness - expansionAvgThickness) > abs(curAvgThickness - constrictionAvgThickness)
+                vertexPartType(curRegionVertexIdx) = constrictionVal;
+                newCons = newCons + 1;
 
-        % If curAvgThickness right in between the two averages --> keep region unlabelled
-        else
-            disp("can't decide label keep unlabelled")
-            continue;
+            % If curAvgThickness right in between the two averages --> keep region unlabelled
+            else
+                disp("can't decide label keep unlabelled")
+                continue;
+            end
         end
     end
 
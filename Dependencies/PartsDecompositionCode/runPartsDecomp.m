@@ -55,133 +55,162 @@ function vertexPartType = runPartsDecomp(mesh, allMScoreVals, allThinnessVals, s
     meshGraph=graph(triangulation2adjacency(mesh.faces, mesh.vertices));
 
     % find closest point in the core region from each tip point
-    dist=distances(meshGraph, candsM, core); 
-    [~, idx]=min(dist, [], 2); 
-    closest=core(idx); 
-
-    % preallocate memory for output variables 
-    cMin=zeros(length(candsM), length(mScoreVals));  % min M value reached for entire growing region at each step
-    cMean=zeros(length(candsM), length(mScoreVals)); % mean M value reached for entire growing region
-    minMstep = zeros(150, length(candsM));      % min M value in growing front at each step
-    meanMStep = zeros(150, length(candsM));     % mean M value in growing front at each step
-
-    cTMin=zeros(length(candsM), length(mScoreVals)); % min M value reached for entire growing region
-    cTMean=zeros(length(candsM), length(mScoreVals));% mean M value reached for entire growing region
-    meanTStep = zeros(150, length(candsM));     % mean T value in growing front at each step
-
-    % initialize region growth array; keeps track at which step (if any) each
-    % node of the mesh has been reached from each starting point
-    N=zeros(length(candsM), length(mScoreVals));
-
-    % build adjacency matrix ("1-hop neighbourhood") for each node
-    sz=size(mesh.vertices, 1);
-    NN=sparse(sourceNodes(hopCounts<=1), targetNodes(hopCounts<=1), true, sz, sz);
-
-    % run region growing independently for each tip point
-    tic
-    for i=1:length(candsM)
-
-        t=tic; % some time keeping. not really necessary but it's nice to seee the progress
-
-        % initialize region arrays
-        nn=NN(candsM(i), :);    % nn contains nodes in the "current" front of the growing region 
-                                % initially the growing front and the region are
-                                % identical with the starting point
-        nn=(max(NN(:, nn), [], 2));
-        s=find(nn);             % s contains all nodes that have previously been assigned to the region
-
-
-        MM=min(mScoreVals(s));   % min M in the region
-        MT=min(thinnessVals(s));   % mint T in the region
-
-        % add step 1 values to output variables (see above for desciption of each
-        % output array) 
-        cMin(i, nn)=MM;
-        cMean(i, nn) = mean(mScoreVals(nn)); 
-        meanMStep(1, i) = mean(mScoreVals(nn)); 
-        minMstep(1, i) = MM;
-
-        cTMin(i, nn)=MT;
-        cTMean(i, nn) = mean(thinnessVals(nn)); 
-        meanTStep(1, i) = mean(thinnessVals(nn)); 
-
-        % the starting point has been reached in 1 step (technically it should be
-        % zero, but zero is currently assigned to unassigned nodes (could be changed to -1 or NaN 
-        N(i, nn) = 1;
-        counter=1; 
-
-        % compute shortest path along the mesh from starting point to closest point
-        % in the "core" region
-        path=shortestpath(meshGraph, candsM(i), closest(i)); 
-
-        while ~isempty(nn)  % continue growing as long as a new growing front can be found 
-
-            counter=counter+1;
+    if exist('nearest_core_paths', 'file') == 3
+        % one Dijkstra from all core vertices instead of a dense tips x core
+        % distance matrix; also returns each tip's path to its closest core
+        [closest, ~, tipPaths] = nearest_core_paths(mesh.vertices, mesh.faces, candsM, core, 'Method', 'reverse');
+    else
+        dist=distances(meshGraph, candsM, core); 
+        [~, idx]=min(dist, [], 2); 
+        closest=core(idx); 
+        tipPaths = {};
+    end
 
-            % advance running front (i had tested many different ways of doing
-            % this. this sparse matrix opreation was thee most efficient method I
-            % could find. 
+    % the mex grows all tips in parallel and only returns the visited
+    % (tip, vertex, step) records instead of dense tips x vertices arrays
+    useTipMex = exist('grow_tip_regions', 'file') == 3;
+    if useTipMex
+        tic
+        if isempty(tipPaths)
+            [visits, ~, ~, ~, meanTStep] = grow_tip_regions(mesh.faces, candsM, closest, mScoreVals, thinnessVals);
+        else
+            [visits, ~, ~, ~, meanTStep] = grow_tip_regions(mesh.faces, candsM, closest, mScoreVals, thinnessVals, 'Paths', tipPaths);
+        end
+        numTips = length(candsM);
+        toc
+    else
+        % preallocate memory for output variables 
+        cMin=zeros(length(candsM), length(mScoreVals));  % min M value reached for entire growing region at each step
+        cMean=zeros(length(candsM), length(mScoreVals)); % mean M value reached for entire growing region
+        minMstep = zeros(150, length(candsM));      % min M value in growing front at each step
+        meanMStep = zeros(150, length(candsM));     % mean M value in growing front at each step
+
+        cTMin=zeros(length(candsM), length(mScoreVals)); % min M value reached for entire growing region
+        cTMean=zeros(length(candsM), length(mScoreVals));% mean M value reached for entire growing region
+        meanTStep = zeros(150, length(candsM));     % mean T value in growing front at each step
+
+        % initialize region growth array; keeps track at which step (if any) each
+        % node of the mesh has been reached from each starting point
+        N=zeros(length(candsM), length(mScoreVals));
+
+        % build adjacency matrix ("1-hop neighbourhood") for each node
+        sz=size(mesh.vertices, 1);
+        NN=sparse(sourceNodes(hopCounts<=1), targetNodes(hopCounts<=1), true, sz, sz);
+
+        % run region growing independently for each tip point
+        tic
+        for i=1:length(candsM)
+
+            t=tic; % some time keeping. not really necessary but it's nice to seee the progress
+
+            % initialize region arrays
+            nn=NN(candsM(i), :);    % nn contains nodes in the "current" front of the growing region 
+                                    % initially the growing front and the region are
+                                    % identical with the starting point
             nn=(max(NN(:, nn), [], 2));
-            % 1 step neighbours from the "last" growing front include 1 step
-            % "forward" and "backwards" 
-            % remove nodes that have already been assigned to the region (s) from
-            % new growing front (nn). i.e. delete backtracked nodes
-            nn(s)=0; 
-
-            % converet from sparse to id array
-            nn=find(nn);
-
-            % build the subgraph of all nodes in the current growing front (from
-            % mesh graph)
-            % find all connected components
-            sg=subgraph(meshGraph, nn); 
-            [cc, ~]=conncomp(sg); 
-
-            % find the connected component which contains the node on the shortest
-            % path to the core
-            % this connected component will become the new growing front
-            % nodes that are not connected to the shortes path will be discarded
-            % ("side arms")
-            %
-            % if the growing front does not contain any node on the shortest path
-            % the "core" has been reached and the region growing process is
-            % terminated
-            mem=find(ismember(nn, path), 1);
-
-            if(~isempty(mem))
-                % retain only nodes connected to the "path2
-                sel=cc==(cc(mem));
-                nn=nn(sel);
-
-                % add nodes in the growing fron to the assigned region
-                s=union(s, nn);
-
-                % update min/mean values
-                MM=min(mScoreVals(s));
-                MT=min(thinnessVals(s));
-
-                % add values for thee current step (i)   to the output arrays
-                N(i, nn)=counter;
-                cMin(i, nn)=MM;
-                cMean(i, nn)=mean(mScoreVals(nn));
-
-                minMstep(counter, i) = MM; 
-                meanMStep(counter, i) = mean(mScoreVals(nn));        
-
-                cTMin(i, nn)=MT;
-                cTMean(i, nn) = mean(thinnessVals(nn)); 
-                meanTStep(counter, i) = mean(thinnessVals(nn)); 
-
+            s=find(nn);             % s contains all nodes that have previously been assigned to the region
+
+
+            MM=min(mScoreVals(s));   % min M in the region
+            MT=min(thinnessVals(s));   % mint T in the region
+
+            % add step 1 values to output variables (see above for desciption of each
+            % output array) 
+            cMin(i, nn)=MM;
+            cMean(i, nn) = mean(mScoreVals(nn)); 
+            meanMStep(1, i) = mean(mScoreVals(nn)); 
+            minMstep(1, i) = MM;
+
+            cTMin(i, nn)=MT;
+            cTMean(i, nn) = mean(thinnessVals(nn)); 
+            meanTStep(1, i) = mean(thinnessVals(nn)); 
+
+            % the starting point has been reached in 1 step (technically it should be
+            % zero, but zero is currently assigned to unassigned nodes (could be changed to -1 or NaN 
+            N(i, nn) = 1;
+            counter=1; 
+
+            % compute shortest path along the mesh from starting point to closest point
+            % in the "core" region
+            if closest(i) == 0
+                % nearest_core_paths found no core connected to this tip
+                path=[];
+            elseif isempty(tipPaths)
+                path=shortestpath(meshGraph, candsM(i), closest(i)); 
             else
-                nn=[]; % an empty growing front will terminate the region growth loop 
+                path=tipPaths{i};
             end
 
-        end
+            while ~isempty(nn)  % continue growing as long as a new growing front can be found 
+
+                counter=counter+1;
+
+                % advance running front (i had tested many different ways of doing
+                % this. this sparse matrix opreation was thee most efficient method I
+                % could find. 
+                nn=(max(NN(:, nn), [], 2));
+                % 1 step neighbours from the "last" growing front include 1 step
+                % "forward" and "backwards" 
+                % remove nodes that have already been assigned to the region (s) from
+                % new growing front (nn). i.e. delete backtracked nodes
+                nn(s)=0; 
+
+                % converet from sparse to id array
+                nn=find(nn);
+
+                % build the subgraph of all nodes in the current growing front (from
+                % mesh graph)
+                % find all connected components
+                sg=subgraph(meshGraph, nn); 
+                [cc, ~]=conncomp(sg); 
+
+                % find the connected component which contains the node on the shortest
+                % path to the core
+                % this connected component will become the new growing front
+                % nodes that are not connected to the shortes path will be discarded
+                % ("side arms")
+                %
+                % if the growing front does not contain any node on the shortest path
+                % the "core" has been reached and the region growing process is
+                % terminated
+                mem=find(ismember(nn, path), 1);
+
+                if(~isempty(mem))
+                    % retain only nodes connected to the "path2
+                    sel=cc==(cc(mem));
+                    nn=nn(sel);
+
+                    % add nodes in the growing fron to the assigned region
+                    s=union(s, nn);
+
+                    % update min/mean values
+                    MM=min(mScoreVals(s));
+                    MT=min(thinnessVals(s));
+
+                    % add values for thee current step (i)   to the output arrays
+                    N(i, nn)=counter;
+                    cMin(i, nn)=MM;
+                    cMean(i, nn)=mean(mScoreVals(nn));
+
+                    minMstep(counter, i) = MM; 
+                    meanMStep(counter, i) = mean(mScoreVals(nn));        
+
+                    cTMin(i, nn)=MT;
+                    cTMean(i, nn) = mean(thinnessVals(nn)); 
+                    meanTStep(counter, i) = mean(thinnessVals(nn)); 
+
+                else
+                    nn=[]; % an empty growing front will terminate the region growth loop 
+                end
+
+            end
 
-        % Print how long current tip to core flow ran for
-        fprintf('Tip #%d ran for %d iterations in %f seconds \n', i, counter, toc(t));
+            % Print how long current tip to core flow ran for
+            fprintf('Tip #%d ran for %d iterations in %f seconds \n', i, counter, toc(t));
+        end
+        toc
+        numTips = size(cTMean, 1);
     end
-    toc
     
     %% STEP 3: NOT REALLY SURE WHAT THIS DOES
     
@@ -209,7 +238,6 @@ function vertexPartType = runPartsDecomp(mesh, allMScoreVals, allThinnessVals, s
     
     
     d2Seg = sign(d2Arr); 
-    col = cTMean';
     
     mesh.vertices = mesh.vertices - mean(mesh.vertices); 
     
@@ -262,39 +290,59 @@ function vertexPartType = runPartsDecomp(mesh, allMScoreVals, allThinnessVals, s
             
     end
     
-    colSegCorr = zeros(size(cTMean, 2), size(cTMean, 1)); 
+    if useTipMex
+        % segment value of each visit from its tip and step (steps past the
+        % analysed range get no segment)
+        inRange = double(visits(:, 3)) <= size(segCorr, 1);
+        visitSeg = zeros(size(visits, 1), 1);
+        visitSeg(inRange) = segCorr(sub2ind(size(segCorr), double(visits(inRange, 3)), double(visits(inRange, 1))));
+        visitVertex = double(visits(:, 2));
+        numVertices = size(mesh.vertices, 1);
+
+        colProt = false(numVertices, 1);
+        colProt(visitVertex(visitSeg == -1)) = true;
+        colBulb = false(numVertices, 1);
+        colBulb(visitVertex(visitSeg == 1)) = true;
+        colCore = false(numVertices, 1);
+        colCore(visitVertex(visitSeg == 0.5)) = true;
+        colProt(core) = false;
+        colBulb(core) = false;
+        colCore(core) = false;
+    else
+        colSegCorr = zeros(length(mScoreVals), numTips); 
     
-    for i = 1:size(col, 2)  
-        neg=find(segCorr(:, i) == -1); 
-        for k = neg'
-            colSegCorr(N(i, :)==k, i) = 1; 
-        end
+        for i = 1:numTips  
+            neg=find(segCorr(:, i) == -1); 
+            for k = neg'
+                colSegCorr(N(i, :)==k, i) = 1; 
+            end
         
-        pos=find(segCorr(:, i) == 1); 
-        for k = pos'
-            colSegCorr(N(i, :)==k, i) = 0.5; 
-        end
+            pos=find(segCorr(:, i) == 1); 
+            for k = pos'
+                colSegCorr(N(i, :)==k, i) = 0.5; 
+            end
         
-        coreSegment=find(segCorr(:, i) == 0.5); 
-        for k = coreSegment'
-            colSegCorr(N(i, :)==k, i) = 0.25; 
+            coreSegment=find(segCorr(:, i) == 0.5); 
+            for k = coreSegment'
+                colSegCorr(N(i, :)==k, i) = 0.25; 
+            end
         end
-    end
-    %
+        %
     
-    if any(core)
-        colSegCorr(core, :) = 0.1;
-    end
+        if any(core)
+            colSegCorr(core, :) = 0.1;
+        end
     
-    %
-    colProt = colSegCorr == 1; 
-    colProt = max(colProt, [], 2); 
+        %
+        colProt = colSegCorr == 1; 
+        colProt = max(colProt, [], 2); 
     
-    colBulb = colSegCorr == 0.5; 
-    colBulb = max(colBulb, [], 2); 
+        colBulb = colSegCorr == 0.5; 
+        colBulb = max(colBulb, [], 2); 
     
-    colCore = colSegCorr == 0.25; 
-    colCore = max(colCore, [], 2); 
+        colCore = colSegCorr == 0.25; 
+        colCore = max(colCore, [], 2); 
+    end
     
     vertexPartType = double(colProt); 
     vertexPartType(colBulb) = 0.5;
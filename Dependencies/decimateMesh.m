@@ -10,7 +10,12 @@ function decimatedMesh = decimateMesh(mesh, keepPercentage)
     %
     % ------------- BEGIN CODE --------------
 
-    [mesh.vertices, mesh.faces] = decimate_libigl(mesh.vertices, mesh.faces, keepPercentage);
+    if exist('decimate_blocks','file') == 3
+        % same edge collapses, blocks decimated in parallel then the seams
+        [mesh.vertices, mesh.faces] = decimate_blocks(mesh.vertices, mesh.faces, keepPercentage);
+    else
+        [mesh.vertices, mesh.faces] = decimate_libigl(mesh.vertices, mesh.faces, keepPercentage);
+    end
     decimatedMesh = isoSwitch(mesh);
     
     % ------------- END OF CODE --------------
@@ -0,0 +1,281 @@
+#ifndef GEODESIC_ALGORITHM_DIJKSTRA_BATCH_010506
+#define GEODESIC_ALGORITHM_DIJKSTRA_BATCH_010506
+
+#include "geodesic_mesh.h"
+#include "geodesic_mesh_elements.h"
+#include "geodesic_constants_and_simple_functions.h"
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <assert.h>
+
+namespace geodesic{
+
+//Dijkstra on the vertex-edge graph of the mesh (same graph as GeodesicAlgorithmDijkstra)
+//for many sources at once. The mesh is only read; the state of a single search lives in
+//a DijkstraBatchWorkspace, so that searches for different sources can run in parallel.
+class DijkstraBatchWorkspace
+{
+public:
+	DijkstraBatchWorkspace(unsigned num_vertices = 0):
+		m_distance(num_vertices, GEODESIC_INF),
+		m_previous(num_vertices, NO_VERTEX),
+		m_stamp(num_vertices, 0),
+		m_current(0)
+	{};
+
+	static const unsigned NO_VERTEX = unsigned(-1);
+
+	void start()		//forget the previous search without touching every vertex
+	{
+		if(++m_current == 0)
+		{
+			std::fill(m_stamp.begin(), m_stamp.end(), 0);
+			m_current = 1;
+		}
+		m_queue.clear();
+	}
+
+	double distance(unsigned v){return m_stamp[v] == m_current ? m_distance[v] : GEODESIC_INF;};
+	unsigned previous(unsigned v){return m_stamp[v] == m_current ? m_previous[v] : NO_VERTEX;};
+
+	void set(unsigned v, double d, unsigned previous)
+	{
+		m_stamp[v] = m_current;
+		m_distance[v] = d;
+		m_previous[v] = previous;
+	}
+
+	typedef std::pair<double, unsigned> queue_entry;		//(distance, vertex id); ties go to the lower id
+	std::vector<queue_entry> m_queue;						//binary min-heap with lazy deletion
+
+private:
+	std::vector<double> m_distance;
+	std::vector<unsigned> m_previous;
+	std::vector<unsigned> m_stamp;
+	unsigned m_current;
+};
+
+class GeodesicAlgorithmDijkstraBatch
+{
+public:
+	static const unsigned NO_VERTEX = DijkstraBatchWorkspace::NO_VERTEX;
+
+	GeodesicAlgorithmDijkstraBatch(geodesic::Mesh* mesh,
+								   bool unit_edge_length = false):		//count edges instead of measuring them
+		m_mesh(mesh),
+		m_unit_edge_length(unit_edge_length)
+	{};
+
+	~GeodesicAlgorithmDijkstraBatch(){};
+
+	unsigned nearest_target(unsigned source,					//search from source until the closest vertex with is_target set is settled
+							std::vector<char>& is_target,
+							DijkstraBatchWorkspace& workspace,
+							double& distance,					//GEODESIC_INF and NO_VERTEX if no target is reachable
+							std::vector<unsigned>* path = NULL);	//source ... target
+
+	void nearest_targets(std::vector<unsigned>& sources,			//one early-stopping search per source, in parallel if OpenMP is enabled
+						 std::vector<unsigned>& targets,
+						 std::vector<unsigned>& nearest,
+						 std::vector<double>& distances,
+						 std::vector<std::vector<unsigned> >* paths = NULL);
+
+	void propagate_from_targets(std::vector<unsigned>& targets);	//single multi-source search from all targets; answers
+																	//nearest_target_of()/trace_back() for every vertex
+
+	unsigned nearest_target_of(unsigned v, double& distance)		//index into targets of the closest target, after propagate_from_targets
+	{
+		distance = m_workspace.distance(v);
+		return distance < GEODESIC_INF ? m_target_index[v] : NO_VERTEX;
+	}
+
+	void trace_back(unsigned v, std::vector<unsigned>& path);		//v ... closest target, after propagate_from_targets
+
+	geodesic::Mesh* mesh(){return m_mesh;};
+
+private:
+	double edge_length(edge_pointer e)
+	{
+		return m_unit_edge_length ? 1.0 : e->length();
+	}
+
+	template<class Relax, class Settled>
+	void run(DijkstraBatchWorkspace& w, Relax relax, Settled settled);
+
+	geodesic::Mesh* m_mesh;
+	bool m_unit_edge_length;
+
+	DijkstraBatchWorkspace m_workspace;			//state of propagate_from_targets
+	std::vector<unsigned> m_target_index;
+};
+
+//pops vertices in (distance, id) order; relax(u, v, d) is called for every edge u-v with d the
+//distance of v through u; stops when settled(u) returns true
+template<class Relax, class Settled>
+inline void GeodesicAlgorithmDijkstraBatch::run(DijkstraBatchWorkspace& w,
+												Relax relax,
+												Settled settled)
+{
+	typedef DijkstraBatchWorkspace::queue_entry entry;
+	std::greater<entry> order;
+	while(!w.m_queue.empty())
+	{
+		std::pop_heap(w.m_queue.begin(), w.m_queue.end(), order);
+		entry top = w.m_queue.back();
+		w.m_queue.pop_back();
+		unsigned u = top.second;
+		if(top.first > w.distance(u))		//stale entry
+		{
+			continue;
+		}
+		if(settled(u))
+		{
+			return;
+		}
+
+		vertex_pointer vertex = &m_mesh->vertices()[u];
+		for(unsigned i=0; i<vertex->adjacent_edges().size(); ++i)
+		{
+			edge_pointer e = vertex->adjacent_edges()[i];
+			unsigned v = e->opposite_vertex(vertex)->id();
+			double d = top.first + edge_length(e);
+			if(relax(u, v, d))
+			{
+				w.m_queue.push_back(entry(d, v));
+				std::push_heap(w.m_queue.begin(), w.m_queue.end(), order);
+			}
+		}
+	}
+}
+
+inline unsigned GeodesicAlgorithmDijkstraBatch::nearest_target(unsigned source,
+															   std::vector<char>& is_target,
+															   DijkstraBatchWorkspace& w,
+															   double& distance,
+															   std::vector<unsigned>* path)
+{
+	w.start();
+	w.set(source, 0.0, NO_VERTEX);
+	w.m_queue.push_back(DijkstraBatchWorkspace::queue_entry(0.0, source));
+
+	unsigned found = NO_VERTEX;
+	run(w,
+		[&](unsigned u, unsigned v, double d)
+		{
+			if(d < w.distance(v))
+			{
+				w.set(v, d, u);
+				return true;
+			}
+			return false;
+		},
+		[&](unsigned u)
+		{
+			if(!is_target[u]) return false;
+			found = u;		//first target popped: closest, lowest id among equally close ones
+			return true;
+		});
+
+	distance = found == NO_VERTEX ? GEODESIC_INF : w.distance(found);
+	if(path)
+	{
+		path->clear();
+		for(unsigned v = found; v != NO_VERTEX; v = w.previous(v))
+		{
+			path->push_back(v);
+		}
+		std::reverse(path->begin(), path->end());
+	}
+	return found;
+}
+
+inline void GeodesicAlgorithmDijkstraBatch::nearest_targets(std::vector<unsigned>& sources,
+															std::vector<unsigned>& targets,
+															std::vector<unsigned>& nearest,
+															std::vector<double>& distances,
+															std::vector<std::vector<unsigned> >* paths)
+{
+	unsigned const num_vertices = m_mesh->vertices().size();
+	std::vector<char> is_target(num_vertices, 0);
+	for(unsigned i=0; i<targets.size(); ++i)
+	{
+		is_target[targets[i]] = 1;
+	}
+
+	int const num_sources = sources.size();
+	nearest.resize(num_sources);
+	distances.resize(num_sources);
+	if(paths)
+	{
+		paths->resize(num_sources);
+	}
+
+	#pragma omp parallel
+	{
+		DijkstraBatchWorkspace workspace(num_vertices);		//one per thread, reused for all its sources
+		#pragma omp for schedule(dynamic)
+		for(int i=0; i<num_sources; ++i)
+		{
+			nearest[i] = nearest_target(sources[i],
+										is_target,
+										workspace,
+										distances[i],
+										paths ? &(*paths)[i] : NULL);
+		}
+	}
+}
+
+inline void GeodesicAlgorithmDijkstraBatch::propagate_from_targets(std::vector<unsigned>& targets)
+{
+	unsigned const num_vertices = m_mesh->vertices().size();
+	m_workspace = DijkstraBatchWorkspace(num_vertices);
+	m_target_index.assign(num_vertices, NO_VERTEX);
+
+	DijkstraBatchWorkspace& w = m_workspace;
+	w.start();
+	for(unsigned i=0; i<targets.size(); ++i)
+	{
+		unsigned t = targets[i];
+		if(w.distance(t) == 0.0)		//repeated target: keep the first
+		{
+			continue;
+		}
+		w.set(t, 0.0, NO_VERTEX);
+		m_target_index[t] = i;
+		w.m_queue.push_back(DijkstraBatchWorkspace::queue_entry(0.0, t));
+	}
+	std::make_heap(w.m_queue.begin(), w.m_queue.end(), std::greater<DijkstraBatchWorkspace::queue_entry>());
+
+	run(w,
+		[&](unsigned u, unsigned v, double d)
+		{
+			double current = w.distance(v);		//equally close targets: keep the lower id, as nearest_target does
+			if(d < current || (d == current && targets[m_target_index[u]] < targets[m_target_index[v]]))
+			{
+				w.set(v, d, u);
+				m_target_index[v] = m_target_index[u];
+				return d < current;
+			}
+			return false;
+		},
+		[](unsigned){return false;});
+}
+
+inline void GeodesicAlgorithmDijkstraBatch::trace_back(unsigned v, std::vector<unsigned>& path)
+{
+	path.clear();
+	if(m_workspace.distance(v) >= GEODESIC_INF)
+	{
+		return;
+	}
+	for(; v != NO_VERTEX; v = m_workspace.previous(v))
+	{
+		path.push_back(v);
+	}
+}
+
+}		//geodesic
+
+#endif //GEODESIC_ALGORITHM_DIJKSTRA_BATCH_010506
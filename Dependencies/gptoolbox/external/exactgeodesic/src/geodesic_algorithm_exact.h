@@ -5,10 +5,10 @@
 #include "geodesic_memory.h"
 #include "geodesic_algorithm_base.h"
 #include "geodesic_algorithm_exact_elements.h"
+#include "geodesic_interval_queue.h"
 #include <vector>
 #include <cmath>
 #include <assert.h>
-#include <set>
 
 namespace geodesic{
 
@@ -43,9 +43,20 @@ public:
 
 	void print_statistics();
 
-private:
-	typedef std::set<interval_pointer, Interval> IntervalQueue;
+	void set_memory_limit(std::size_t bytes)		//0 for none. Propagation stops, as if it reached its maximum
+	{												//distance, once the intervals need more; the blocks of the
+		m_memory_allocator.set_memory_limit(bytes);	//intervals are kept from one propagation to the next
+	};
+
+	bool memory_limit_reached(){return m_memory_allocator.limit_reached();};		//by the last propagation
+
+	double propagation_distance_stopped(){return m_propagation_distance_stopped;};	//distances up to it are final
+
+	unsigned peak_intervals(){return m_memory_allocator.peak_in_use();};
 
+	std::size_t interval_memory(){return m_memory_allocator.reserved_bytes();};
+
+private:
 	void update_list_and_queue(list_pointer list,
 							   IntervalWithStop* candidates,	//up to two candidates
 							   unsigned num_candidates);
@@ -90,10 +101,11 @@ private:
 	{
 		m_memory_allocator.clear();
 		m_queue.clear();
-		for(unsigned i=0; i<m_edge_interval_lists.size(); ++i)
-		{
-			m_edge_interval_lists[i].clear();
+		for(unsigned i=0; i<m_used_lists.size(); ++i)		//only the lists the last propagation reached,
+		{													//so that short propagations cost no pass over the mesh
+			m_used_lists[i]->clear();
 		}
+		m_used_lists.clear();
 		m_propagation_distance_stopped = GEODESIC_INF;
 	};
 
@@ -125,10 +137,11 @@ private:
 
 	bool erase_from_queue(interval_pointer p);
 
-	IntervalQueue m_queue;	//interval queue
+	IntervalQueue m_queue;	//interval queue (geodesic_interval_queue.h)
 
 	MemoryAllocator<Interval> m_memory_allocator;			//quickly allocate and deallocate intervals 
 	std::vector<IntervalList> m_edge_interval_lists;		//every edge has its interval data 
+	std::vector<list_pointer> m_used_lists;					//non-empty lists, emptied by clear()
 
 	enum MapType {OLD, NEW};		//used for interval intersection
 	MapType map[5];		
@@ -315,15 +328,7 @@ inline bool GeodesicAlgorithmExact::erase_from_queue(interval_pointer p)
 {
 	if(p->min() < GEODESIC_INF/10.0)// && p->min >= queue->begin()->first)
 	{
-		assert(m_queue.count(p)<=1);			//the set is unique
-
-		IntervalQueue::iterator it = m_queue.find(p);
-
-		if(it != m_queue.end())
-		{
-			m_queue.erase(it);
-			return true;
-		}
+		return m_queue.erase(p);
 	}
 
 	return false;
@@ -545,7 +550,12 @@ inline void GeodesicAlgorithmExact::propagate(std::vector<SurfacePoint>& sources
 
 	while(!m_queue.empty())
 	{
-		m_queue_max_size = std::max((unsigned int)m_queue.size(), m_queue_max_size);
+		if(m_memory_allocator.limit_reached())		//out of budget: keep what is final
+		{
+			break;
+		}
+
+		m_queue_max_size = std::max(m_queue.size(), m_queue_max_size);
 
 		unsigned const check_period = 10;
     	if(++m_iterations % check_period == 0)		//check if we covered all required vertices
@@ -556,8 +566,8 @@ inline void GeodesicAlgorithmExact::propagate(std::vector<SurfacePoint>& sources
 			}
 		}
 
-		interval_pointer min_interval = *m_queue.begin();
-		m_queue.erase(m_queue.begin());
+		interval_pointer min_interval = m_queue.top();
+		m_queue.pop();
 		edge_pointer edge = min_interval->edge();
 		list_pointer list = interval_list(edge);
 
@@ -657,7 +667,7 @@ inline void GeodesicAlgorithmExact::propagate(std::vector<SurfacePoint>& sources
 		} 
 	} 
 
-	m_propagation_distance_stopped = m_queue.empty() ? GEODESIC_INF : (*m_queue.begin())->min();
+	m_propagation_distance_stopped = m_queue.empty() ? GEODESIC_INF : m_queue.top()->min();
 	clock_t stop = clock();
 	m_time_consumed = (static_cast<double>(stop)-static_cast<double>(start))/CLOCKS_PER_SEC;
 
@@ -678,7 +688,7 @@ inline void GeodesicAlgorithmExact::propagate(std::vector<SurfacePoint>& sources
 
 inline bool GeodesicAlgorithmExact::check_stop_conditions()
 {
-	double queue_distance = (*m_queue.begin())->min();
+	double queue_distance = m_queue.top()->min();
 	if(queue_distance > stop_distance())
 	{
 		return true;
@@ -713,6 +723,7 @@ inline void GeodesicAlgorithmExact::update_list_and_queue(list_pointer list,
 
 	if(list->first() == NULL) 
 	{
+		m_used_lists.push_back(list);
 		interval_pointer* p = &list->first();
 		IntervalWithStop* first;
 		IntervalWithStop* second; 
@@ -1370,6 +1381,14 @@ inline void GeodesicAlgorithmExact::print_statistics()
 			  << std::endl;
 	std::cout << "maximum interval queue size is " << m_queue_max_size << std::endl;
 	std::cout << "number of interval propagations is " << m_iterations << std::endl;
+	std::cout << "at most " << peak_intervals() << " intervals at once, in "
+			  << interval_memory()/1e6 << "Mb of interval blocks";
+	if(memory_limit_reached())
+	{
+		std::cout << "; the memory limit stopped propagation at distance "
+				  << m_propagation_distance_stopped;
+	}
+	std::cout << std::endl;
 }
 
 }		//geodesic
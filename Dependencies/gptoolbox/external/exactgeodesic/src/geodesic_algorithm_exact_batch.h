@@ -0,0 +1,187 @@
+#ifndef GEODESIC_ALGORITHM_EXACT_BATCH_010506
+#define GEODESIC_ALGORITHM_EXACT_BATCH_010506
+
+#include <cstring>		//memcpy, used but not included by geodesic_algorithm_exact.h
+#include "geodesic_mesh.h"
+#include "geodesic_algorithm_exact.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+namespace geodesic{
+
+//Exact geodesic distances from many independent source sets (for example one set per tip
+//vertex). The mesh is only read; every thread owns one GeodesicAlgorithmExact, and so one
+//interval allocator, reused for all the source sets it propagates, in parallel if OpenMP is enabled.
+class GeodesicAlgorithmExactBatch
+{
+public:
+	static const unsigned NO_SOURCE = unsigned(-1);
+
+	GeodesicAlgorithmExactBatch(geodesic::Mesh* mesh):
+		m_mesh(mesh),
+		m_memory_limit(0),
+		m_limited_sets(0)
+	{};
+
+	~GeodesicAlgorithmExactBatch(){};
+
+	void distances(std::vector<std::vector<SurfacePoint> >& source_sets,
+				   std::vector<double>& distances,		//num_vertices by num_sets, column major; GEODESIC_INF if not reached
+				   double max_propagation_distance = GEODESIC_INF);
+
+	void nearest_sources(std::vector<std::vector<SurfacePoint> >& source_sets,
+						 unsigned k,
+						 std::vector<unsigned>& nearest,		//num_vertices by k, column major: closest source sets first,
+						 std::vector<double>& distances,		//equally close ones by index; NO_SOURCE/GEODESIC_INF past the reached ones
+						 double max_propagation_distance = GEODESIC_INF);
+
+	geodesic::Mesh* mesh(){return m_mesh;};
+
+	void set_memory_limit(std::size_t bytes)		//interval memory of every thread, 0 for none; vertices that a set
+	{												//could not reach within it get GEODESIC_INF
+		m_memory_limit = bytes;
+	};
+
+	unsigned limited_sets(){return m_limited_sets;};		//sets stopped by the memory limit in the last call
+
+private:
+	//propagates every source set and calls column(state, set, distances of all vertices) from the
+	//thread that propagated it, state being that thread's copy of initial; merge(state) is called
+	//once per thread, one thread at a time, after its last set
+	template<class State, class Column, class Merge>
+	void run(std::vector<std::vector<SurfacePoint> >& source_sets,
+			 double max_propagation_distance,
+			 State const& initial,
+			 Column column,
+			 Merge merge);
+
+	geodesic::Mesh* m_mesh;
+	std::size_t m_memory_limit;
+	unsigned m_limited_sets;
+};
+
+template<class State, class Column, class Merge>
+inline void GeodesicAlgorithmExactBatch::run(std::vector<std::vector<SurfacePoint> >& source_sets,
+											 double max_propagation_distance,
+											 State const& initial,
+											 Column column,
+											 Merge merge)
+{
+	unsigned const num_vertices = m_mesh->vertices().size();
+	int const num_sets = source_sets.size();
+	unsigned limited_sets = 0;
+
+	#pragma omp parallel reduction(+:limited_sets)
+	{
+		GeodesicAlgorithmExact algorithm(m_mesh);		//one per thread, reused for all its source sets
+		algorithm.set_memory_limit(m_memory_limit);
+		State state(initial);
+		std::vector<double> d(num_vertices);
+		#pragma omp for schedule(dynamic)
+		for(int s=0; s<num_sets; ++s)
+		{
+			algorithm.propagate(source_sets[s], max_propagation_distance);
+			bool const limited = algorithm.memory_limit_reached();
+			double const final_distance = algorithm.propagation_distance_stopped();
+			limited_sets += limited;
+			for(unsigned v=0; v<num_vertices; ++v)
+			{
+				SurfacePoint point(&m_mesh->vertices()[v]);
+				algorithm.best_source(point, d[v]);
+				if(d[v] >= GEODESIC_INF/2.0 || (limited && d[v] > final_distance))		//not reached
+				{
+					d[v] = GEODESIC_INF;
+				}
+			}
+			column(state, s, d);
+		}
+		#pragma omp critical
+		merge(state);
+	}
+	m_limited_sets = limited_sets;
+}
+
+inline void GeodesicAlgorithmExactBatch::distances(std::vector<std::vector<SurfacePoint> >& source_sets,
+												   std::vector<double>& distances,
+												   double max_propagation_distance)
+{
+	unsigned const num_vertices = m_mesh->vertices().size();
+	distances.assign((std::size_t)num_vertices*source_sets.size(), GEODESIC_INF);
+	run(source_sets,
+		max_propagation_distance,
+		0,
+		[&](int, unsigned s, std::vector<double>& d)
+		{
+			std::copy(d.begin(), d.end(), distances.begin() + (std::size_t)s*num_vertices);
+		},
+		[](int){});
+}
+
+inline void GeodesicAlgorithmExactBatch::nearest_sources(std::vector<std::vector<SurfacePoint> >& source_sets,
+														 unsigned k,
+														 std::vector<unsigned>& nearest,
+														 std::vector<double>& distances,
+														 double max_propagation_distance)
+{
+	typedef std::pair<double, unsigned> entry;		//(distance, source set)
+	unsigned const num_vertices = m_mesh->vertices().size();
+	std::vector<entry> const none((std::size_t)num_vertices*k, entry(GEODESIC_INF, NO_SOURCE));
+	std::vector<entry> best(none);
+
+	//keeps the k smallest entries of a vertex in increasing order
+	auto insert = [k](entry* list, entry e)
+	{
+		if(!(e < list[k-1]))
+		{
+			return;
+		}
+		unsigned i = k-1;
+		for(; i>0 && e < list[i-1]; --i)
+		{
+			list[i] = list[i-1];
+		}
+		list[i] = e;
+	};
+
+	//every thread keeps the k nearest of the sets it propagated, merged at the end, so that only
+	//num_threads lists of num_vertices*k entries are held instead of all the distances
+	run(source_sets,
+		max_propagation_distance,
+		none,
+		[&](std::vector<entry>& mine, unsigned s, std::vector<double>& d)
+		{
+			for(unsigned v=0; v<num_vertices; ++v)
+			{
+				if(d[v] < GEODESIC_INF)
+				{
+					insert(&mine[(std::size_t)v*k], entry(d[v], s));
+				}
+			}
+		},
+		[&](std::vector<entry>& mine)
+		{
+			for(std::size_t i=0; i<mine.size(); ++i)
+			{
+				if(mine[i].second != NO_SOURCE)
+				{
+					insert(&best[i - i%k], mine[i]);
+				}
+			}
+		});
+
+	nearest.resize(best.size());
+	distances.resize(best.size());
+	for(unsigned v=0; v<num_vertices; ++v)
+	{
+		for(unsigned j=0; j<k; ++j)
+		{
+			nearest[(std::size_t)j*num_vertices + v] = best[(std::size_t)v*k + j].second;
+			distances[(std::size_t)j*num_vertices + v] = best[(std::size_t)v*k + j].first;
+		}
+	}
+}
+
+}		//geodesic
+
+#endif //GEODESIC_ALGORITHM_EXACT_BATCH_010506
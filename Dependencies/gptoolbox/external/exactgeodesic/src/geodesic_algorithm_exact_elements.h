@@ -133,6 +133,7 @@ public:
 	DirectionType& direction(){return m_direction;};
 	bool visible_from_source(){return m_direction == FROM_SOURCE;};
 	unsigned& source_index(){return m_source_index;};
+	unsigned& queue_position(){return m_queue_position;};
 
 	void initialize(edge_pointer edge, 
 					SurfacePoint* point = NULL, 
@@ -149,6 +150,7 @@ protected:
 	edge_pointer m_edge;				//edge that the interval belongs to
 	unsigned m_source_index;			//the source it belongs to
 	DirectionType m_direction;			//where the interval is coming from
+	unsigned m_queue_position;			//index in IntervalHeap, only valid while it is queued
 };
 
 struct IntervalWithStop : public Interval
@@ -0,0 +1,187 @@
+#ifndef GEODESIC_INTERVAL_QUEUE_010506
+#define GEODESIC_INTERVAL_QUEUE_010506
+
+#include "geodesic_algorithm_exact_elements.h"
+#include <vector>
+#include <set>
+#include <assert.h>
+
+namespace geodesic{
+
+//priority queue of the intervals of GeodesicAlgorithmExact, smallest Interval::min() first.
+//Define GEODESIC_INTERVAL_QUEUE_STD_SET to use the original std::set queue instead, e.g. to
+//compare results.
+
+//4-ary min-heap of interval pointers. Every interval stores its position in the heap, so that
+//erasing it, or inserting it again after its min() changed, costs one sift and no allocation.
+//The position is only trusted if the heap holds the interval there: intervals are copied with
+//memcpy and recycled by MemoryAllocator, so a stale position is expected.
+class IntervalHeap
+{
+public:
+	IntervalHeap(){};
+	~IntervalHeap(){};
+
+	bool empty(){return m_heap.empty();};
+	unsigned size(){return m_heap.size();};
+	void clear(){m_heap.clear();};
+
+	interval_pointer top()
+	{
+		assert(!m_heap.empty());
+		return m_heap[0];
+	};
+
+	void pop()
+	{
+		remove_at(0);
+	};
+
+	void insert(interval_pointer p)		//inserts p, or moves it to its new place if it is already queued
+	{
+		if(contains(p))
+		{
+			restore(p->queue_position());
+			return;
+		}
+		m_heap.push_back(p);
+		sift_up(m_heap.size()-1);
+	};
+
+	bool erase(interval_pointer p)		//returns false if p is not queued
+	{
+		if(!contains(p))
+		{
+			return false;
+		}
+		remove_at(p->queue_position());
+		return true;
+	};
+
+private:
+	static const unsigned ARITY = 4;
+
+	bool contains(interval_pointer p)
+	{
+		unsigned const i = p->queue_position();
+		return i < m_heap.size() && m_heap[i] == p;
+	};
+
+	void place(interval_pointer p, unsigned i)
+	{
+		m_heap[i] = p;
+		p->queue_position() = i;
+	};
+
+	void remove_at(unsigned i)
+	{
+		interval_pointer last = m_heap.back();
+		m_heap.pop_back();
+		if(i < m_heap.size())
+		{
+			place(last, i);
+			restore(i);
+		}
+	};
+
+	void restore(unsigned i)
+	{
+		if(i > 0 && m_less(m_heap[i], m_heap[(i-1)/ARITY]))
+		{
+			sift_up(i);
+		}
+		else
+		{
+			sift_down(i);
+		}
+	};
+
+	void sift_up(unsigned i)
+	{
+		interval_pointer p = m_heap[i];
+		while(i > 0)
+		{
+			unsigned const parent = (i-1)/ARITY;
+			if(!m_less(p, m_heap[parent]))
+			{
+				break;
+			}
+			place(m_heap[parent], i);
+			i = parent;
+		}
+		place(p, i);
+	};
+
+	void sift_down(unsigned i)
+	{
+		interval_pointer p = m_heap[i];
+		unsigned const n = m_heap.size();
+		while(true)
+		{
+			unsigned const first = ARITY*i + 1;
+			if(first >= n)
+			{
+				break;
+			}
+			unsigned const last = std::min(first + ARITY, n);
+			unsigned best = first;
+			for(unsigned c=first+1; c<last; ++c)
+			{
+				if(m_less(m_heap[c], m_heap[best]))
+				{
+					best = c;
+				}
+			}
+			if(!m_less(m_heap[best], p))
+			{
+				break;
+			}
+			place(m_heap[best], i);
+			i = best;
+		}
+		place(p, i);
+	};
+
+	std::vector<interval_pointer> m_heap;
+	Interval m_less;		//Interval::operator() orders the queue, as it does for the std::set
+};
+
+//the original queue: a red-black tree node per queued interval
+class IntervalSetQueue
+{
+public:
+	bool empty(){return m_set.empty();};
+	unsigned size(){return m_set.size();};
+	void clear(){m_set.clear();};
+
+	interval_pointer top(){return *m_set.begin();};
+	void pop(){m_set.erase(m_set.begin());};
+
+	void insert(interval_pointer p){m_set.insert(p);};
+
+	bool erase(interval_pointer p)
+	{
+		assert(m_set.count(p)<=1);			//the set is unique
+
+		std::set<interval_pointer, Interval>::iterator it = m_set.find(p);
+		if(it == m_set.end())
+		{
+			return false;
+		}
+		m_set.erase(it);
+		return true;
+	};
+
+private:
+	std::set<interval_pointer, Interval> m_set;
+};
+
+#ifdef GEODESIC_INTERVAL_QUEUE_STD_SET
+typedef IntervalSetQueue IntervalQueue;
+#else
+typedef IntervalHeap IntervalQueue;
+#endif
+
+}		//geodesic
+
+#endif //GEODESIC_INTERVAL_QUEUE_010506
@@ -5,6 +5,7 @@
 //two fast and simple memory allocators
 
 #include <vector>
+#include <cstddef>
 #include <assert.h>
 #include <math.h>
 
@@ -63,13 +64,15 @@ private:
 
 
 template<class T>		//quickly allocates and deallocates single elements of a given type
-class MemoryAllocator
+class MemoryAllocator		//clear() keeps the blocks (high-water mark), reset() releases them
 {
 public:
 	typedef T* pointer;
 
 	MemoryAllocator(unsigned block_size = 1024, 
-				    unsigned max_number_of_blocks = 1024)
+				    unsigned max_number_of_blocks = 1024):
+		m_memory_limit(0),
+		m_peak_in_use(0)
 	{
 		reset(block_size, 
 			  max_number_of_blocks);
@@ -77,10 +80,13 @@ public:
 
 	~MemoryAllocator(){};
 
-	void clear()
+	void clear()		//forget all elements, keeping the blocks for the next use
 	{
-		reset(m_block_size, 
-			  m_max_number_of_blocks);
+		m_current_block = 0;
+		m_current_position = 0;
+		m_deleted.clear();
+		m_in_use = 0;
+		m_limit_reached = false;
 	}
 
 	void reset(unsigned block_size, 
@@ -92,14 +98,12 @@ public:
 		assert(m_block_size > 0);
 		assert(m_max_number_of_blocks > 0);
 
-		m_current_position = 0;
-
 		m_storage.reserve(max_number_of_blocks);
 		m_storage.resize(1);
 		m_storage[0].resize(block_size);
 
-		m_deleted.clear();
 		m_deleted.reserve(2*block_size);
+		clear();
 	};
 
 	pointer allocate()		//allocates single unit of memory
@@ -109,11 +113,18 @@ public:
 		{
 			if(m_current_position + 1 >= m_block_size)
 			{
-				m_storage.push_back( std::vector<T>() );
-				m_storage.back().resize(m_block_size);
+				if(++m_current_block == m_storage.size())
+				{
+					if(m_memory_limit && reserved_bytes() + block_bytes() > m_memory_limit)
+					{
+						m_limit_reached = true;		//still allocated: the owner stops at its next check
+					}
+					m_storage.push_back( std::vector<T>() );
+					m_storage.back().resize(m_block_size);
+				}
 				m_current_position = 0;
 			}
-			result = & m_storage.back()[m_current_position];
+			result = & m_storage[m_current_block][m_current_position];
 			++m_current_position;
 		}
 		else
@@ -122,24 +133,54 @@ public:
 			m_deleted.pop_back();
 		}
 
+		if(++m_in_use > m_peak_in_use)
+		{
+			m_peak_in_use = m_in_use;
+		}
 		return result;
 	};
 
 	void deallocate(pointer p)		//allocate n units
 	{
+		--m_in_use;
 		if(m_deleted.size() < m_deleted.capacity())
 		{
 			m_deleted.push_back(p);
 		}
 	};
 
+	void set_memory_limit(std::size_t bytes)		//0 for none; blocks past it set limit_reached()
+	{
+		m_memory_limit = bytes;
+	};
+
+	bool limit_reached(){return m_limit_reached;};		//since the last clear()
+
+	unsigned peak_in_use(){return m_peak_in_use;};		//most elements ever allocated at once
+
+	std::size_t reserved_bytes()		//memory held by the blocks
+	{
+		return m_storage.size()*block_bytes();
+	};
+
 private:
+	std::size_t block_bytes()
+	{
+		return (std::size_t)m_block_size*sizeof(T);
+	};
+
 	std::vector<std::vector<T> > m_storage;
 	unsigned m_block_size;				//size of a single block
 	unsigned m_max_number_of_blocks;		//maximum allowed number of blocks
+	unsigned m_current_block;			//block being filled; the ones after it are kept from previous uses
 	unsigned m_current_position;			//first unused element inside the current block
 
 	std::vector<pointer> m_deleted;			//pointers to deleted elemets
+
+	std::size_t m_memory_limit;
+	bool m_limit_reached;
+	unsigned m_in_use;
+	unsigned m_peak_in_use;
 };
 
 
@@ -1,4 +1,6 @@
+#include "bvh_file.h"
 #include <igl/AABB.h>
+#include <igl/C_STR.h>
 #include <igl/matlab/MexStream.h>
 #include <igl/matlab/mexErrMsgTxt.h>
 #include <igl/matlab/prepare_lhs.h>
@@ -17,7 +19,8 @@ void parse_rhs(
   Eigen::MatrixXi & Ele,
   Eigen::MatrixXd & bb_mins,
   Eigen::MatrixXd & bb_maxs,
-  Eigen::VectorXi & elements)
+  Eigen::VectorXi & elements,
+  std::string & file)
 {
   using namespace std;
   using namespace igl;
@@ -29,9 +32,23 @@ void parse_rhs(
 
   parse_rhs_double(prhs,V);
   parse_rhs_index(prhs+1,Ele);
-  if(nrhs > 2)
   {
-    mexErrMsgTxt(nrhs == 2, "The number of input arguments must be 2.");
+    int i = 2;
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("File",name) == 0)
+      {
+        mexErrMsgTxt(i+1<nrhs && mxIsChar(prhs[i+1]),"File should be a path");
+        file = mxArrayToString(prhs[++i]);
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
+    }
   }
 }
 
@@ -52,7 +69,8 @@ void mexFunction(
   MatrixXi Ele;
   VectorXi elements;
   VectorXi I;
-  parse_rhs(nrhs,prhs,V,Ele,bb_mins,bb_maxs,elements);
+  std::string file;
+  parse_rhs(nrhs,prhs,V,Ele,bb_mins,bb_maxs,elements,file);
   bool was_serialized = bb_mins.size()>0;
 
   switch(V.cols())
@@ -75,6 +93,11 @@ void mexFunction(
       break;
     }
   }
+  if(!file.empty())
+  {
+    mexErrMsgTxt(write_bvh(file,V,Ele,bb_mins,bb_maxs,elements),
+      C_STR("Could not write "<<file));
+  }
 
   switch(nlhs)
   {
@@ -0,0 +1,345 @@
+#ifndef IGL_BVH_FILE_H
+#define IGL_BVH_FILE_H
+#include <Eigen/Core>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace igl
+{
+  // Flat (linear) bounding volume hierarchy file, written once per mesh and
+  // mapped read-only by any mex that needs an igl::AABB of the same mesh.
+  //
+  // Layout: one BVHFileHeader then num_nodes BVHFileNode in depth first
+  // order. The left child of an internal node is the next node, the right
+  // child is stored. Boxes are single precision, rounded outwards, so they
+  // still contain their elements and queries through them stay exact.
+  struct BVHFileHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t dim;
+    uint64_t num_nodes;
+    uint64_t num_vertices;
+    uint64_t num_elements;
+    uint32_t simplex_size;
+    uint32_t reserved;
+    // mesh_fingerprint of the (V,Ele) the tree was built for
+    uint64_t fingerprint;
+    uint64_t padding;
+  };
+  struct BVHFileNode
+  {
+    float min[3];
+    float max[3];
+    // index into Ele for leaves, -1 for internal nodes
+    int32_t element;
+    // index of the right child of internal nodes
+    int32_t right;
+  };
+  static_assert(sizeof(BVHFileHeader)==64,"BVH file header should be 64 bytes");
+  static_assert(sizeof(BVHFileNode)==32,"BVH file nodes should be 32 bytes");
+  static const char BVH_FILE_MAGIC[8] = {'G','P','T','B','V','H','\0','\0'};
+  static const uint32_t BVH_FILE_VERSION = 1;
+
+  // FNV-1a hash of the sizes and contents of V and Ele, to refuse a tree
+  // built for another mesh
+  template <typename DerivedV, typename DerivedEle>
+  uint64_t mesh_fingerprint(
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedEle> & Ele)
+  {
+    uint64_t h = 14695981039346656037ull;
+    const auto mix = [&h](const void * data, const size_t bytes)
+    {
+      const unsigned char * c = (const unsigned char *)data;
+      for(size_t b = 0;b<bytes;b++)
+      {
+        h ^= c[b];
+        h *= 1099511628211ull;
+      }
+    };
+    const int64_t sizes[4] = {V.rows(),V.cols(),Ele.rows(),Ele.cols()};
+    mix(sizes,sizeof(sizes));
+    for(int j = 0;j<V.cols();j++)
+    {
+      for(int i = 0;i<V.rows();i++)
+      {
+        const double v = V(i,j);
+        mix(&v,sizeof(v));
+      }
+    }
+    for(int j = 0;j<Ele.cols();j++)
+    {
+      for(int i = 0;i<Ele.rows();i++)
+      {
+        const int32_t e = Ele(i,j);
+        mix(&e,sizeof(e));
+      }
+    }
+    return h;
+  }
+
+  // Writes the serialization of an igl::AABB (as returned by
+  // AABB::serialize: node i has children 2i+1 and 2i+2) as a BVH file.
+  //
+  // Inputs:
+  //   path  file to write
+  //   V  #V by dim list of mesh vertex positions
+  //   Ele  #Ele by simplex size list of mesh indices into V
+  //   bb_mins  max_tree by dim list of bounding box min corner positions
+  //   bb_maxs  max_tree by dim list of bounding box max corner positions
+  //   elements  max_tree list of element or (not leaf id) indices into Ele
+  // Returns false if the file could not be written
+  template <typename DerivedV, typename DerivedEle>
+  bool write_bvh(
+    const std::string & path,
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedEle> & Ele,
+    const Eigen::MatrixXd & bb_mins,
+    const Eigen::MatrixXd & bb_maxs,
+    const Eigen::VectorXi & elements)
+  {
+    std::vector<BVHFileNode> nodes;
+    if(elements.size()>0)
+    {
+      // depth first, with a stack of heap indices and the node waiting for
+      // its right child
+      std::vector<std::pair<int64_t,int64_t> > stack(1,std::make_pair(0,-1));
+      while(!stack.empty())
+      {
+        const int64_t i = stack.back().first, parent = stack.back().second;
+        stack.pop_back();
+        if(parent>=0) nodes[parent].right = (int32_t)nodes.size();
+        BVHFileNode node;
+        for(int d = 0;d<3;d++)
+        {
+          const bool used = d<bb_mins.cols();
+          float lo = used ? (float)bb_mins(i,d) : 0.f;
+          float hi = used ? (float)bb_maxs(i,d) : 0.f;
+          if(used && lo>bb_mins(i,d)) lo = std::nextafter(lo,-std::numeric_limits<float>::infinity());
+          if(used && hi<bb_maxs(i,d)) hi = std::nextafter(hi,std::numeric_limits<float>::infinity());
+          node.min[d] = lo;
+          node.max[d] = hi;
+        }
+        node.element = elements(i);
+        node.right = -1;
+        const int64_t index = nodes.size();
+        nodes.push_back(node);
+        if(node.element==-1)
+        {
+          // right is pushed first so that the left child comes next
+          stack.emplace_back(2*i+2,index);
+          stack.emplace_back(2*i+1,-1);
+        }
+      }
+    }
+
+    BVHFileHeader header;
+    std::memset(&header,0,sizeof(header));
+    std::memcpy(header.magic,BVH_FILE_MAGIC,sizeof(header.magic));
+    header.version = BVH_FILE_VERSION;
+    header.dim = V.cols();
+    header.num_nodes = nodes.size();
+    header.num_vertices = V.rows();
+    header.num_elements = Ele.rows();
+    header.simplex_size = Ele.cols();
+    header.fingerprint = mesh_fingerprint(V,Ele);
+    std::ofstream file(path,std::ios::binary);
+    if(!file) return false;
+    file.write((const char *)&header,sizeof(header));
+    file.write((const char *)nodes.data(),nodes.size()*sizeof(BVHFileNode));
+    return (bool)file;
+  }
+
+  // Read-only mapping of a BVH file
+  class MappedBVH
+  {
+    public:
+      MappedBVH() {}
+      MappedBVH(const MappedBVH &) = delete;
+      MappedBVH & operator=(const MappedBVH &) = delete;
+      ~MappedBVH() { close(); }
+
+      // Returns false (with a reason in error) if path is not a BVH file
+      bool open(const std::string & path, std::string & error)
+      {
+        close();
+#ifndef _WIN32
+        const int fd = ::open(path.c_str(),O_RDONLY);
+        if(fd<0)
+        {
+          error = "Could not open "+path;
+          return false;
+        }
+        struct stat st;
+        if(fstat(fd,&st)==0 && st.st_size>0)
+        {
+          void * data = mmap(nullptr,st.st_size,PROT_READ,MAP_SHARED,fd,0);
+          if(data!=MAP_FAILED)
+          {
+            m_data = (const char *)data;
+            m_size = st.st_size;
+          }
+        }
+        ::close(fd);
+        if(!m_data)
+        {
+          error = "Could not map "+path;
+          return false;
+        }
+#else
+        std::ifstream file(path,std::ios::binary|std::ios::ate);
+        if(!file)
+        {
+          error = "Could not open "+path;
+          return false;
+        }
+        m_buffer.resize((size_t)file.tellg());
+        file.seekg(0);
+        file.read(m_buffer.data(),m_buffer.size());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#endif
+        if(m_size<sizeof(BVHFileHeader) ||
+          std::memcmp(header().magic,BVH_FILE_MAGIC,sizeof(BVH_FILE_MAGIC))!=0 ||
+          header().version!=BVH_FILE_VERSION ||
+          m_size<sizeof(BVHFileHeader)+header().num_nodes*sizeof(BVHFileNode))
+        {
+          error = path+" is not a BVH file";
+          close();
+          return false;
+        }
+        // Children and elements are used as indices: the right child of an
+        // internal node comes after its left child (the next node) and leaves
+        // index an element
+        const BVHFileNode * N = nodes();
+        const int64_t n = header().num_nodes;
+        for(int64_t k = 0;k<n;k++)
+        {
+          const bool valid = N[k].element==-1 ?
+            (k+1<n && N[k].right>k+1 && N[k].right<n) :
+            (N[k].element>=0 && (uint64_t)N[k].element<header().num_elements);
+          if(!valid)
+          {
+            error = path+" has a node out of range";
+            close();
+            return false;
+          }
+        }
+        return true;
+      }
+
+      void close()
+      {
+#ifndef _WIN32
+        if(m_data) munmap((void *)m_data,m_size);
+#else
+        std::vector<char>().swap(m_buffer);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+      }
+
+      const BVHFileHeader & header() const
+      {
+        return *(const BVHFileHeader *)m_data;
+      }
+      const BVHFileNode * nodes() const
+      {
+        return (const BVHFileNode *)(m_data+sizeof(BVHFileHeader));
+      }
+
+      // Whether the tree was built for (V,Ele)
+      template <typename DerivedV, typename DerivedEle>
+      bool matches(
+        const Eigen::MatrixBase<DerivedV> & V,
+        const Eigen::MatrixBase<DerivedEle> & Ele) const
+      {
+        return
+          header().dim==(uint32_t)V.cols() &&
+          header().num_vertices==(uint64_t)V.rows() &&
+          header().num_elements==(uint64_t)Ele.rows() &&
+          header().simplex_size==(uint32_t)Ele.cols() &&
+          header().fingerprint==mesh_fingerprint(V,Ele);
+      }
+
+      // Serialization accepted by igl::AABB::init(V,Ele,bb_mins,bb_maxs,
+      // elements), which rebuilds the tree without sorting any element
+      void serialize(
+        Eigen::MatrixXd & bb_mins,
+        Eigen::MatrixXd & bb_maxs,
+        Eigen::VectorXi & elements) const
+      {
+        const int dim = header().dim;
+        const BVHFileNode * N = nodes();
+        const int64_t n = header().num_nodes;
+        // heap index of every node
+        std::vector<int64_t> heap(n,0);
+        int64_t m = n>0 ? 1 : 0;
+        for(int64_t k = 0;k<n;k++)
+        {
+          if(N[k].element!=-1) continue;
+          heap[k+1] = 2*heap[k]+1;
+          heap[N[k].right] = 2*heap[k]+2;
+          m = std::max(m,heap[N[k].right]+1);
+        }
+        bb_mins.setZero(m,dim);
+        bb_maxs.setZero(m,dim);
+        elements.setConstant(m,1,-1);
+        for(int64_t k = 0;k<n;k++)
+        {
+          for(int d = 0;d<dim;d++)
+          {
+            bb_mins(heap[k],d) = N[k].min[d];
+            bb_maxs(heap[k],d) = N[k].max[d];
+          }
+          elements(heap[k]) = N[k].element;
+        }
+      }
+
+    private:
+      const char * m_data = nullptr;
+      size_t m_size = 0;
+#ifdef _WIN32
+      std::vector<char> m_buffer;
+#endif
+  };
+
+  // Loads the tree of path into tree, checking that it was built for
+  // (V,Ele). Returns false with a reason in error otherwise.
+  template <typename AABBType, typename DerivedV, typename DerivedEle>
+  bool read_bvh(
+    const std::string & path,
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedEle> & Ele,
+    AABBType & tree,
+    std::string & error)
+  {
+    MappedBVH bvh;
+    if(!bvh.open(path,error)) return false;
+    if(!bvh.matches(V,Ele))
+    {
+      error = path+" was built for another mesh";
+      return false;
+    }
+    Eigen::MatrixXd bb_mins,bb_maxs;
+    Eigen::VectorXi elements;
+    bvh.serialize(bb_mins,bb_maxs,elements);
+    tree.deinit();
+    tree.init(V.derived(),Ele.derived(),bb_mins,bb_maxs,elements);
+    return true;
+  }
+}
+
+#endif
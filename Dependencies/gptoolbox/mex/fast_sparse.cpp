@@ -1,14 +1,183 @@
-#include <Eigen/Core>
-#include <Eigen/Sparse>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <vector>
 #include <mex.h>
 #include <igl/C_STR.h>
 #include <igl/matlab/mexErrMsgTxt.h>
 #undef assert
 #define assert( isOK ) ( (isOK) ? (void)0 : (void) ::mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
 #include <igl/matlab/MexStream.h>
-#include <igl/matlab/parse_rhs.h>
-#include <igl/matlab/prepare_lhs.h>
+#include <igl/matlab/validate_arg.h>
+#include <igl/parallel_for.h>
+
+// Element access to a numeric or logical input of any class accepted for I,
+// J or V, so that int32 indices or single values are read in place instead
+// of being converted to double first
+struct NumericInput
+{
+  mxClassID id;
+  const void * data;
+  // 0 if every element reads as element 0 (a scalar V)
+  size_t stride;
+  NumericInput(const mxArray * A):
+    id(mxGetClassID(A)),data(mxGetData(A)),stride(mxGetNumberOfElements(A)==1?0:1){}
+  bool valid() const
+  {
+    switch(id)
+    {
+      case mxDOUBLE_CLASS:
+      case mxSINGLE_CLASS:
+      case mxINT32_CLASS:
+      case mxUINT32_CLASS:
+      case mxINT64_CLASS:
+      case mxUINT64_CLASS:
+      case mxLOGICAL_CLASS:
+        return true;
+      default:
+        return false;
+    }
+  }
+  double operator()(const size_t k) const
+  {
+    const size_t e = k*stride;
+    switch(id)
+    {
+      case mxDOUBLE_CLASS: return ((const double *)data)[e];
+      case mxSINGLE_CLASS: return ((const float *)data)[e];
+      case mxINT32_CLASS: return ((const int32_t *)data)[e];
+      case mxUINT32_CLASS: return ((const uint32_t *)data)[e];
+      case mxINT64_CLASS: return (double)((const int64_t *)data)[e];
+      case mxUINT64_CLASS: return (double)((const uint64_t *)data)[e];
+      case mxLOGICAL_CLASS: return ((const mxLogical *)data)[e];
+      default: return 0;
+    }
+  }
+};
+
+// Builds S = sparse(I,J,V,m,n) directly into MATLAB's compressed column
+// buffers: count the entries of every column, prefix sum, scatter the entry
+// indices in parallel, then sort every column by row (and by input order, so
+// that duplicates are summed in the same order whatever the threads did) and
+// sum duplicates. Entries summing to zero are dropped, as sparse does.
+//
+// Inputs:
+//   I  row indices (1-based)
+//   J  column indices (1-based)
+//   V  values, one per entry or a single one for all
+//   ne  number of entries
+//   m  number of rows
+//   n  number of columns
+//   logical  whether to return a logical matrix (true where the sum is not
+//     zero) instead of a double one
+// Returns the sparse matrix or NULL if an index is not an integer within
+// m by n.
+mxArray * fast_sparse_csc(
+  const NumericInput & I,
+  const NumericInput & J,
+  const NumericInput & V,
+  const size_t ne,
+  const size_t m,
+  const size_t n,
+  const bool logical)
+{
+  // Count per column
+  std::unique_ptr<std::atomic<size_t>[]> cursor(new std::atomic<size_t>[n+1]);
+  for(size_t j = 0;j<=n;j++) cursor[j] = 0;
+  std::atomic<bool> valid(true);
+  igl::parallel_for(
+    ne,
+    [&](const size_t k)
+    {
+      const double i = I(k), j = J(k);
+      if(!(i>=1 && i<=m && j>=1 && j<=n) || i!=std::floor(i) || j!=std::floor(j))
+      {
+        valid = false;
+        return;
+      }
+      cursor[(size_t)j].fetch_add(1,std::memory_order_relaxed);
+    },
+    100000);
+  if(!valid) return NULL;
+  // Column j's entries go to [start[j],start[j+1])
+  std::vector<size_t> start(n+1,0);
+  for(size_t j = 0;j<n;j++)
+  {
+    start[j+1] = start[j]+cursor[j+1];
+    cursor[j+1] = start[j];
+  }
+  // Scatter
+  std::vector<size_t> order(ne);
+  igl::parallel_for(
+    ne,
+    [&](const size_t k)
+    {
+      order[cursor[(size_t)J(k)].fetch_add(1,std::memory_order_relaxed)] = k;
+    },
+    100000);
+  cursor.reset();
+
+  // Sort every column, sum duplicates in place into the front of the
+  // column's range and count what is left
+  std::vector<size_t> nnz(n+1,0);
+  std::vector<double> sum(ne);
+  igl::parallel_for(
+    n,
+    [&](const size_t j)
+    {
+      const auto first = order.begin()+start[j];
+      const auto last = order.begin()+start[j+1];
+      std::sort(first,last,[&I](const size_t a, const size_t b)
+      {
+        const double ia = I(a), ib = I(b);
+        return ia<ib || (ia==ib && a<b);
+      });
+      size_t out = start[j];
+      for(size_t p = start[j];p<start[j+1];)
+      {
+        const size_t row = (size_t)I(order[p]);
+        double s = 0;
+        for(;p<start[j+1] && (size_t)I(order[p])==row;p++) s += V(order[p]);
+        if(s==0) continue;
+        order[out] = row-1;
+        sum[out] = s;
+        out++;
+      }
+      nnz[j+1] = out-start[j];
+    },
+    1000);
+
+  for(size_t j = 0;j<n;j++) nnz[j+1] += nnz[j];
+  mxArray * S = logical ?
+    mxCreateSparseLogicalMatrix(m,n,std::max<size_t>(nnz[n],1)) :
+    mxCreateSparse(m,n,std::max<size_t>(nnz[n],1),mxREAL);
+  mwIndex * Jc = mxGetJc(S);
+  mwIndex * Ir = mxGetIr(S);
+  for(size_t j = 0;j<=n;j++) Jc[j] = nnz[j];
+  double * Pr = logical ? NULL : mxGetPr(S);
+  mxLogical * Lr = logical ? mxGetLogicals(S) : NULL;
+  igl::parallel_for(
+    n,
+    [&](const size_t j)
+    {
+      for(size_t p = 0;p<nnz[j+1]-nnz[j];p++)
+      {
+        Ir[nnz[j]+p] = order[start[j]+p];
+        if(logical)
+        {
+          Lr[nnz[j]+p] = true;
+        }else
+        {
+          Pr[nnz[j]+p] = sum[start[j]+p];
+        }
+      }
+    },
+    1000);
+  return S;
+}
 
 void mexFunction(
          int          nlhs,
@@ -20,41 +189,61 @@ void mexFunction(
   using namespace std;
   using namespace igl;
   using namespace igl::matlab;
-  using namespace Eigen;
-  igl::matlab::MexStream mout;        
+  igl::matlab::MexStream mout;
   std::streambuf *outbuf = std::cout.rdbuf(&mout);
 
-  mexErrMsgTxt(nrhs==5,"nrhs should be == 5");
-  // unnecessary copy
-  int m,n;
-  m = (double)*mxGetPr(prhs[3]);
-  n = (double)*mxGetPr(prhs[4]);
-  mexErrMsgTxt(mxGetM(prhs[0]) == mxGetM(prhs[1]) && mxGetM(prhs[0]) == mxGetM(prhs[2]),"I J V must be same #rows");
-  mexErrMsgTxt(mxGetN(prhs[0]) == mxGetN(prhs[1]) && mxGetN(prhs[0]) == mxGetN(prhs[2]),"I J V must be same #cols");
-  const int nr = mxGetM(prhs[0]);
-  const int nc = mxGetN(prhs[0]);
-  std::vector<Eigen::Triplet<double> > IJV;
-  IJV.reserve(nr*nc);
-  for(int i = 0;i<nr;i++)
+  mexErrMsgTxt(nrhs>=5,"nrhs should be >= 5");
+  // m and n size the column buffers, so they are checked before anything is
+  // allocated (a negative one would wrap around to a huge size_t)
+  const auto parse_size = [&](const int i, const char * name)->size_t
   {
-    for(int j = 0;j<nc;j++)
+    mexErrMsgTxt(mxIsDouble(prhs[i]) && mxGetNumberOfElements(prhs[i])==1,
+      C_STR(name<<" should be a scalar"));
+    const double s = *mxGetPr(prhs[i]);
+    mexErrMsgTxt(s>=0 && s==std::floor(s) && std::isfinite(s),
+      C_STR(name<<" should be a non-negative integer"));
+    return (size_t)s;
+  };
+  const size_t m = parse_size(3,"m");
+  const size_t n = parse_size(4,"n");
+  const size_t ne = mxGetNumberOfElements(prhs[0]);
+  mexErrMsgTxt(mxGetM(prhs[0]) == mxGetM(prhs[1]) && mxGetN(prhs[0]) == mxGetN(prhs[1]),"I J must be same size");
+  mexErrMsgTxt(mxGetNumberOfElements(prhs[2]) == ne || mxGetNumberOfElements(prhs[2]) == 1,"V must be same size as I J or a scalar");
+  const NumericInput I(prhs[0]), J(prhs[1]), V(prhs[2]);
+  mexErrMsgTxt(I.valid() && J.valid() && V.valid(),"I J V must be numeric or logical");
+
+  bool logical = mxIsLogical(prhs[2]);
+  {
+    int i = 5;
+    while(i<nrhs)
     {
-      IJV.emplace_back(
-        mxGetPr(prhs[0])[i+nr*j]-1,
-        mxGetPr(prhs[1])[i+nr*j]-1,
-        mxGetPr(prhs[2])[i+nr*j]);
+      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Logical",name) == 0)
+      {
+        validate_arg_scalar(i,nrhs,prhs,name);
+        validate_arg_logical(i,nrhs,prhs,name);
+        logical = (bool)*mxGetLogicals(prhs[++i]);
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
+      }
+      i++;
     }
   }
-  Eigen::SparseMatrix<double> S(m,n);
-  // S.reserve doesn't seem to help much
-  S.setFromTriplets(IJV.begin(),IJV.end());
-  // This final copy is not that expensive (e.g., 0.5s gather, 1.1s scatter,
-  // 0.05s prepare lhs)
+
+  mxArray * S = fast_sparse_csc(I,J,V,ne,m,n,logical);
+  mexErrMsgTxt(S!=NULL,"I J must be integer indices within m by n");
   switch(nlhs)
   {
+    case 0:
     case 1:
-      prepare_lhs_double(S,plhs+0);
-    default:break;
+      plhs[0] = S;
+      break;
+    default:
+      mxDestroyArray(S);
+      break;
   }
   // Restore the std stream buffer Important!
   std::cout.rdbuf(outbuf);
@@ -1,10 +1,30 @@
 % FAST_SPARSE
 %
 % S = fast_sparse(I,J,V,m,n);
+% S = fast_sparse(I,J,V,m,n,'ParameterName',ParameterValue, ...);
 % 
 % instead of 
 % 
 % S = sparse(I,J,V,m,n);
 %
+% Inputs:
+%   I  #I list of row indices, double, single, (u)int32 or (u)int64
+%   J  #I list of column indices, same size as I (any class accepted for I)
+%   V  #I list of values or a single value for all entries, double, single,
+%     (u)int32, (u)int64 or logical
+%   m  number of rows
+%   n  number of columns
+%   Optional:
+%     'Logical' followed by whether to return a logical matrix, true where the
+%       summed values are not zero {true iff V is logical}
+% Outputs:
+%   S  m by n sparse matrix, duplicates summed and zero sums dropped
+%
+% The compressed columns are built in parallel straight into S (count per
+% column, scatter, then sort and sum every column), without any intermediate
+% triplet list or copy. Passing int32 indices, a scalar V or asking for a
+% logical S saves the memory of double copies. MATLAB has no single sparse
+% class, so single V gives a double S.
+%
 % Why is this faster than sparse? Please send your query to
 % http://www.mathworks.com/support/bugreports
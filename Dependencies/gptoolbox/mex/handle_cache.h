@@ -0,0 +1,123 @@
+#ifndef IGL_HANDLE_CACHE_H
+#define IGL_HANDLE_CACHE_H
+#include <mex.h>
+#include <igl/C_STR.h>
+#include <igl/matlab/mexErrMsgTxt.h>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+
+namespace igl
+{
+  // States built by the 'build' command of a mex, kept between calls by
+  // handle. State has a bytes member with its approximate memory; once the
+  // states hold more than limit bytes the least recently built or queried
+  // ones are dropped and their handles have to be built again.
+  template <typename State>
+  class HandleCache
+  {
+    public:
+      // Takes over a built state and returns its new handle
+      int insert(std::unique_ptr<State> state)
+      {
+        const int handle = m_next_handle++;
+        Entry & entry = m_entries[handle];
+        entry.state = std::move(state);
+        entry.last_use = ++m_tick;
+        evict(handle);
+        return handle;
+      }
+
+      // State of the handle in prhs[i], marked as used. Fails the mex call
+      // for an unknown or evicted handle.
+      State & get(const int i, const int nrhs, const mxArray *prhs[])
+      {
+        const int handle = parse_handle(i,nrhs,prhs);
+        const auto it = m_entries.find(handle);
+        igl::matlab::mexErrMsgTxt(it!=m_entries.end(),
+          C_STR("Unknown or evicted handle "<<handle<<", build it again"));
+        it->second.last_use = ++m_tick;
+        return *it->second.state;
+      }
+
+      // Runs the commands every cached mex shares and returns true, or
+      // returns false for any other command:
+      //   name('free') frees all states, name('free',handle) one of them
+      //   old = name('limit'[,bytes]) returns the limit and sets a new one
+      bool command(
+        const char * name,
+        mxArray *plhs[],
+        const int nrhs,
+        const mxArray *prhs[])
+      {
+        if(std::strcmp("free",name)==0)
+        {
+          if(nrhs==1)
+          {
+            m_entries.clear();
+          }else
+          {
+            m_entries.erase(parse_handle(1,nrhs,prhs));
+          }
+          return true;
+        }else if(std::strcmp("limit",name)==0)
+        {
+          plhs[0] = mxCreateDoubleScalar((double)m_limit);
+          if(nrhs>1)
+          {
+            igl::matlab::mexErrMsgTxt(
+              mxIsDouble(prhs[1]) && mxGetNumberOfElements(prhs[1])==1,
+              "limit should be a scalar number of bytes");
+            m_limit = (size_t)*mxGetPr(prhs[1]);
+            evict(0);
+          }
+          return true;
+        }
+        return false;
+      }
+
+    private:
+      struct Entry
+      {
+        std::unique_ptr<State> state;
+        // Tick of the last build or query, for least recently used eviction
+        uint64_t last_use = 0;
+      };
+
+      static int parse_handle(const int i, const int nrhs, const mxArray *prhs[])
+      {
+        igl::matlab::mexErrMsgTxt(
+          nrhs>i && mxIsDouble(prhs[i]) && mxGetNumberOfElements(prhs[i])==1,
+          "handle should be a scalar");
+        return (int)*mxGetPr(prhs[i]);
+      }
+
+      // Evicts least recently used states, other than keep, until the cache
+      // fits in m_limit
+      void evict(const int keep)
+      {
+        size_t total = 0;
+        for(const auto & entry : m_entries) total += entry.second.state->bytes;
+        while(total>m_limit)
+        {
+          auto lru = m_entries.end();
+          for(auto it = m_entries.begin();it!=m_entries.end();it++)
+          {
+            if(it->first==keep) continue;
+            if(lru==m_entries.end() || it->second.last_use<lru->second.last_use) lru = it;
+          }
+          if(lru==m_entries.end()) break;
+          total -= lru->second.state->bytes;
+          m_entries.erase(lru);
+        }
+      }
+
+      std::map<int,Entry> m_entries;
+      int m_next_handle = 1;
+      uint64_t m_tick = 0;
+      size_t m_limit = size_t(1)<<30;
+  };
+}
+
+#endif
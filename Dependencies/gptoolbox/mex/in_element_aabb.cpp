@@ -1,4 +1,6 @@
+#include "bvh_file.h"
 #include <igl/AABB.h>
+#include <igl/C_STR.h>
 #include <igl/in_element.h>
 #include <igl/matlab/MexStream.h>
 #include <igl/matlab/mexErrMsgTxt.h>
@@ -19,7 +21,8 @@ void parse_rhs(
   Eigen::MatrixXd & Q,
   Eigen::MatrixXd & bb_mins,
   Eigen::MatrixXd & bb_maxs,
-  Eigen::VectorXi & elements)
+  Eigen::VectorXi & elements,
+  std::string & file)
 {
   using namespace std;
   using namespace igl;
@@ -37,7 +40,15 @@ void parse_rhs(
   parse_rhs_index(prhs+1,Ele);
   parse_rhs_double(prhs+2,Q);
   mexErrMsgTxt(Q.cols() == dim,"Dimension of Q should match V");
-  if(nrhs > 3)
+  if(nrhs > 3 && mxIsChar(prhs[3]))
+  {
+    mexErrMsgTxt(nrhs == 5 && strcmp("BVH",mxArrayToString(prhs[3])) == 0 &&
+      mxIsChar(prhs[4]), "Expected 'BVH' followed by a path");
+    file = mxArrayToString(prhs[4]);
+    bb_mins.resize(0,dim);
+    bb_maxs.resize(0,dim);
+    elements.resize(0,1);
+  }else if(nrhs > 3)
   {
     mexErrMsgTxt(nrhs >= 6, "The number of input arguments must be 3 or >=6.");
     parse_rhs_double(prhs+3,bb_mins);
@@ -81,7 +92,17 @@ void mexFunction(
   MatrixXi Ele;
   VectorXi elements;
   VectorXi I;
-  parse_rhs(nrhs,prhs,V,Ele,Q,bb_mins,bb_maxs,elements);
+  std::string file;
+  parse_rhs(nrhs,prhs,V,Ele,Q,bb_mins,bb_maxs,elements,file);
+  if(!file.empty())
+  {
+    // Tree written by aabb(V,Ele,'File',file)
+    MappedBVH bvh;
+    std::string error;
+    mexErrMsgTxt(bvh.open(file,error),error.c_str());
+    mexErrMsgTxt(bvh.matches(V,Ele),C_STR(file<<" was built for another mesh"));
+    bvh.serialize(bb_mins,bb_maxs,elements);
+  }
   bool was_serialized = bb_mins.size()>0;
 
   switch(V.cols())
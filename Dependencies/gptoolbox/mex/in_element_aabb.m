@@ -4,6 +4,7 @@
 % I = in_element_aabb(V,Ele,Q);
 % [I,bb_mins,bb_maxs,elements] = ...
 %   in_element_aabb(V,Ele,Q,bb_mins,bb_maxs,elements);
+% I = in_element_aabb(V,Ele,Q,'BVH',path);
 %
 % Inputs:
 %   V  #V by dim list of mesh vertex positions. 
@@ -13,6 +14,9 @@
 %     bb_mins  max_tree by dim list of bounding box min corner positions
 %     bb_maxs  max_tree by dim list of bounding box max corner positions
 %     elements  max_tree list of element or (not leaf id) indices into Ele
+%     or
+%     'BVH' followed by the path of a tree of (V,Ele) written by
+%       aabb(V,Ele,'File',path), memory mapped instead of building the tree
 % Outputs:
 %   I  #Q list of indices into Ele of first containing element (0 means no
 %     containing element)
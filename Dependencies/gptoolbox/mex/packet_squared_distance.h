@@ -0,0 +1,415 @@
+#ifndef IGL_PACKET_SQUARED_DISTANCE_H
+#define IGL_PACKET_SQUARED_DISTANCE_H
+#include <igl/AABB.h>
+#include <igl/parallel_for.h>
+#include <igl/point_simplex_squared_distance.h>
+#include <Eigen/Core>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// The triangle leaf kernel is written with GCC/Clang vector extensions: two
+// lanes compile to SSE2 (the x86-64 baseline), four lanes to AVX inside a
+// function built for it, chosen at run time. Elsewhere leaves stay scalar.
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#  define IGL_PACKET_TRIANGLE_SIMD
+#endif
+
+namespace igl
+{
+  // Number of query points traversing the tree together
+  static const int DISTANCE_PACKET_SIZE = 8;
+
+  // Spreads the low 21 bits of x to every third bit
+  inline uint64_t morton_spread_3(uint64_t x)
+  {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffULL;
+    x = (x | x << 16) & 0x1f0000ff0000ffULL;
+    x = (x | x << 8) & 0x100f00f00f00f00fULL;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+    x = (x | x << 2) & 0x1249249249249249ULL;
+    return x;
+  }
+  // Spreads the low 32 bits of x to every other bit
+  inline uint64_t morton_spread_2(uint64_t x)
+  {
+    x &= 0xffffffffULL;
+    x = (x | x << 16) & 0x0000ffff0000ffffULL;
+    x = (x | x << 8) & 0x00ff00ff00ff00ffULL;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | x << 2) & 0x3333333333333333ULL;
+    x = (x | x << 1) & 0x5555555555555555ULL;
+    return x;
+  }
+
+  // Order of the rows of P along a Morton (Z-order) curve through their
+  // bounding box
+  //
+  // Inputs:
+  //   P  #P by (2|3) list of points
+  // Outputs:
+  //   order  #P list of indices into P, consecutive ones being close
+  template <typename DerivedP>
+  void morton_order(
+    const Eigen::MatrixBase<DerivedP> & P,
+    std::vector<int> & order)
+  {
+    const int dim = P.cols();
+    const int bits = dim==3 ? 21 : 32;
+    const Eigen::RowVectorXd lo = P.colwise().minCoeff().template cast<double>();
+    const Eigen::RowVectorXd hi = P.colwise().maxCoeff().template cast<double>();
+    const double cells = double((uint64_t(1)<<bits)-1);
+    std::vector<std::pair<uint64_t,int> > codes(P.rows());
+    for(int p = 0;p<P.rows();p++)
+    {
+      uint64_t code = 0;
+      for(int d = 0;d<dim;d++)
+      {
+        const double extent = hi(d)-lo(d);
+        const uint64_t q = extent>0 ?
+          uint64_t((double(P(p,d))-lo(d))/extent*cells) : 0;
+        code |= (dim==3 ? morton_spread_3(q) : morton_spread_2(q)) << d;
+      }
+      codes[p] = std::make_pair(code,p);
+    }
+    std::sort(codes.begin(),codes.end());
+    order.resize(P.rows());
+    for(int p = 0;p<P.rows();p++) order[p] = codes[p].second;
+  }
+
+#ifdef IGL_PACKET_TRIANGLE_SIMD
+  typedef double PacketLanes2 __attribute__((vector_size(16)));
+  typedef double PacketLanes4 __attribute__((vector_size(32)));
+
+  // Closest points on the triangle (a,b,c) to the DISTANCE_PACKET_SIZE
+  // points q, as many at a time as Lanes holds. This is the region test of
+  // point_simplex_squared_distance ("Real-Time Collision Detection" [Ericson
+  // 2005] 5.1.5) without branches: the barycentric weights (v,w) of the
+  // closest point a + v ab + w ac are computed for the interior and then
+  // overwritten by every region that matches, the earliest test of the scalar
+  // code last. Lanes of other regions may divide by zero; their values are
+  // never selected.
+  //
+  // Inputs:
+  //   a,b,c  triangle corners
+  //   q  3 by DISTANCE_PACKET_SIZE coordinates of the points
+  //   active  DISTANCE_PACKET_SIZE flags; a group of lanes with no active
+  //     point is skipped
+  // Outputs:
+  //   sqr_d  DISTANCE_PACKET_SIZE squared distances (infinity if skipped)
+  //   closest  3 by DISTANCE_PACKET_SIZE closest points
+  // y = m ? x : y per lane
+  template <typename Mask, typename Lanes>
+  inline __attribute__((always_inline)) void packet_lanes_assign(
+    const Mask & m,
+    const Lanes & x,
+    Lanes & y)
+  {
+    y = (Lanes)(((Mask)x&m)|((Mask)y&~m));
+  }
+
+  template <typename Lanes>
+  inline __attribute__((always_inline)) void packet_triangle_squared_distance_lanes(
+    const double * a,
+    const double * b,
+    const double * c,
+    const double (*q)[DISTANCE_PACKET_SIZE],
+    const bool * active,
+    double * sqr_d,
+    double (*closest)[DISTANCE_PACKET_SIZE])
+  {
+    typedef decltype(Lanes()<Lanes()) Mask;
+    const int W = sizeof(Lanes)/sizeof(double);
+    const Lanes zero = {};
+    const Lanes one = zero+1.0;
+    const double ab[3] = {b[0]-a[0],b[1]-a[1],b[2]-a[2]};
+    const double ac[3] = {c[0]-a[0],c[1]-a[1],c[2]-a[2]};
+    for(int first = 0;first<DISTANCE_PACKET_SIZE;first += W)
+    {
+      bool any = false;
+      for(int k = first;k<first+W;k++) any |= active[k];
+      if(!any)
+      {
+        for(int k = first;k<first+W;k++) sqr_d[k] = std::numeric_limits<double>::infinity();
+        continue;
+      }
+      Lanes p[3];
+      for(int d = 0;d<3;d++) std::memcpy(&p[d],&q[d][first],sizeof(Lanes));
+      Lanes d1 = zero, d2 = zero, d3 = zero, d4 = zero, d5 = zero, d6 = zero;
+      for(int d = 0;d<3;d++)
+      {
+        const Lanes ap = p[d]-a[d], bp = p[d]-b[d], cp = p[d]-c[d];
+        d1 += ab[d]*ap;
+        d2 += ac[d]*ap;
+        d3 += ab[d]*bp;
+        d4 += ac[d]*bp;
+        d5 += ab[d]*cp;
+        d6 += ac[d]*cp;
+      }
+      const Lanes va = d3*d6-d5*d4;
+      const Lanes vb = d5*d2-d1*d6;
+      const Lanes vc = d1*d4-d3*d2;
+      // Interior
+      const Lanes denom = va+vb+vc;
+      Lanes v = vb/denom;
+      Lanes w = vc/denom;
+      // Edge BC
+      const Lanes e43 = d4-d3, e56 = d5-d6;
+      const Lanes t_bc = e43/(e43+e56);
+      Mask m = (va<=0.0)&(e43>=0.0)&(e56>=0.0);
+      packet_lanes_assign(m,one-t_bc,v);
+      packet_lanes_assign(m,t_bc,w);
+      // Edge AC
+      m = (vb<=0.0)&(d2>=0.0)&(d6<=0.0);
+      packet_lanes_assign(m,zero,v);
+      packet_lanes_assign(m,d2/(d2-d6),w);
+      // Corner C
+      m = (d6>=0.0)&(d5<=d6);
+      packet_lanes_assign(m,zero,v);
+      packet_lanes_assign(m,one,w);
+      // Edge AB
+      m = (vc<=0.0)&(d1>=0.0)&(d3<=0.0);
+      packet_lanes_assign(m,d1/(d1-d3),v);
+      packet_lanes_assign(m,zero,w);
+      // Corner B
+      m = (d3>=0.0)&(d4<=d3);
+      packet_lanes_assign(m,one,v);
+      packet_lanes_assign(m,zero,w);
+      // Corner A
+      m = (d1<=0.0)&(d2<=0.0);
+      packet_lanes_assign(m,zero,v);
+      packet_lanes_assign(m,zero,w);
+
+      Lanes sum = zero;
+      for(int d = 0;d<3;d++)
+      {
+        const Lanes r = a[d]+v*ab[d]+w*ac[d];
+        const Lanes t = p[d]-r;
+        sum += t*t;
+        std::memcpy(&closest[d][first],&r,sizeof(Lanes));
+      }
+      std::memcpy(&sqr_d[first],&sum,sizeof(Lanes));
+    }
+  }
+
+  inline void packet_triangle_squared_distance_sse2(
+    const double * a,
+    const double * b,
+    const double * c,
+    const double (*q)[DISTANCE_PACKET_SIZE],
+    const bool * active,
+    double * sqr_d,
+    double (*closest)[DISTANCE_PACKET_SIZE])
+  {
+    packet_triangle_squared_distance_lanes<PacketLanes2>(a,b,c,q,active,sqr_d,closest);
+  }
+
+  __attribute__((target("avx"))) inline void packet_triangle_squared_distance_avx(
+    const double * a,
+    const double * b,
+    const double * c,
+    const double (*q)[DISTANCE_PACKET_SIZE],
+    const bool * active,
+    double * sqr_d,
+    double (*closest)[DISTANCE_PACKET_SIZE])
+  {
+    packet_triangle_squared_distance_lanes<PacketLanes4>(a,b,c,q,active,sqr_d,closest);
+  }
+#endif
+
+  typedef void (*PacketTriangleKernel)(
+    const double *,
+    const double *,
+    const double *,
+    const double (*)[DISTANCE_PACKET_SIZE],
+    const bool *,
+    double *,
+    double (*)[DISTANCE_PACKET_SIZE]);
+
+  // Triangle leaf kernel for this CPU, NULL where leaves stay scalar
+  inline PacketTriangleKernel packet_triangle_kernel()
+  {
+#ifdef IGL_PACKET_TRIANGLE_SIMD
+    static const PacketTriangleKernel kernel =
+      __builtin_cpu_supports("avx") ?
+        &packet_triangle_squared_distance_avx :
+        &packet_triangle_squared_distance_sse2;
+    return kernel;
+#else
+    return NULL;
+#endif
+  }
+
+  // Squared distances from points to a mesh through an AABB tree, as
+  // tree.squared_distance(V,Ele,P,sqrD,I,C), with the points sorted along a
+  // Morton curve and traversing the tree DISTANCE_PACKET_SIZE at a time.
+  // Consecutive points of a grid or of mesh vertices are close, so they visit
+  // almost the same nodes: each node is loaded once per packet, its box is
+  // tested against all points of the packet in one (vectorizable) loop, and
+  // it is skipped as soon as it is farther than the best distance of every
+  // point of the packet.
+  //
+  // Inputs:
+  //   tree  AABB tree of (V,Ele) (built with init, or loaded with read_bvh)
+  //   V  #V by DIM list of vertex positions
+  //   Ele  #Ele by (DIM|..|1) list of simplex indices into V
+  //   P  #P by DIM list of query point positions
+  // Outputs:
+  //   sqrD  #P list of smallest squared distances
+  //   I  #P list of indices into Ele of a closest simplex (any of them on
+  //     ties, so possibly another one than tree.squared_distance)
+  //   C  #P by DIM list of closest points
+  template <int DIM>
+  void packet_squared_distance(
+    const AABB<Eigen::MatrixXd,DIM> & tree,
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & Ele,
+    const Eigen::MatrixXd & P,
+    Eigen::VectorXd & sqrD,
+    Eigen::VectorXi & I,
+    Eigen::MatrixXd & C)
+  {
+    typedef AABB<Eigen::MatrixXd,DIM> Tree;
+    const int K = DISTANCE_PACKET_SIZE;
+    const int n = P.rows();
+    sqrD.setConstant(n,1,std::numeric_limits<double>::infinity());
+    I.setConstant(n,1,-1);
+    C.setZero(n,DIM);
+    if(n==0 || (tree.is_leaf() && tree.m_primitive<0))
+    {
+      return;
+    }
+    // Triangle leaves test the whole packet at once
+    const PacketTriangleKernel triangle_kernel =
+      DIM==3 && Ele.cols()==3 ? packet_triangle_kernel() : NULL;
+    std::vector<int> order;
+    morton_order(P,order);
+    const int num_packets = (n+K-1)/K;
+    igl::parallel_for(num_packets,[&](const int packet)
+    {
+      // Structure of arrays so that the box tests vectorize. The lanes past
+      // the end of P repeat its last point and are not written back.
+      double q[DIM][K];
+      double best[K];
+      int best_i[K];
+      Eigen::Matrix<double,1,DIM> best_c[K];
+      int lane_index[K];
+      for(int k = 0;k<K;k++)
+      {
+        lane_index[k] = order[std::min(packet*K+k,n-1)];
+        for(int d = 0;d<DIM;d++) q[d][k] = P(lane_index[k],d);
+        best[k] = std::numeric_limits<double>::infinity();
+        best_i[k] = -1;
+      }
+      double box_d[K];
+      const auto box_distances = [&](const Tree * node)->bool
+      {
+        const auto & lo = node->m_box.min();
+        const auto & hi = node->m_box.max();
+        for(int k = 0;k<K;k++) box_d[k] = 0;
+        for(int d = 0;d<DIM;d++)
+        {
+          const double l = lo(d), h = hi(d);
+          for(int k = 0;k<K;k++)
+          {
+            const double t = std::max(std::max(l-q[d][k],q[d][k]-h),0.0);
+            box_d[k] += t*t;
+          }
+        }
+        bool any = false;
+        for(int k = 0;k<K;k++) any |= box_d[k]<best[k];
+        return any;
+      };
+      const auto centre_distance = [&](const Tree * node)->double
+      {
+        const auto centre = node->m_box.center();
+        double sum = 0;
+        for(int k = 0;k<K;k++)
+        {
+          for(int d = 0;d<DIM;d++)
+          {
+            const double t = q[d][k]-centre(d);
+            sum += t*t;
+          }
+        }
+        return sum;
+      };
+
+      std::vector<const Tree *> stack;
+      stack.reserve(64);
+      stack.push_back(&tree);
+      while(!stack.empty())
+      {
+        const Tree * node = stack.back();
+        stack.pop_back();
+        if(!box_distances(node))
+        {
+          continue;
+        }
+        if(node->is_leaf() && triangle_kernel)
+        {
+          double corners[3][3];
+          for(int j = 0;j<3;j++)
+          {
+            for(int d = 0;d<3;d++) corners[j][d] = V(Ele(node->m_primitive,j),d);
+          }
+          bool active[K];
+          for(int k = 0;k<K;k++) active[k] = box_d[k]<best[k];
+          double sqr_d[K];
+          double c[3][K];
+          triangle_kernel(corners[0],corners[1],corners[2],q,active,sqr_d,c);
+          for(int k = 0;k<K;k++)
+          {
+            if(sqr_d[k]<best[k])
+            {
+              best[k] = sqr_d[k];
+              best_i[k] = node->m_primitive;
+              for(int d = 0;d<DIM;d++) best_c[k](d) = c[d][k];
+            }
+          }
+          continue;
+        }
+        if(node->is_leaf())
+        {
+          for(int k = 0;k<K;k++)
+          {
+            if(box_d[k]>=best[k]) continue;
+            Eigen::Matrix<double,1,DIM> p;
+            for(int d = 0;d<DIM;d++) p(d) = q[d][k];
+            double sqr_d;
+            Eigen::Matrix<double,1,DIM> c;
+            point_simplex_squared_distance<DIM>(p,V,Ele,node->m_primitive,sqr_d,c);
+            if(sqr_d<best[k])
+            {
+              best[k] = sqr_d;
+              best_i[k] = node->m_primitive;
+              best_c[k] = c;
+            }
+          }
+          continue;
+        }
+        // Visit the child nearer to the packet first
+        const Tree * first = node->m_left;
+        const Tree * second = node->m_right;
+        if(first && second && centre_distance(second)<centre_distance(first))
+        {
+          std::swap(first,second);
+        }
+        if(second) stack.push_back(second);
+        if(first) stack.push_back(first);
+      }
+      for(int k = 0;k<K && packet*K+k<n;k++)
+      {
+        sqrD(lane_index[k]) = best[k];
+        I(lane_index[k]) = best_i[k];
+        if(best_i[k]>=0) C.row(lane_index[k]) = best_c[k];
+      }
+    },1000/DISTANCE_PACKET_SIZE);
+  }
+}
+
+#endif
@@ -2,6 +2,9 @@
 #undef assert
 #define assert( isOK ) ( (isOK) ? (void)0 : (void) mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
 
+#include "bvh_file.h"
+#include "packet_squared_distance.h"
+#include <igl/AABB.h>
 #include <igl/matlab/MexStream.h>
 #include <igl/matlab/mexErrMsgTxt.h>
 #include <igl/matlab/parse_rhs.h>
@@ -34,8 +37,10 @@ void mexFunction(int nlhs, mxArray *plhs[],
   {
     POINT_MESH_SQUARED_DISTANCE_METHOD_LIBIGL = 0,
     POINT_MESH_SQUARED_DISTANCE_METHOD_CGAL = 1,
-    NUM_POINT_MESH_SQUARED_DISTANCE_METHODS = 2
+    POINT_MESH_SQUARED_DISTANCE_METHOD_PACKET = 2,
+    NUM_POINT_MESH_SQUARED_DISTANCE_METHODS = 3
   } method = POINT_MESH_SQUARED_DISTANCE_METHOD_LIBIGL;
+  std::string bvh;
   if(nrhs < 3)
   {
     mexErrMsgTxt("nrhs < 3");
@@ -66,10 +71,17 @@ void mexFunction(int nlhs, mxArray *plhs[],
         {
           method = POINT_MESH_SQUARED_DISTANCE_METHOD_CGAL;
           mexErrMsgTxt(F.cols() == 3, "'cgal' method only works for triangles");
+        }else if(strcmp("packet",type_name)==0)
+        {
+          method = POINT_MESH_SQUARED_DISTANCE_METHOD_PACKET;
         }else
         {
           mexErrMsgTxt(false,C_STR("Unknown method: "<<method));
         }
+      }else if(strcmp("BVH",name) == 0)
+      {
+        validate_arg_char(i,nrhs,prhs,name);
+        bvh = mxArrayToString(prhs[++i]);
       }else
       {
         mexErrMsgTxt(false,C_STR("Unknown parameter: "<<name));
@@ -81,8 +93,66 @@ void mexFunction(int nlhs, mxArray *plhs[],
   switch(method)
   {
     case POINT_MESH_SQUARED_DISTANCE_METHOD_LIBIGL:
-      igl::point_mesh_squared_distance(P,V,F,sqrD,I,C);
+      if(bvh.empty())
+      {
+        igl::point_mesh_squared_distance(P,V,F,sqrD,I,C);
+      }else
+      {
+        // Tree written by aabb(V,F,'File',bvh) instead of a new one
+        std::string error;
+        switch(V.cols())
+        {
+          case 3:
+          {
+            AABB<MatrixXd,3> tree;
+            mexErrMsgTxt(read_bvh(bvh,V,F,tree,error),error.c_str());
+            tree.squared_distance(V,F,P,sqrD,I,C);
+            break;
+          }
+          case 2:
+          {
+            AABB<MatrixXd,2> tree;
+            mexErrMsgTxt(read_bvh(bvh,V,F,tree,error),error.c_str());
+            tree.squared_distance(V,F,P,sqrD,I,C);
+            break;
+          }
+        }
+      }
       break;
+    case POINT_MESH_SQUARED_DISTANCE_METHOD_PACKET:
+    {
+      std::string error;
+      switch(V.cols())
+      {
+        case 3:
+        {
+          AABB<MatrixXd,3> tree;
+          if(bvh.empty())
+          {
+            tree.init(V,F);
+          }else
+          {
+            mexErrMsgTxt(read_bvh(bvh,V,F,tree,error),error.c_str());
+          }
+          packet_squared_distance(tree,V,F,P,sqrD,I,C);
+          break;
+        }
+        case 2:
+        {
+          AABB<MatrixXd,2> tree;
+          if(bvh.empty())
+          {
+            tree.init(V,F);
+          }else
+          {
+            mexErrMsgTxt(read_bvh(bvh,V,F,tree,error),error.c_str());
+          }
+          packet_squared_distance(tree,V,F,P,sqrD,I,C);
+          break;
+        }
+      }
+      break;
+    }
     case POINT_MESH_SQUARED_DISTANCE_METHOD_CGAL:
       igl::copyleft::cgal::point_mesh_squared_distance<CGAL::Epeck>(P,V,F,sqrD,I,C);
       break;
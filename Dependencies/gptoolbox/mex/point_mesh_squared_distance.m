@@ -6,6 +6,15 @@
 %   P  #P by 3 list of query point positions
 %   V  #V by 3 list of vertex positions
 %   F  #F by (3|2|1) list of triangle|edge|point indices
+%   Optional:
+%     'Method' followed by
+%       {'libigl'}  one AABB tree traversal per point
+%       'cgal'  exact CGAL distances (triangles only)
+%       'packet'  points sorted along a Morton curve traverse the tree 8 at
+%         a time, faster for coherent points (grids, mesh vertices); I may
+%         differ on ties
+%     'BVH' followed by the path of a tree of (V,F) written by
+%       aabb(V,F,'File',path), loaded instead of building the tree
 % Outputs:
 %   sqrD  #P list of smallest squared distances
 %   I  #P list of facet indices corresponding to smallest distances
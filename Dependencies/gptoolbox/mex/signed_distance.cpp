@@ -5,19 +5,82 @@
 #define assert( isOK ) ( (isOK) ? (void)0 : (void) mexErrMsgTxt(C_STR(__FILE__<<":"<<__LINE__<<": failed assertion `"<<#isOK<<"'"<<std::endl) ) )
 #include <igl/matlab/MexStream.h>
 
+#include "bvh_file.h"
+#include "handle_cache.h"
+#include "packet_squared_distance.h"
 #include <igl/per_vertex_normals.h>
 #include <igl/parallel_for.h>
 #include <igl/signed_distance.h>
 #include <igl/per_edge_normals.h>
 #include <igl/matlab/validate_arg.h>
 #include <igl/per_face_normals.h>
+#include <igl/pseudonormal_test.h>
 #include <igl/WindingNumberAABB.h>
 #include <igl/matlab/prepare_lhs.h>
 #include <igl/matlab/parse_rhs.h>
 #include <igl/C_STR.h>
 
 #include <Eigen/Core>
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <memory>
+
+void parse_type(
+  const int first,
+  const int nrhs,
+  const mxArray *prhs[],
+  igl::SignedDistanceType & type,
+  std::string & bvh,
+  bool & packets)
+{
+  using namespace igl;
+  using namespace igl::matlab;
+  type = SIGNED_DISTANCE_TYPE_PSEUDONORMAL;
+  bvh.clear();
+  packets = false;
+  int i = first;
+  while(i<nrhs)
+  {
+    mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
+    // Cast to char
+    const char * name = mxArrayToString(prhs[i]);
+    if(strcmp("SignedDistanceType",name) == 0)
+    {
+      validate_arg_char(i,nrhs,prhs,name);
+      const char * type_name = mxArrayToString(prhs[++i]);
+      if(strcmp("unsigned",type_name)==0)
+      {
+        type = igl::SIGNED_DISTANCE_TYPE_UNSIGNED;
+      }else if(strcmp("pseudonormal",type_name)==0)
+      {
+        type = igl::SIGNED_DISTANCE_TYPE_PSEUDONORMAL;
+      }else if(strcmp("fwn",type_name)==0)
+      {
+        type = igl::SIGNED_DISTANCE_TYPE_FAST_WINDING_NUMBER;
+      }else if(strcmp("winding_number",type_name)==0)
+      {
+        type = igl::SIGNED_DISTANCE_TYPE_WINDING_NUMBER;
+      }else
+      {
+        mexErrMsgTxt(false,C_STR("Unknown SignedDistanceType: "<<type_name));
+      }
+    }else if(strcmp("BVH",name) == 0)
+    {
+      validate_arg_char(i,nrhs,prhs,name);
+      bvh = mxArrayToString(prhs[++i]);
+    }else if(strcmp("Packets",name) == 0)
+    {
+      validate_arg_scalar(i,nrhs,prhs,name);
+      validate_arg_logical(i,nrhs,prhs,name);
+      packets = *(mxLogical *)mxGetData(prhs[++i]);
+    }else
+    {
+      mexErrMsgTxt(false,"Unknown parameter");
+    }
+    i++;
+  }
+}
 
 void parse_rhs(
   const int nrhs, 
@@ -25,7 +88,9 @@ void parse_rhs(
   Eigen::MatrixXd & P,
   Eigen::MatrixXd & V,
   Eigen::MatrixXi & F,
-  igl::SignedDistanceType & type)
+  igl::SignedDistanceType & type,
+  std::string & bvh,
+  bool & packets)
 {
   using namespace std;
   using namespace igl;
@@ -45,67 +110,264 @@ void parse_rhs(
   mexErrMsgTxt(V.cols()==P.cols(),"dim(V) must be dim(P)");
   mexErrMsgTxt(F.cols()==V.cols(),"F must be #F by dim(V)");
 
-  type = SIGNED_DISTANCE_TYPE_PSEUDONORMAL;
+  parse_type(3,nrhs,prhs,type,bvh,packets);
+}
+
+// Acceleration structures of one mesh
+struct State
+{
+  Eigen::MatrixXd V;
+  Eigen::MatrixXi F;
+  igl::SignedDistanceType sign_type = igl::NUM_SIGNED_DISTANCE_TYPE;
+  igl::AABB<Eigen::MatrixXd,3> tree;
+  igl::WindingNumberAABB<
+    Eigen::RowVector3d,
+    Eigen::MatrixXd,
+    Eigen::MatrixXi> hier;
+  Eigen::MatrixXd FN,VN,EN;
+  Eigen::MatrixXi E;
+  Eigen::VectorXi EMAP;
+  // Query with packet_squared_distance
+  bool packets = false;
+  // Approximate memory held, for the cache limit
+  size_t bytes = 0;
+};
+
+void precompute(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const igl::SignedDistanceType sign_type,
+  const std::string & bvh,
+  State & state)
+{
+  using namespace igl;
+  using namespace std;
+  using namespace Eigen;
+  // Prepare distance computation. The tree is loaded on the side so that a
+  // file that fails to read leaves state as it was.
+  igl::AABB<Eigen::MatrixXd,3> tree;
+  if(bvh.empty())
+  {
+    tree.init(V,F);
+  }else
+  {
+    // Tree written by aabb(V,F,'File',bvh)
+    std::string error;
+    igl::matlab::mexErrMsgTxt(read_bvh(bvh,V,F,tree,error),error.c_str());
+  }
+  state.V = V;
+  state.F = F;
+  state.sign_type = sign_type;
+  state.tree.swap(tree);
+  // the tree has about 2 #F nodes
+  state.bytes =
+    V.size()*sizeof(double) + F.size()*sizeof(int) +
+    2*F.rows()*sizeof(state.tree);
+  switch(sign_type)
+  {
+    default:
+      assert(false && "Unknown SignedDistanceType");
+    case SIGNED_DISTANCE_TYPE_DEFAULT:
+    case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
+    {
+      state.hier.set_mesh(V,F);
+      state.hier.grow();
+      // every level of the hierarchy holds a copy of (part of) F
+      size_t levels = 1;
+      while(((size_t)1<<levels)<(size_t)F.rows()) levels++;
+      state.bytes += levels*F.size()*sizeof(int);
+      break;
+    }
+    case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
+              // "Signed Distance Computation Using the Angle Weighted Pseudonormal"
+              // [Bærentzen & Aanæs 2005]
+      per_face_normals(V,F,state.FN);
+      per_vertex_normals(V,F,PER_VERTEX_NORMALS_WEIGHTING_TYPE_ANGLE,
+        state.FN,state.VN);
+      per_edge_normals(
+        V,F,PER_EDGE_NORMALS_WEIGHTING_TYPE_UNIFORM,
+        state.FN,state.EN,state.E,state.EMAP);
+      state.bytes +=
+        (state.FN.size()+state.VN.size()+state.EN.size())*sizeof(double) +
+        (state.E.size()+state.EMAP.size())*sizeof(int);
+      break;
+  }
+}
+
+void query(
+  const State & state,
+  const Eigen::MatrixXd & P,
+  Eigen::VectorXd & S,
+  Eigen::VectorXi & I,
+  Eigen::MatrixXd & C,
+  Eigen::MatrixXd & N)
+{
+  using namespace igl;
+  using namespace std;
+  using namespace Eigen;
+  N.resize(P.rows(),3);
+  S.resize(P.rows(),1);
+  I.resize(P.rows(),1);
+  C.resize(P.rows(),3);
+  if(state.packets)
   {
-    int i = 3;
-    while(i<nrhs)
+    // Closest points of coherent packets, then the sign of each point as
+    // signed_distance_winding_number and signed_distance_pseudonormal do
+    VectorXd sqrD;
+    packet_squared_distance(state.tree,state.V,state.F,P,sqrD,I,C);
+    N.setZero();
+    igl::parallel_for(P.rows(),[&](const int p)
     {
-      mexErrMsgTxt(mxIsChar(prhs[i]),"Parameter names should be strings");
-      // Cast to char
-      const char * name = mxArrayToString(prhs[i]);
-      if(strcmp("SignedDistanceType",name) == 0)
+      const Eigen::RowVector3d q(P(p,0),P(p,1),P(p,2));
+      double s = 1;
+      switch(state.sign_type)
       {
-        validate_arg_char(i,nrhs,prhs,name);
-        const char * type_name = mxArrayToString(prhs[++i]);
-        if(strcmp("unsigned",type_name)==0)
-        {
-          type = igl::SIGNED_DISTANCE_TYPE_UNSIGNED;
-        }else if(strcmp("pseudonormal",type_name)==0)
-        {
-          type = igl::SIGNED_DISTANCE_TYPE_PSEUDONORMAL;
-        }else if(strcmp("fwn",type_name)==0)
+        default:
+          assert(false && "Unknown SignedDistanceType");
+        case SIGNED_DISTANCE_TYPE_DEFAULT:
+        case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
+          s = 1.-2.*state.hier.winding_number(q.transpose());
+          break;
+        case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
         {
-          type = igl::SIGNED_DISTANCE_TYPE_FAST_WINDING_NUMBER;
-        }else if(strcmp("winding_number",type_name)==0)
-        {
-          type = igl::SIGNED_DISTANCE_TYPE_WINDING_NUMBER;
-        }else
-        {
-          mexErrMsgTxt(false,C_STR("Unknown SignedDistanceType: "<<type_name));
+          const Eigen::RowVector3d c = C.row(p);
+          RowVector3d n(0,0,0);
+          pseudonormal_test(
+            state.V,state.F,state.FN,state.VN,state.EN,state.EMAP,
+            q,I(p),c,s,n);
+          N.row(p) = n;
+          break;
         }
-      }else
+      }
+      S(p) = s*sqrt(sqrD(p));
+    },10000);
+    return;
+  }
+  //for(int p = 0;p<P.rows();p++)
+  igl::parallel_for(P.rows(),[&](const int p)
+  {
+    const Eigen::RowVector3d q(P(p,0),P(p,1),P(p,2));
+    double s,sqrd;
+    Eigen::RowVector3d c;
+    int i;
+    switch(state.sign_type)
+    {
+      default:
+        assert(false && "Unknown SignedDistanceType");
+      case SIGNED_DISTANCE_TYPE_DEFAULT:
+      case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
+        signed_distance_winding_number(
+          state.tree,state.V,state.F,state.hier,q,s,sqrd,i,c);
+        break;
+      case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
       {
-        mexErrMsgTxt(false,"Unknown parameter");
+        RowVector3d n(0,0,0);
+        signed_distance_pseudonormal(
+          state.tree,state.V,state.F,state.FN,state.VN,state.EN,state.EMAP,
+          q,s,sqrd,i,c,n);
+        N.row(p) = n;
+        break;
       }
-      i++;
     }
+    I(p) = i;
+    S(p) = s*sqrt(sqrd);
+    C.row(p) = c;
+  },10000);
+}
+
+// This will remember the data structures for subsequent calls (without an
+// calls in between with different (V,F) or type
+static State g_state;
+
+// Meshes built with signed_distance('build',...), by handle
+static igl::HandleCache<State> g_cache;
+
+void prepare_lhs(
+  const int nlhs,
+  mxArray *plhs[],
+  const Eigen::VectorXd & S,
+  const Eigen::VectorXi & I,
+  const Eigen::MatrixXd & C,
+  const Eigen::MatrixXd & N)
+{
+  using namespace igl::matlab;
+  switch(nlhs)
+  {
+    default:
+    {
+      mexErrMsgTxt(false,"Too many output parameters.");
+    }
+    case 4:
+    {
+      prepare_lhs_double(N,plhs+3);
+      // Fall through
+    }
+    case 3:
+    {
+      prepare_lhs_double(C,plhs+2);
+      // Fall through
+    }
+    case 2:
+    {
+      prepare_lhs_index(I,plhs+1);
+      // Fall through
+    }
+    case 1:
+    {
+      prepare_lhs_double(S,plhs+0);
+      // Fall through
+    }
+    case 0: break;
   }
 }
 
-//void precompute(
-//  const Eigen::MatrixXd & V,
-//  const Eigen::MatrixXi & F,
-//  const igl::SignedDistanceType sign_type,
-//  State & state)
-//{
-//  using namespace igl;
-//  using namespace std;
-//  using namespace Eigen;
-
-  // This will remember the data structures for subsequent calls (without an
-  // calls in between with different (V,F) or type
-  static Eigen::MatrixXd g_V;
-  static Eigen::MatrixXi g_F;
-  static igl::SignedDistanceType g_sign_type = 
-    igl::NUM_SIGNED_DISTANCE_TYPE;
-  static igl::AABB<Eigen::MatrixXd,3> g_tree;
-  static igl::WindingNumberAABB<
-    Eigen::RowVector3d,
-    Eigen::MatrixXd,
-    Eigen::MatrixXi> g_hier;
-  static Eigen::MatrixXd g_FN,g_VN,g_EN;
-  static Eigen::MatrixXi g_E;
-  static Eigen::VectorXi g_EMAP;
+// signed_distance('build'|'query'|'free'|'limit',...)
+void handle_command(
+  int nlhs, mxArray *plhs[],
+  int nrhs, const mxArray *prhs[])
+{
+  using namespace std;
+  using namespace Eigen;
+  using namespace igl;
+  using namespace igl::matlab;
+  const char * command = mxArrayToString(prhs[0]);
+  if(g_cache.command(command,plhs,nrhs,prhs))
+  {
+    return;
+  }else if(strcmp("build",command)==0)
+  {
+    mexErrMsgTxt(nrhs>=3,"build expects V and F");
+    MatrixXd V;
+    MatrixXi F;
+    SignedDistanceType type;
+    std::string bvh;
+    bool packets;
+    parse_rhs_double(prhs+1,V);
+    parse_rhs_index(prhs+2,F);
+    mexErrMsgTxt(V.cols()==3,"V must be #V by 3");
+    mexErrMsgTxt(F.cols()==3 && F.rows()>0,"F must be #F by 3");
+    parse_type(3,nrhs,prhs,type,bvh,packets);
+    // Only a successful build gets a handle and a cache entry
+    std::unique_ptr<State> state(new State());
+    precompute(V,F,type,bvh,*state);
+    state->packets = packets;
+    plhs[0] = mxCreateDoubleScalar(g_cache.insert(std::move(state)));
+  }else if(strcmp("query",command)==0)
+  {
+    const State & state = g_cache.get(1,nrhs,prhs);
+    mexErrMsgTxt(nrhs>=3,"query expects P");
+    MatrixXd P,C,N;
+    VectorXi I;
+    VectorXd S;
+    parse_rhs_double(prhs+2,P);
+    mexErrMsgTxt(P.cols()==3,"P must be #P by 3");
+    query(state,P,S,I,C,N);
+    prepare_lhs(nlhs,plhs,S,I,C,N);
+  }else
+  {
+    mexErrMsgTxt(false,C_STR("Unknown command: "<<command));
+  }
+}
 
 void mexFunction(
   int nlhs, mxArray *plhs[], 
@@ -120,12 +382,22 @@ void mexFunction(
   std::streambuf *outbuf = cout.rdbuf(&mout);
   //mexPrintf("Compiled at %s on %s\n",__TIME__,__DATE__);
 
+  if(nrhs>=1 && mxIsChar(prhs[0]))
+  {
+    handle_command(nlhs,plhs,nrhs,prhs);
+    // Restore the std stream buffer Important!
+    std::cout.rdbuf(outbuf);
+    return;
+  }
+
   MatrixXd P,V,C,N;
   MatrixXi F;
   VectorXi I;
   VectorXd S;
   SignedDistanceType type;
-  parse_rhs(nrhs,prhs,P,V,F,type);
+  std::string bvh;
+  bool packets;
+  parse_rhs(nrhs,prhs,P,V,F,type,bvh,packets);
 
   if(F.rows() > 0)
   {
@@ -134,110 +406,26 @@ void mexFunction(
       case 2:
       {
         // Persistent data not supported for 2D
+        mexErrMsgTxt(bvh.empty(),"BVH is only supported for 3D meshes");
         signed_distance(P,V,F,type,S,I,C,N);
         break;
       }
       case 3:
       {
-        if(g_sign_type != type || g_V != V || g_F != F)
+        if(g_state.sign_type != type ||
+          g_state.V.rows() != V.rows() || g_state.F.rows() != F.rows() ||
+          g_state.V != V || g_state.F != F)
         {
-          g_V = V;
-          g_F = F;
-          g_sign_type = type;
-          // Clear the tree
-          g_tree.deinit();
-
-          // Prepare distance computation
-          g_tree.init(V,F);
-          switch(type)
-          {
-            default:
-              assert(false && "Unknown SignedDistanceType");
-            case SIGNED_DISTANCE_TYPE_DEFAULT:
-            case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
-              g_hier.set_mesh(V,F);
-              g_hier.grow();
-              break;
-            case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
-              // "Signed Distance Computation Using the Angle Weighted Pseudonormal"
-              // [Bærentzen & Aanæs 2005]
-              per_face_normals(V,F,g_FN);
-              per_vertex_normals(V,F,PER_VERTEX_NORMALS_WEIGHTING_TYPE_ANGLE,
-                g_FN,g_VN);
-              per_edge_normals(
-                V,F,PER_EDGE_NORMALS_WEIGHTING_TYPE_UNIFORM,
-                g_FN,g_EN,g_E,g_EMAP);
-              break;
-          }
+          precompute(V,F,type,bvh,g_state);
         }
-
-        N.resize(P.rows(),3);
-        S.resize(P.rows(),1);
-        I.resize(P.rows(),1);
-        C.resize(P.rows(),3);
-        //for(int p = 0;p<P.rows();p++)
-        igl::parallel_for(P.rows(),[&](const int p)
-        {
-          const Eigen::RowVector3d q(P(p,0),P(p,1),P(p,2));
-          double s,sqrd;
-          Eigen::RowVector3d c;
-          int i;
-          switch(type)
-          {
-            default:
-              assert(false && "Unknown SignedDistanceType");
-            case SIGNED_DISTANCE_TYPE_DEFAULT:
-            case SIGNED_DISTANCE_TYPE_WINDING_NUMBER:
-              signed_distance_winding_number(
-                g_tree,g_V,g_F,g_hier,q,s,sqrd,i,c);
-              break;
-            case SIGNED_DISTANCE_TYPE_PSEUDONORMAL:
-            {
-              RowVector3d n(0,0,0);
-              signed_distance_pseudonormal(
-                g_tree,g_V,g_F,g_FN,g_VN,g_EN,g_EMAP,
-                q,s,sqrd,i,c,n);
-              N.row(p) = n;
-              break;
-            }
-          }
-          I(p) = i;
-          S(p) = s*sqrt(sqrd);
-          C.row(p) = c;
-        },10000);
+        g_state.packets = packets;
+        query(g_state,P,S,I,C,N);
         break;
       }
     }
   }
 
-  switch(nlhs)
-  {
-    default:
-    {
-      mexErrMsgTxt(false,"Too many output parameters.");
-    }
-    case 4:
-    {
-      prepare_lhs_double(N,plhs+3);
-      // Fall through
-    }
-    case 3:
-    {
-      prepare_lhs_double(C,plhs+2);
-      // Fall through
-    }
-    case 2:
-    {
-      prepare_lhs_index(I,plhs+1);
-      // Fall through
-    }
-    case 1:
-    {
-      prepare_lhs_double(S,plhs+0);
-      // Fall through
-    }
-    case 0: break;
-  }
+  prepare_lhs(nlhs,plhs,S,I,C,N);
 
   // Restore the std stream buffer Important!
   std::cout.rdbuf(outbuf);
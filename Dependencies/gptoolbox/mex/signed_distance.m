@@ -1,6 +1,10 @@
 % SIGNED_DISTANCE Compute signed distance from points P to a mesh (V,F)
 %
 % [S,I,C,N] = signed_distance(P,V,F,'ParameterName',parameter_value,...)
+% id = signed_distance('build',V,F,'ParameterName',parameter_value,...)
+% [S,I,C,N] = signed_distance('query',id,P)
+% signed_distance('free',id)
+% previous = signed_distance('limit',bytes)
 %
 % Inputs:
 %   P  #P by 3 list of query point positions
@@ -12,11 +16,25 @@
 %         non-watertight)
 %       {'pseudonormal'}  use pseudo-normal, binary scale (but not robust for
 %         non-watertight meshes.
+%     'BVH' followed by the path of a tree of (V,F) written by
+%       aabb(V,F,'File',path), loaded instead of building the tree
+%     'Packets' followed by whether to sort P along a Morton curve and
+%       traverse the tree 8 points at a time, faster for coherent points
+%       (grids, mesh vertices) {false}
 % Outputs:
 %   S  #P list of smallest signed distances
 %   I  #P list of facet indices corresponding to smallest distances
 %   C  #P by 3 list of closest points
 %   N  #P by 3 list of closest normals (only set if
+%
+% The (P,V,F) form keeps the trees of the last 3D mesh and rebuilds them
+% whenever it is called with a different mesh, after comparing (V,F) with
+% the kept copy. 'build' instead returns a handle to the trees of (V,F) (3D
+% only) that 'query' reuses without any comparison, so several meshes can be
+% queried in turn. Handles stay valid until 'free' (of one handle, or of all
+% with no handle), or until they are evicted: when the (approximate) memory of
+% all built meshes exceeds the limit {1GB}, the least recently built or
+% queried ones are freed. 'limit' returns the previous limit.
 %   
 % Example:
 %   
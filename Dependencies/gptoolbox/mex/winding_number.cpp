@@ -16,6 +16,7 @@
 #  include <igl/embree/EmbreeIntersector.h>
 #endif
 #include <igl/random_dir.h>
+#include "handle_cache.h"
 
 #include <mex.h>
 #include <Eigen/Dense>
@@ -23,7 +24,14 @@
 #include <igl/matlab/parse_rhs.h>
 #include <igl/matlab/prepare_lhs.h>
 #include <igl/C_STR.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
 
 // Inputs:
 //   nrhs  number of right hand side arguments
@@ -135,6 +143,216 @@ void parse_rhs(
 }
 
 
+// A fast winding number tree (and expansion coefficients) built with
+// winding_number('build',...)
+struct FastState
+{
+  igl::FastWindingNumberBVH bvh;
+  // Approximate memory held, for the cache limit
+  size_t bytes = 0;
+};
+
+// Trees by handle
+static igl::HandleCache<FastState> g_cache;
+
+// Evaluates the fast winding number at point(q, p) for every q in [0,n) and
+// hands it to out(q, w). Points are handed out in batches of batch_size to
+// num_threads threads (0 for one per hardware thread), so that no list of
+// query points needs to exist.
+template <typename PointFunc, typename OutFunc>
+void stream_fast_winding_number(
+  const igl::FastWindingNumberBVH & bvh,
+  const float accuracy,
+  const size_t n,
+  const PointFunc & point,
+  const OutFunc & out,
+  int num_threads,
+  const size_t batch_size)
+{
+  if(num_threads<=0)
+  {
+    num_threads = std::max(1u,std::thread::hardware_concurrency());
+  }
+  const size_t num_batches = (n+batch_size-1)/batch_size;
+  num_threads = (int)std::min<size_t>(num_threads,std::max<size_t>(num_batches,1));
+  std::atomic<size_t> next(0);
+  const auto work = [&]()
+  {
+    Eigen::RowVector3d p;
+    for(size_t b = next++;b<num_batches;b = next++)
+    {
+      const size_t last = std::min(n,(b+1)*batch_size);
+      for(size_t q = b*batch_size;q<last;q++)
+      {
+        point(q,p);
+        out(q,igl::fast_winding_number(bvh,accuracy,p));
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for(int t = 1;t<num_threads;t++) threads.emplace_back(work);
+  work();
+  for(auto & thread : threads) thread.join();
+}
+
+// winding_number('build'|'query'|'grid'|'free'|'limit',...)
+void handle_command(
+  int nlhs, mxArray *plhs[],
+  int nrhs, const mxArray *prhs[])
+{
+  using namespace std;
+  using namespace Eigen;
+  using namespace igl;
+  using namespace igl::matlab;
+  const char * command = mxArrayToString(prhs[0]);
+  // Query options
+  float accuracy = 2;
+  int num_threads = 0;
+  size_t batch_size = 4096;
+  double threshold = 0;
+  bool mask = false;
+  const auto parse_options = [&](int i)
+  {
+    while(i<nrhs)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),
+        "Parameter names should be char strings");
+      // Cast to char
+      const char * name = mxArrayToString(prhs[i]);
+      if(strcmp("Accuracy",name) == 0)
+      {
+        validate_arg_double(i,nrhs,prhs,name);
+        validate_arg_scalar(i,nrhs,prhs,name);
+        accuracy = (float)*mxGetPr(prhs[++i]);
+      }else if(strcmp("Threads",name) == 0)
+      {
+        validate_arg_double(i,nrhs,prhs,name);
+        validate_arg_scalar(i,nrhs,prhs,name);
+        num_threads = (int)*mxGetPr(prhs[++i]);
+      }else if(strcmp("BatchSize",name) == 0)
+      {
+        validate_arg_double(i,nrhs,prhs,name);
+        validate_arg_scalar(i,nrhs,prhs,name);
+        batch_size = (size_t)std::max(1.0,*mxGetPr(prhs[++i]));
+      }else if(strcmp("Threshold",name) == 0)
+      {
+        validate_arg_double(i,nrhs,prhs,name);
+        validate_arg_scalar(i,nrhs,prhs,name);
+        threshold = *mxGetPr(prhs[++i]);
+        mask = true;
+      }else
+      {
+        mexErrMsgTxt(false,
+          C_STR("Un-supported parameter: "<<name));
+      }
+      i++;
+    }
+  };
+  if(g_cache.command(command,plhs,nrhs,prhs))
+  {
+    return;
+  }else if(strcmp("build",command)==0)
+  {
+    mexErrMsgTxt(nrhs>=3,"build expects V and F");
+    MatrixXd V;
+    MatrixXi F;
+    parse_rhs_double(prhs+1,V);
+    parse_rhs_index(prhs+2,F);
+    mexErrMsgTxt(V.cols()==3,"V must be #V by 3");
+    mexErrMsgTxt(F.cols()==3 && F.rows()>0,"F must be #F by 3");
+    int order = 2;
+    for(int i = 3;i<nrhs;i++)
+    {
+      mexErrMsgTxt(mxIsChar(prhs[i]),
+        "Parameter names should be char strings");
+      const char * name = mxArrayToString(prhs[i]);
+      mexErrMsgTxt(strcmp("Order",name) == 0,
+        C_STR("Un-supported parameter: "<<name));
+      validate_arg_double(i,nrhs,prhs,name);
+      validate_arg_scalar(i,nrhs,prhs,name);
+      order = (int)*mxGetPr(prhs[++i]);
+      mexErrMsgTxt(order>=0 && order<=2,"Order should be 0, 1 or 2");
+    }
+    std::unique_ptr<FastState> state(new FastState());
+    igl::fast_winding_number(V,F,order,state->bvh);
+    // points as floats, and a tree node with its expansion coefficients for
+    // about every two triangles
+    state->bytes = V.rows()*3*sizeof(float) + F.rows()*(3*sizeof(int)+64*sizeof(float));
+    // Only a built tree gets a handle
+    plhs[0] = mxCreateDoubleScalar(g_cache.insert(std::move(state)));
+  }else if(strcmp("query",command)==0)
+  {
+    const FastState & state = g_cache.get(1,nrhs,prhs);
+    mexErrMsgTxt(nrhs>=3,"query expects O");
+    MatrixXd O;
+    parse_rhs_double(prhs+2,O);
+    mexErrMsgTxt(O.cols()==3,"O must be #O by 3");
+    parse_options(3);
+    mxArray * W = mask ?
+      mxCreateLogicalMatrix(O.rows(),1) :
+      mxCreateDoubleMatrix(O.rows(),1,mxREAL);
+    double * Wd = mask ? NULL : mxGetPr(W);
+    mxLogical * Wl = mask ? mxGetLogicals(W) : NULL;
+    stream_fast_winding_number(
+      state.bvh,accuracy,O.rows(),
+      [&O](const size_t q, Eigen::RowVector3d & p){ p = O.row(q); },
+      [&](const size_t q, const double w)
+      {
+        if(mask) Wl[q] = w>threshold; else Wd[q] = w;
+      },
+      num_threads,batch_size);
+    plhs[0] = W;
+  }else if(strcmp("grid",command)==0)
+  {
+    const FastState & state = g_cache.get(1,nrhs,prhs);
+    mexErrMsgTxt(nrhs>=5,"grid expects corner, h and res");
+    mexErrMsgTxt(mxIsDouble(prhs[2]) && mxGetNumberOfElements(prhs[2])==3,
+      "corner should be a 3-vector");
+    mexErrMsgTxt(mxIsDouble(prhs[3]) &&
+      (mxGetNumberOfElements(prhs[3])==1 || mxGetNumberOfElements(prhs[3])==3),
+      "h should be a scalar or a 3-vector");
+    mexErrMsgTxt(mxIsDouble(prhs[4]) && mxGetNumberOfElements(prhs[4])==3,
+      "res should be a 3-vector");
+    const Eigen::RowVector3d corner(mxGetPr(prhs[2])[0],mxGetPr(prhs[2])[1],mxGetPr(prhs[2])[2]);
+    const double * hp = mxGetPr(prhs[3]);
+    const int hs = mxGetNumberOfElements(prhs[3])==3 ? 1 : 0;
+    const Eigen::RowVector3d h(hp[0],hp[hs],hp[2*hs]);
+    mwSize res[3];
+    for(int c = 0;c<3;c++)
+    {
+      mexErrMsgTxt(mxGetPr(prhs[4])[c]>=0,"res should be >= 0");
+      res[c] = (mwSize)mxGetPr(prhs[4])[c];
+    }
+    parse_options(5);
+    mxArray * W = mask ?
+      mxCreateLogicalArray(3,res) :
+      mxCreateNumericArray(3,res,mxDOUBLE_CLASS,mxREAL);
+    double * Wd = mask ? NULL : mxGetPr(W);
+    mxLogical * Wl = mask ? mxGetLogicals(W) : NULL;
+    // Voxel (i,j,k) (1-based) is at corner + h.*[j-1 i-1 k-1]: rows run along
+    // y and columns along x, as in meshgrid and isosurface. res is
+    // [#y #x #z] and the first index is fastest as MATLAB stores it
+    stream_fast_winding_number(
+      state.bvh,accuracy,(size_t)res[0]*res[1]*res[2],
+      [&](const size_t q, Eigen::RowVector3d & p)
+      {
+        const size_t i = q%res[0];
+        const size_t j = (q/res[0])%res[1];
+        const size_t k = q/(res[0]*res[1]);
+        p = corner+Eigen::RowVector3d(j,i,k).cwiseProduct(h);
+      },
+      [&](const size_t q, const double w)
+      {
+        if(mask) Wl[q] = w>threshold; else Wd[q] = w;
+      },
+      num_threads,batch_size);
+    plhs[0] = W;
+  }else
+  {
+    mexErrMsgTxt(false,C_STR("Unknown command: "<<command));
+  }
+}
+
 void mexFunction(
   int nlhs, mxArray *plhs[], 
   int nrhs, const mxArray *prhs[])
@@ -146,6 +364,14 @@ void mexFunction(
   igl::matlab::MexStream mout;        
   std::streambuf *outbuf = cout.rdbuf(&mout);
 
+  if(nrhs>=1 && mxIsChar(prhs[0]))
+  {
+    handle_command(nlhs,plhs,nrhs,prhs);
+    // Restore the std stream buffer Important!
+    std::cout.rdbuf(outbuf);
+    return;
+  }
+
   Eigen::MatrixXd V,O;
   Eigen::MatrixXi F;
   bool hierarchical, ray_cast, ray_parity, twod_rays, fast;
@@ -4,6 +4,11 @@ function [W] = winding_number(V,F,O,varargin)
   % 
   % [W] = winding_number(V,F,O)
   % [W] = winding_number(V,F,O,'ParameterName',ParameterValue, ...)
+  % id = winding_number('build',V,F,'Order',order)
+  % [W] = winding_number('query',id,O,'ParameterName',ParameterValue, ...)
+  % [W] = winding_number('grid',id,corner,h,res,'ParameterName',ParameterValue, ...)
+  % winding_number('free',id)
+  % previous = winding_number('limit',bytes)
   %
   % Inputs:
   %  V  #V by 3 list of vertex positions
@@ -17,8 +22,38 @@ function [W] = winding_number(V,F,O,varargin)
   %      evaluation: {false}
   %    'TwoDRays' followed by true or false. Use 2d rays only.
   %    'NumRays' followed by the number of rays to cast for each origin
+  %  id  handle returned by 'build'
+  %  order  expansion order of the fast winding number tree (0, 1 or {2})
+  %  corner  3-vector [x y z] position of the first voxel of the grid
+  %  h  scalar or 3-vector [hx hy hz] voxel spacing
+  %  res  3-vector [#y #x #z] number of voxels along y (rows), x (columns)
+  %    and z, i.e. the size of the output as for meshgrid
+  %  Optional inputs of 'query' and 'grid':
+  %    'Accuracy' followed by the accuracy scale of the fast winding number,
+  %      larger is more accurate and slower {2}
+  %    'Threads' followed by the number of threads {0: all}
+  %    'BatchSize' followed by the number of points a thread takes at a time
+  %      {4096}
+  %    'Threshold' followed by t to return the logical mask W > t instead of
+  %      the winding numbers (e.g. 0.5 for inside)
   % Outputs:
-  %  W  no by 1 list of winding numbers
+  %  W  no by 1 list of winding numbers, or for 'grid' res(1) by res(2) by
+  %    res(3) array where W(i,j,k) is the winding number at
+  %    corner + h.*[j-1 i-1 k-1], i.e. the first index runs along y and the
+  %    second along x, as in meshgrid and isosurface
+  %
+  % 'build' precomputes the fast winding number tree and expansion
+  % coefficients of (V,F) once and returns a handle that 'query' and 'grid'
+  % reuse. 'grid' evaluates every voxel center without a list of query points,
+  % e.g. for an inside mask of a mesh extracted with isosurface(I,...) (whose
+  % x is the column and y the row of I), in I's voxel grid:
+  %   id = winding_number('build',V,F);
+  %   M = winding_number('grid',id,[1 1 1],1,size(I),'Threshold',0.5);
+  %   winding_number('free',id);
+  % Handles stay valid until 'free' (of one handle, or of all with no handle),
+  % or until they are evicted: when the (approximate) memory of all built
+  % trees exceeds the limit {1GB}, the least recently built or queried ones
+  % are freed. 'limit' returns the previous limit.
   %
 
   warning('not mex...');
@@ -12,6 +12,7 @@ function smoothingMatrix=meshGaussian(IDXRow, IDXCol, vals, sigma)
     %    IDXRow - IDXRow output form getStepVectors.m
     %    IDXCol - IDXCol output form getStepVectors.m
     %    vals - Step output form getStepVectors.m
+    %       or geodesic distances from geodesic_balls
     %    sigma - sigma for gaussian kernel 
     % 
     % Outputs:
@@ -0,0 +1,49 @@
+function [points, edges] = readMedialPoints(filePath)
+    % Description:
+    %     -  Memory maps a medial point file written by skeltool -exportPoints / -exportGraph
+    % Input:
+    %     - filePath: path to medialSurfacePoints.skpt
+    %
+    % Outputs:
+    %     - points: struct with fields index (Nx3 int32, 0 based voxel index), position (Nx3
+    %       single, physical coordinates), radius, aof (Nx1 single) and label (Nx1 uint32,
+    %       topological class 2-10)
+    %     - edges: Mx2 uint32 array of 1 based point ids of 26-adjacent voxels (empty if the
+    %       file has no graph)
+    %
+    % ------------- BEGIN CODE --------------
+    fid = fopen(filePath, 'r', 'ieee-le');
+    if fid < 0
+        error('readMedialPoints:open', 'Could not open %s', filePath);
+    end
+    magic = fread(fid, 4, '*char')';
+    header = fread(fid, 3, 'uint32');
+    counts = fread(fid, 2, 'uint64');
+    fclose(fid);
+    if ~strcmp(magic, 'SKPT') || header(1) ~= 1 || header(3) ~= 36
+        error('readMedialPoints:format', '%s is not a version 1 medial point file', filePath);
+    end
+    numPoints = double(counts(1));
+    numEdges = double(counts(2));
+
+    headerBytes = 32;
+    recordFormat = {'int32', [3 1], 'index'; 'single', [3 1], 'position'; ...
+                    'single', [1 1], 'radius'; 'single', [1 1], 'aof'; 'uint32', [1 1], 'label'};
+    points = struct('index', zeros(0, 3, 'int32'), 'position', zeros(0, 3, 'single'), ...
+                    'radius', zeros(0, 1, 'single'), 'aof', zeros(0, 1, 'single'), 'label', zeros(0, 1, 'uint32'));
+    if numPoints > 0
+        m = memmapfile(filePath, 'Offset', headerBytes, 'Format', recordFormat, 'Repeat', numPoints);
+        records = m.Data;
+        points.index = reshape([records.index], 3, [])';
+        points.position = reshape([records.position], 3, [])';
+        points.radius = [records.radius]';
+        points.aof = [records.aof]';
+        points.label = [records.label]';
+    end
+
+    edges = zeros(0, 2, 'uint32');
+    if bitand(header(2), 1) && numEdges > 0
+        m = memmapfile(filePath, 'Offset', headerBytes + 36 * numPoints, 'Format', 'uint32', 'Repeat', 2 * numEdges);
+        edges = reshape(m.Data, 2, [])' + 1;
+    end
+end
@@ -2,6 +2,18 @@ function cleanedVolume = removeSmallObjects(inputVolume, volumeThreshold, return
     % Remove small objects from a 3D volume and optionally label components
     % Defaults to keeping only the largest component if no threshold is given
 
+    % Binary output without a label volume, slab by slab
+    if exist('remove_small_objects', 'file') == 3 && ~(nargin >= 5 && returnLabeled)
+        if nargin < 4 || isempty(volumeThreshold)
+            [cleanedVolume, numObjects, numKept] = remove_small_objects(inputVolume);
+        else
+            [cleanedVolume, numObjects, numKept] = remove_small_objects(inputVolume, 'MinSize', volumeThreshold);
+        end
+        fprintf('# of connected objects in original volume: %d\n', numObjects);
+        fprintf('# of connected objects to keep: %d\n', numKept);
+        return;
+    end
+
     % Find connected components
     CC = bwconncomp(inputVolume, 26);
     objSizes = cellfun(@numel, CC.PixelIdxList);
@@ -33,23 +33,32 @@ function createMesh(tifPath, objPath, libraryPath)
     imgVolume = resampleVoxelDimensions(imgVolume, curVoxDim, targetVoxDim);
 
 
-    % STEP 5: PAD VOLUME TO PREPARE FOR MESH GENERATION
-    fprintf('=== STARTING STEP 5: PAD VOLUME TO PREPARE FOR MESH GENERATION  ===\n');
-    padAmount = 3;
-    imgVolume = padarray(imgVolume, [padAmount, padAmount, padAmount], 0);
-    imgVolume(isnan(imgVolume)) = 0;
-
-
-    % STEP 6: GENERATE MESH
-    fprintf('=== STARTING STEP 6: GENERATE MESH  ===\n');
-    mesh = isosurface(imgVolume, 0.5);   % Creates mesh surface at the border between 0 and 1 pixels (0.5)
-    mesh.vertices = mesh.vertices - padAmount;
-
-
-    % STEP 7: POST-PROCESS MESH
-    fprintf('=== STARTING STEP 7: POST PROCESS MESH  ===\n');
-    mesh = removeSmallMeshes(mesh); % Remove small mesh fragments (Only keep largest connected component)
-    [mesh.vertices, mesh.faces] = checkAndRepairMesh(mesh.vertices, mesh.faces);    % Check and repair any other mesh
+    if exist('mask_isosurface','file') == 3
+        % STEPS 5-7: one pass surface extraction, the border counts as padding and
+        % vertices are welded while triangulating
+        fprintf('=== STARTING STEPS 5-7: GENERATE MESH (LARGEST COMPONENT) ===\n');
+        imgVolume(isnan(imgVolume)) = 0;
+        [mesh.vertices, mesh.faces] = mask_isosurface(imgVolume, 'Largest', true);
+        [mesh.vertices, mesh.faces] = checkAndRepairMesh(mesh.vertices, mesh.faces, 'deep');  % non-manifold repair only
+    else
+        % STEP 5: PAD VOLUME TO PREPARE FOR MESH GENERATION
+        fprintf('=== STARTING STEP 5: PAD VOLUME TO PREPARE FOR MESH GENERATION  ===\n');
+        padAmount = 3;
+        imgVolume = padarray(imgVolume, [padAmount, padAmount, padAmount], 0);
+        imgVolume(isnan(imgVolume)) = 0;
+
+
+        % STEP 6: GENERATE MESH
+        fprintf('=== STARTING STEP 6: GENERATE MESH  ===\n');
+        mesh = isosurface(imgVolume, 0.5);   % Creates mesh surface at the border between 0 and 1 pixels (0.5)
+        mesh.vertices = mesh.vertices - padAmount;
+
+
+        % STEP 7: POST-PROCESS MESH
+        fprintf('=== STARTING STEP 7: POST PROCESS MESH  ===\n');
+        mesh = removeSmallMeshes(mesh); % Remove small mesh fragments (Only keep largest connected component)
+        [mesh.vertices, mesh.faces] = checkAndRepairMesh(mesh.vertices, mesh.faces);    % Check and repair any other mesh
+    end
 
 
     % STEP 8: DECIMATE MESH
@@ -78,10 +78,15 @@ function computeSurfaceMeasures(meshMatPath, medialSurfacePath, outputFolder, li
     fprintf('\n=== STARTING STEP 3: PROJECT THICKNESS VALUES TO MESH ===\n');
     startTime = tic;
 
-    % resample to mesh surface
-    skelPtsTriangulation = delaunay(skelPts);
-    closestIdx = dsearchn(skelPts, skelPtsTriangulation, mesh.vertices);
-    medialThickness=medialThickness(skelIdx(closestIdx));
+    % resample to mesh surface (nearest skeleton point; the mex avoids
+    % building a delaunay triangulation of all skeleton points)
+    if exist('project_thickness', 'file') == 3
+        medialThickness = project_thickness(skelPts, medialThickness(skelIdx), mesh.vertices);
+    else
+        skelPtsTriangulation = delaunay(skelPts);
+        closestIdx = dsearchn(skelPts, skelPtsTriangulation, mesh.vertices);
+        medialThickness=medialThickness(skelIdx(closestIdx));
+    end
 
     elapsedTime = duration([0, 0, toc(startTime)]);
     fprintf('=== COMPLETED STEP 3: PROJECT THICKNESS VALUES TO MESH (TIME ELAPSED %s) ===\n\n', elapsedTime);
@@ -95,11 +100,19 @@ function computeSurfaceMeasures(meshMatPath, medialSurfacePath, outputFolder, li
     fprintf('\n=== STARTING STEP 4: COMPUTE PROTRUSION SCORES FOR ALL MESH VERTICES ===\n');
     startTime = tic;
 
-    [sourceNodes, targetNodes, hopCounts, ~] = getStepVectors(triangulation2adjacency(mesh.faces, mesh.vertices), 15);
-    %%
-    smMat = meshGaussian(sourceNodes, targetNodes, hopCounts, 3);
-    smInv = meshGaussian(sourceNodes, targetNodes, (max(hopCounts)+1-hopCounts), 1);
-    localAvg = smInv*mesh.vertices;
+    % The mex functions keep the 15-hop neighbourhoods as compact CSR arrays
+    % and smooth from them directly instead of building smMat and smInv
+    useHopMex = exist('k_hop_neighbourhood', 'file') == 3 && exist('hop_gaussian_smooth', 'file') == 3;
+    if useHopMex
+        [khopOffsets, khopIds, khopHops] = k_hop_neighbourhood(mesh.faces, 15, size(mesh.vertices, 1));
+        localAvg = squeeze(hop_gaussian_smooth(khopOffsets, khopIds, khopHops, mesh.vertices, 1, 1, 'Reverse', true));
+    else
+        [sourceNodes, targetNodes, hopCounts, ~] = getStepVectors(triangulation2adjacency(mesh.faces, mesh.vertices), 15);
+        %%
+        smMat = meshGaussian(sourceNodes, targetNodes, hopCounts, 3);
+        smInv = meshGaussian(sourceNodes, targetNodes, (max(hopCounts)+1-hopCounts), 1);
+        localAvg = smInv*mesh.vertices;
+    end
     diffVect = mesh.vertices-localAvg;
     D = sqrt(sum(diffVect.^2, 2));
 
@@ -114,51 +127,63 @@ function computeSurfaceMeasures(meshMatPath, medialSurfacePath, outputFolder, li
     fprintf('\n=== STARTING STEP 5: SMOOTH PROTRUSION AND THICKNESS SCORES ===\n');
     startTime = tic;
 
-    % Smooth protrusion scores
-    % Initialize
-    smoothedDistMap = D;
     smoothingSteps = [5, 5, 10, 10, 10];
     numSteps = length(smoothingSteps);
-    allProtrusionVals = zeros(size(mesh.vertices, 1), numSteps);
-
-    fprintf('\n\nStarting protrusion distance smoothing...\n');
-
-    % Apply smoothing iteratively
-    totalIterations = 0;
-    for i = 1:numSteps
-        stepCount = smoothingSteps(i);
-        totalIterations = totalIterations + stepCount;
-
-        tStart = tic;
-        [smoothedDistMap, changeAmount] = contSmooth(smoothedDistMap, smMat, stepCount);
-        elapsed = toc(tStart);
-
-        allProtrusionVals(:, i) = smoothedDistMap;
-
-        fprintf('Smoothing: %d iterations done in %.2f seconds\n', totalIterations, elapsed);
-        fprintf('         -> %dx smoothed result stored\n\n', totalIterations);
-    end
-
-    % Smooth thickness
-    % Initialize
-    smoothedThk = medialThickness;  
-    allThicknessVals = zeros(size(mesh.vertices, 1), numSteps);
-
-    fprintf('\n\nStarting thickness smoothing...\n');
-
-    totalIterations = 0;
-    for i = 1:numSteps
-        stepCount = smoothingSteps(i);
-        totalIterations = totalIterations + stepCount;
 
+    if useHopMex
+        % Smooth protrusion and thickness together, storing every checkpoint
+        fprintf('\n\nStarting protrusion distance and thickness smoothing...\n');
         tStart = tic;
-        [smoothedThk, changeAmount] = contSmooth(smoothedThk, smMat, stepCount);
-        elapsed = toc(tStart);
-
-        allThicknessVals(:, i) = smoothedThk;
-
-        fprintf('Smoothing: %d iterations done in %.2f seconds\n', totalIterations, elapsed);
-        fprintf('         -> %dx smoothed result stored\n\n', totalIterations);
+        smoothedVals = hop_gaussian_smooth(khopOffsets, khopIds, khopHops, [D, medialThickness], 3, smoothingSteps);
+        allProtrusionVals = smoothedVals(:, :, 1);
+        allThicknessVals = smoothedVals(:, :, 2);
+        clear smoothedVals
+        fprintf('Smoothing: %d iterations done in %.2f seconds\n', sum(smoothingSteps), toc(tStart));
+    else
+        % Smooth protrusion scores
+        % Initialize
+        smoothedDistMap = D;
+        allProtrusionVals = zeros(size(mesh.vertices, 1), numSteps);
+
+        fprintf('\n\nStarting protrusion distance smoothing...\n');
+
+        % Apply smoothing iteratively
+        totalIterations = 0;
+        for i = 1:numSteps
+            stepCount = smoothingSteps(i);
+            totalIterations = totalIterations + stepCount;
+
+            tStart = tic;
+            [smoothedDistMap, changeAmount] = contSmooth(smoothedDistMap, smMat, stepCount);
+            elapsed = toc(tStart);
+
+            allProtrusionVals(:, i) = smoothedDistMap;
+
+            fprintf('Smoothing: %d iterations done in %.2f seconds\n', totalIterations, elapsed);
+            fprintf('         -> %dx smoothed result stored\n\n', totalIterations);
+        end
+
+        % Smooth thickness
+        % Initialize
+        smoothedThk = medialThickness;  
+        allThicknessVals = zeros(size(mesh.vertices, 1), numSteps);
+
+        fprintf('\n\nStarting thickness smoothing...\n');
+
+        totalIterations = 0;
+        for i = 1:numSteps
+            stepCount = smoothingSteps(i);
+            totalIterations = totalIterations + stepCount;
+
+            tStart = tic;
+            [smoothedThk, changeAmount] = contSmooth(smoothedThk, smMat, stepCount);
+            elapsed = toc(tStart);
+
+            allThicknessVals(:, i) = smoothedThk;
+
+            fprintf('Smoothing: %d iterations done in %.2f seconds\n', totalIterations, elapsed);
+            fprintf('         -> %dx smoothed result stored\n\n', totalIterations);
+        end
     end
 
     % Append unsmoothed values
@@ -209,7 +234,11 @@ function computeSurfaceMeasures(meshMatPath, medialSurfacePath, outputFolder, li
     tic
 
     %%
-    save(meshDataMatPath, "mesh", "targetNodes", "sourceNodes", "hopCounts", "-v7.3");
+    if useHopMex
+        save(meshDataMatPath, "mesh", "khopOffsets", "khopIds", "khopHops", "-v7.3");
+    else
+        save(meshDataMatPath, "mesh", "targetNodes", "sourceNodes", "hopCounts", "-v7.3");
+    end
     fprintf('Step vectors saved  in %f seconds\n', toc);
 
     elapsedTime = duration([0, 0, toc(startTime)]);
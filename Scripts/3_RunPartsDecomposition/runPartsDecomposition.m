@@ -30,9 +30,20 @@ function runPartsDecomposition(meshDataMatPath, surfaceMeasuresMatPath, outputFo
     meshStruct = meshData.mesh;   % your actual mesh
     allNormMscoreVals = surfData.allNormMscoreVals;
     allNormThicknessVals = surfData.allNormThicknessVals;
-    sourceNodes = meshData.sourceNodes;
-    targetNodes = meshData.targetNodes;
-    hopCounts = meshData.hopCounts;
+    if isfield(meshData, 'khopOffsets')
+        % Compact k-hop neighbourhoods (k_hop_neighbourhood mex); only hops
+        % up to 5 are used below
+        sel = meshData.khopHops <= 5;
+        sourceNodes = repelem(uint32(1:numel(meshData.khopOffsets)-1)', diff(meshData.khopOffsets));
+        sourceNodes = double(sourceNodes(sel));
+        targetNodes = double(meshData.khopIds(sel));
+        hopCounts = double(meshData.khopHops(sel));
+        clear sel
+    else
+        sourceNodes = meshData.sourceNodes;
+        targetNodes = meshData.targetNodes;
+        hopCounts = meshData.hopCounts;
+    end
 
 
     fprintf('Contents of %s:\n', surfaceMeasuresMatPath);
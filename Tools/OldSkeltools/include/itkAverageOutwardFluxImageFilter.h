@@ -28,7 +28,9 @@
 
 #include <itkImageToImageFilter.h>
 #include <vector>
-#include <random>
+#include <algorithm>
+
+#include "itkFluxSphere.h"
 
 
 //using namespace std;
@@ -89,6 +91,15 @@ template< class TInputImage,
 			return ( static_cast< TInputVectorImage *>(this->ProcessObject::GetInput(1)) );
 		}
 
+		/** Distance from the boundary beyond which the flux is computed. */
+		itkSetMacro( ObjectThreshold, double );
+		itkGetConstReferenceMacro( ObjectThreshold, double );
+
+		/** Interpret the sampling sphere in physical space, see ComputeFluxNormals. */
+		itkSetMacro( UseImageSpacing, bool );
+		itkGetConstMacro( UseImageSpacing, bool );
+		itkBooleanMacro( UseImageSpacing );
+
 	protected:
         AverageOutwardFluxImageFilter();
         ~AverageOutwardFluxImageFilter() = default;
@@ -103,8 +114,10 @@ template< class TInputImage,
 		OutputPointerType m_AOF;
 private:
 		bool m_ObjectIsNegative;
-        void NormalsToASphere();
+		double m_ObjectThreshold = 8.5;
+		bool m_UseImageSpacing = false;
         std::vector< itk::Vector<double, TInputImage::ImageDimension> > m_Points;
+        std::vector< NormalType > m_FluxNormals;
 };
 
 #include "itkAverageOutwardFluxImageFilter.hxx"
@@ -20,58 +20,10 @@
 template< class TInputImage, class TOutputPixelType, class TInputVectorPixelType>
 AverageOutwardFluxImageFilter<TInputImage, TOutputPixelType, TInputVectorPixelType>::AverageOutwardFluxImageFilter(){
     this->m_ObjectIsNegative = true;
-    this->NormalsToASphere();
+    this->m_Points = NormalsToASphere<TInputImage::ImageDimension>();
     this->DynamicMultiThreadingOn();
 }
 
-template< class TInputImage, class TOutputPixelType, class TInputVectorPixelType>
-void
-AverageOutwardFluxImageFilter<TInputImage, TOutputPixelType, TInputVectorPixelType>::NormalsToASphere(){
-    std::random_device rd;  //Will be used to obtain a seed for the random number engine
-    std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
-    std::uniform_real_distribution<double > dis(0.0, 1.0);
-    constexpr unsigned Dimension = TInputImage::ImageDimension;
-    constexpr unsigned N = 60;
-    ::std::vector< NormalType > forces;
-    NormalType n;
-    for(size_t d = 0; d <Dimension;  ++d) n[d] = 0;
-    forces.push_back(n);
-    n[0] = 1.0;
-    this->m_Points.push_back(n);
-    for(size_t count = 0; count < N-1; ++count){
-        for(size_t d = 0; d < Dimension; ++d) {
-            n[d] = dis(gen);
-        }
-        n.Normalize();
-        //hope that no two point are the same.
-        this->m_Points.push_back(n);
-        forces.push_back(0.0*n);
-    }
-
-    double r;
-    NormalType forceVector;
-    int iteration = 0;
-    do {
-        for(size_t i=1;i<N;++i) {
-            forces[i] *= 0.0;                        // Initialize force vector zero
-            for(size_t j = 0; j<N ;++j){
-                if (i == j) continue;
-                forceVector = this->m_Points[i] - this->m_Points[j];
-                r = forceVector.GetNorm();
-                r *=r;
-                forceVector /= r;
-                forces[i] += forceVector; // Get contributing forces from other particles.
-            }
-        }
-        for(size_t i=1;i<N;++i) {
-            //move point on sphere.
-            this->m_Points[i] += forces[i];
-            this->m_Points[i].Normalize();
-        }
-    } while(++iteration<50);
-    itkDebugMacro("Finished Computing normals to sphere.");
-}
-
 /*
 template< class TInputImage, class TOutputPixelType, class TInputVectorPixelType>
 void
@@ -152,13 +104,15 @@ AverageOutwardFluxImageFilter<TInputImage, TOutputPixelType, TInputVectorPixelTy
     this->m_AOF->SetOrigin(this->m_Distance->GetOrigin());
     this->m_AOF->SetRegions(this->m_Distance->GetRequestedRegion());
     this->m_AOF->Allocate();
+    this->m_FluxNormals = ComputeFluxNormals(this->m_Points, FluxStepScale<TInputImage::ImageDimension>(
+            this->m_Distance->GetSpacing(), this->m_UseImageSpacing));
     // AOF and neighborhood iterators
     InputConstIteratorType dit = InputConstIteratorType(this->m_Distance, this->m_Distance->GetRequestedRegion());
     OutputIteratorType aofit = OutputIteratorType(this->m_AOF, this->m_AOF->GetRequestedRegion());
 
 
     // Computation of the average outward flux inside the object
-    double f = 0, objectThreshold = 8.5,inverseNorm;
+    double f = 0, objectThreshold = this->m_ObjectThreshold,inverseNorm;
     int sign = this->m_ObjectIsNegative ? -1 : 1;
 
     using BoundaryConditionType = itk::ZeroFluxNeumannBoundaryCondition<TInputVectorImage>;
@@ -168,7 +122,9 @@ AverageOutwardFluxImageFilter<TInputImage, TOutputPixelType, TInputVectorPixelTy
         f = 0.0;
         currentIndex = aofit.GetIndex();
         if (sign * dit.Get() >  objectThreshold) {
-            for (auto point: this->m_Points) {
+            for (size_t k = 0; k < this->m_Points.size(); ++k) {
+                const NormalType &point = this->m_Points[k];
+                const NormalType &normal = this->m_FluxNormals[k];
                 //get spoke vector.
                 for (size_t d = 0; d < TInputImage::ImageDimension; ++d) {
                     gradientIndex[d] = std::floor((static_cast<double>(currentIndex[d]) + point[d] + 0.5));
@@ -182,7 +138,7 @@ AverageOutwardFluxImageFilter<TInputImage, TOutputPixelType, TInputVectorPixelTy
                 inverseNorm = (inverseNorm > 0) ? 1 / inverseNorm : 0;
                 //compute dot product of normalized vectors
                 for (size_t d = 0; d < TInputImage::ImageDimension; ++d) {
-                    f -= (gradientVector[d] * inverseNorm * point[d]);
+                    f -= (gradientVector[d] * inverseNorm * normal[d]);
                 }
             }
         }
@@ -26,9 +26,12 @@
 #include <itkNeighborhoodIterator.h>
 #include <itkImageRegionConstIterator.h>
 #include <vector>
-#include <random>
+#include <algorithm>
 #include <cmath>
 
+#include "itkFluxSphere.h"
+#include "itkSpacingPolicy.h"
+
 //using namespace std;
 
 namespace itk
@@ -76,6 +79,11 @@ template< class TInputImage,
 
         using NormalType = itk::Vector<double, TInputImage::ImageDimension>;
 
+		/** Interpret the sampling sphere and the spokes in physical space, see ComputeFluxNormals. */
+		itkSetMacro( UseImageSpacing, bool );
+		itkGetConstMacro( UseImageSpacing, bool );
+		itkBooleanMacro( UseImageSpacing );
+
 	protected:
         AverageOutwardFluxImageFilter2();
         ~AverageOutwardFluxImageFilter2() = default;
@@ -87,12 +95,19 @@ template< class TInputImage,
 
         void GenerateInputRequestedRegion() override;
 
+        void BeforeThreadedGenerateData() override;
+
         void PrintSelf(std::ostream& os, Indent indent) const;
 
 private:
         void printpoints(std::vector<itk::Vector<double,3>>& list);
-        void NormalsToASphere();
+        /// \brief The AOF loop, specialised for the spacing policy matching m_StepScale.
+        template<typename TSpacingPolicy>
+        void ComputeFlux(const OutputImageRegionType &outputRegionForThread, const TSpacingPolicy &spacingPolicy);
+        bool m_UseImageSpacing = false;
         std::vector< itk::Vector<double, TInputImage::ImageDimension> > m_Points;
+        std::vector< NormalType > m_FluxNormals;
+        NormalType m_StepScale;
 };
 } // end namespace itk
 #ifndef ITK_MANUAL_INSTANTIATION
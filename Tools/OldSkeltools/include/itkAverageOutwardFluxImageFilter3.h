@@ -26,9 +26,11 @@
 #include <itkNeighborhoodIterator.h>
 #include <itkImageRegionConstIterator.h>
 #include <vector>
-#include <random>
+#include <algorithm>
 #include <cmath>
 
+#include "itkFluxSphere.h"
+
 //using namespace std;
 
 namespace itk
@@ -76,6 +78,11 @@ template< class TInputImage, //::itk::Image<::itk::CovariantVector<TOutputPixelT
 
         using NormalType = itk::Vector<double, TInputImage::ImageDimension>;
 
+		/** Interpret the sampling sphere in physical space, see ComputeFluxNormals. */
+		itkSetMacro( UseImageSpacing, bool );
+		itkGetConstMacro( UseImageSpacing, bool );
+		itkBooleanMacro( UseImageSpacing );
+
 	protected:
         AverageOutwardFluxImageFilter3();
         ~AverageOutwardFluxImageFilter3() = default;
@@ -87,11 +94,14 @@ template< class TInputImage, //::itk::Image<::itk::CovariantVector<TOutputPixelT
 
         void GenerateInputRequestedRegion() override;
 
+        void BeforeThreadedGenerateData() override;
+
         void PrintSelf(std::ostream& os, Indent indent) const;
 
 private:
-        void NormalsToASphere();
+        bool m_UseImageSpacing = false;
         std::vector< itk::Vector<double, TInputImage::ImageDimension> > m_Points;
+        std::vector< NormalType > m_FluxNormals;
 };
 } // end namespace itk
 #ifndef ITK_MANUAL_INSTANTIATION
@@ -26,7 +26,7 @@ namespace itk {
     template<class TInputImage, class TOutputPixelType>
     AverageOutwardFluxImageFilter3<TInputImage, TOutputPixelType>::AverageOutwardFluxImageFilter3() {
         this->DynamicMultiThreadingOn();
-        this->NormalsToASphere();
+        this->m_Points = NormalsToASphere<TInputImage::ImageDimension>();
     }
 
     template<class TInputImage, class TOutputPixelType>
@@ -93,50 +93,9 @@ namespace itk {
 
     template<class TInputImage, class TOutputPixelType>
     void
-    AverageOutwardFluxImageFilter3<TInputImage, TOutputPixelType>::NormalsToASphere() {
-        ::std::random_device rd;  //Will be used to obtain a seed for the random number engine
-        ::std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
-        ::std::uniform_real_distribution<double> dis(0.0, 1.0);
-        constexpr unsigned Dimension = TInputImage::ImageDimension;
-        constexpr unsigned N = 60;
-        ::std::vector<NormalType> forces;
-        NormalType n;
-        for (size_t d = 0; d < Dimension; ++d) n[d] = 0;
-        forces.push_back(n);
-        n[0] = 1.0;
-        this->m_Points.push_back(n);
-        for (size_t count = 0; count < N - 1; ++count) {
-            for (size_t d = 0; d < Dimension; ++d) {
-                n[d] = dis(gen);
-            }
-            n.Normalize();
-            //hope that no two point are the same.
-            this->m_Points.push_back(n);
-            forces.push_back(0.0 * n);
-        }
-
-        double r;
-        NormalType forceVector;
-        int iteration = 0;
-        do {
-            for (size_t i = 1; i < N; ++i) {
-                forces[i] *= 0.0;                        // Initialize force vector zero
-                for (size_t j = 0; j < N; ++j) {
-                    if (i == j) continue;
-                    forceVector = this->m_Points[i] - this->m_Points[j];
-                    r = forceVector.GetNorm();
-                    r *= r;
-                    forceVector /= r;
-                    forces[i] += forceVector; // Get contributing forces from other particles.
-                }
-            }
-            for (size_t i = 1; i < N; ++i) {
-                //move point on sphere.
-                this->m_Points[i] += forces[i];
-                this->m_Points[i].Normalize();
-            }
-        } while (++iteration < 50);
-        itkDebugMacro("Finished Computing normals to sphere.");
+    AverageOutwardFluxImageFilter3<TInputImage, TOutputPixelType>::BeforeThreadedGenerateData() {
+        this->m_FluxNormals = ComputeFluxNormals(this->m_Points, FluxStepScale<TInputImage::ImageDimension>(
+                this->GetInput()->GetSpacing(), this->m_UseImageSpacing));
     }
 
 
@@ -155,7 +114,9 @@ namespace itk {
         for (aofIt.GoToBegin(); !aofIt.IsAtEnd(); ++aofIt) {
             f = 0.0;
             currentIndex = aofIt.GetIndex();
-            for (auto point: this->m_Points) {
+            for (size_t k = 0; k < this->m_Points.size(); ++k) {
+                const NormalType &point = this->m_Points[k];
+                const NormalType &normal = this->m_FluxNormals[k];
                 //get gradient vector.
                 for (size_t d = 0; d < TInputImage::ImageDimension; ++d) {
                     gradientIndex[d] = std::floor((static_cast<double>(currentIndex[d]) + point[d] + 0.5));
@@ -169,7 +130,7 @@ namespace itk {
                 inverseNorm = (inverseNorm > 0) ? 1 / inverseNorm : 0;
                 //compute dot product of normalized vectors
                 for (size_t d = 0; d < TInputImage::ImageDimension; ++d) {
-                    f -= (gradientVector[d] * inverseNorm * point[d]);
+                    f -= (gradientVector[d] * inverseNorm * normal[d]);
                 }
             }
 
@@ -0,0 +1,118 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+#ifndef SKELTOOLS_ITKFLUXSPHERE_H
+#define SKELTOOLS_ITKFLUXSPHERE_H
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <itkVector.h>
+
+namespace itk
+{
+
+/// \brief N points spread over the unit sphere by repulsion, the first one on the x axis.
+///
+/// The start points come from a fixed seed, so every filter and every run samples the same
+/// directions and AOF values computed separately (e.g. a patch and the image around it) agree.
+template<unsigned int VDimension>
+std::vector<Vector<double, VDimension> > NormalsToASphere(unsigned int N = 60)
+{
+    std::mt19937 gen(5489u);
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    using NormalType = Vector<double, VDimension>;
+    std::vector<NormalType> points, forces;
+    NormalType n;
+    for (unsigned int d = 0; d < VDimension; ++d) n[d] = 0;
+    forces.push_back(n);
+    n[0] = 1.0;
+    points.push_back(n);
+    for (unsigned int count = 0; count < N - 1; ++count) {
+        for (unsigned int d = 0; d < VDimension; ++d) {
+            n[d] = dis(gen);
+        }
+        n.Normalize();
+        //hope that no two point are the same.
+        points.push_back(n);
+        forces.push_back(0.0 * n);
+    }
+
+    double r;
+    NormalType forceVector;
+    int iteration = 0;
+    do {
+        for (unsigned int i = 1; i < N; ++i) {
+            forces[i] *= 0.0;                        // Initialize force vector zero
+            for (unsigned int j = 0; j < N; ++j) {
+                if (i == j) continue;
+                forceVector = points[i] - points[j];
+                r = forceVector.GetNorm();
+                r *= r;
+                forceVector /= r;
+                forces[i] += forceVector; // Get contributing forces from other particles.
+            }
+        }
+        for (unsigned int i = 1; i < N; ++i) {
+            //move point on sphere.
+            points[i] += forces[i];
+            points[i].Normalize();
+        }
+    } while (++iteration < 50);
+    return points;
+}
+
+/// \brief Spacing relative to the finest axis with useImageSpacing, all ones without.
+template<unsigned int VDimension, typename TSpacing>
+Vector<double, VDimension> FluxStepScale(const TSpacing &spacing, bool useImageSpacing)
+{
+    double minSpacing = spacing[0];
+    for (unsigned int d = 1; d < VDimension; ++d) minSpacing = std::min<double>(minSpacing, spacing[d]);
+    Vector<double, VDimension> scale;
+    for (unsigned int d = 0; d < VDimension; ++d) scale[d] = useImageSpacing ? spacing[d] / minSpacing : 1.0;
+    return scale;
+}
+
+/// \brief Normals the AOF filters dot the flux at each sample of the unit sphere points with.
+///
+/// The AOF filters sample a unit sphere in index space, which is the ellipsoid S p in physical
+/// space (S = scale, the spacing relative to the finest axis), with outward normal S^-1 p / |S^-1 p|.
+/// The samples are spread evenly over the sphere, so the ellipsoid area of sample k is
+/// a_k = det(S) |S^-1 p_k| times its sphere area and the average outward flux is
+/// sum_k a_k F.n_k / sum_k a_k = sum_k F.S^-1 p_k / sum_k |S^-1 p_k|. Like the isotropic -sum_k F.p_k
+/// it is reported as N times the average, so for a unit scale the normals are the points.
+template<unsigned int VDimension>
+std::vector<Vector<double, VDimension> >
+ComputeFluxNormals(const std::vector<Vector<double, VDimension> > &points, const Vector<double, VDimension> &scale)
+{
+    std::vector<Vector<double, VDimension> > normals(points);
+    bool unitScale = true;
+    for (unsigned int d = 0; d < VDimension; ++d) unitScale = unitScale && scale[d] == 1.0;
+    if (unitScale) return normals;
+
+    double area = 0.0;
+    for (auto &normal: normals) {
+        for (unsigned int d = 0; d < VDimension; ++d) normal[d] /= scale[d];
+        area += normal.GetNorm();
+    }
+    for (auto &normal: normals) normal *= points.size() / area;
+    return normals;
+}
+
+} // end namespace itk
+
+#endif //SKELTOOLS_ITKFLUXSPHERE_H
@@ -57,6 +57,10 @@ namespace itk
     using IndexType = typename TInputImage::IndexType;
     using BoundaryConditionType = itk::ConstantBoundaryCondition<TInputImage>;
 
+    /** Topological class of index in skeleton (2 interior, 3 isolated, 4 simple, 5 curve, 6 curves
+     *  junction, 7 surface, 8 surface-curve junction, 9 surfaces junction, 10 surfaces-curve junction). */
+    unsigned GetTopologicalLabel(const TInputImage *skeleton, IndexType index) const;
+
     protected:
         PostProcessSkeleton();
         ~PostProcessSkeleton() = default;
@@ -67,9 +71,9 @@ namespace itk
         void PrintSelf(std::ostream& os, Indent indent) const;
 
     private:
-        unsigned TopologicalLabel(IndexType index);
-        unsigned ForegroudLabelling(IndexType& index);
-        unsigned BackgroundLabelling(IndexType& index);
+        unsigned TopologicalLabel(const TInputImage *image, IndexType index) const;
+        unsigned ForegroudLabelling(const TInputImage *image, IndexType& index) const;
+        unsigned BackgroundLabelling(const TInputImage *image, IndexType& index) const;
 
         std::vector<itk::Offset<3>> m_Neighbors26, m_Neighbors18;
         std::vector<std::vector<size_t>> m_Graph26, m_Graph18;
@@ -123,7 +123,7 @@ PostProcessSkeleton<TInputImage>::PostProcessSkeleton(){
 
 template< class TInputImage>
 unsigned
-PostProcessSkeleton<TInputImage>::BackgroundLabelling(IndexType& index){
+PostProcessSkeleton<TInputImage>::BackgroundLabelling(const TInputImage *image, IndexType& index) const{
 
 
     unsigned regions = 0;
@@ -131,7 +131,7 @@ PostProcessSkeleton<TInputImage>::BackgroundLabelling(IndexType& index){
     std::vector<bool> visited(18,false);
     for(size_t i = 0; i < m_Neighbors18.size(); ++i){ // starting point
         if( (m_n6[i]) && (! visited[i]) &&                       // not already visited
-            (m_Accessor.GetPixel(index + m_Neighbors18[i], this->m_Output) <= 0)){     // is outside object
+            (m_Accessor.GetPixel(index + m_Neighbors18[i], image) <= 0)){     // is outside object
             ++regions; // new component
             Q.push(i);
             visited[i] = true;
@@ -142,7 +142,7 @@ PostProcessSkeleton<TInputImage>::BackgroundLabelling(IndexType& index){
                 for(size_t neighbor : m_Graph18[current]){
                     --neighbor;
                     if((!visited[neighbor]) &&
-                       (m_Accessor.GetPixel(index + m_Neighbors18[neighbor], this->m_Output) <= 0)){
+                       (m_Accessor.GetPixel(index + m_Neighbors18[neighbor], image) <= 0)){
                         visited[neighbor] = true;
                         Q.push(neighbor);
                     }
@@ -156,13 +156,13 @@ PostProcessSkeleton<TInputImage>::BackgroundLabelling(IndexType& index){
 
 template< class TInputImage>
 unsigned
-PostProcessSkeleton<TInputImage>::ForegroudLabelling(IndexType& index){
+PostProcessSkeleton<TInputImage>::ForegroudLabelling(const TInputImage *image, IndexType& index) const{
     unsigned regions = 0;
     std::queue<size_t> Q;
     std::vector<bool> visited(26,false);
     for(size_t i = 0; i < m_Neighbors26.size(); ++i){ // starting point
         if( (! visited[i]) &&                       // not already visited
-            (m_Accessor.GetPixel(index + m_Neighbors26[i], this->m_Output) > 0)){     // is in object
+            (m_Accessor.GetPixel(index + m_Neighbors26[i], image) > 0)){     // is in object
             ++regions; // new component
             Q.push(i);
             visited[i] = true;
@@ -173,7 +173,7 @@ PostProcessSkeleton<TInputImage>::ForegroudLabelling(IndexType& index){
                 for(size_t neighbor : m_Graph26[current]){
                     --neighbor;
                     if((!visited[neighbor]) &&
-                       (m_Accessor.GetPixel(index + m_Neighbors26[neighbor], this->m_Output) > 0)){
+                       (m_Accessor.GetPixel(index + m_Neighbors26[neighbor], image) > 0)){
                         visited[neighbor] = true;
                         Q.push(neighbor);
                     }
@@ -187,9 +187,9 @@ PostProcessSkeleton<TInputImage>::ForegroudLabelling(IndexType& index){
 
 template< class TInputImage>
 unsigned
-PostProcessSkeleton<TInputImage>::TopologicalLabel(IndexType index){
-    unsigned Cstar = this->ForegroudLabelling(index);
-    unsigned Cbar = this->BackgroundLabelling(index);
+PostProcessSkeleton<TInputImage>::TopologicalLabel(const TInputImage *image, IndexType index) const{
+    unsigned Cstar = this->ForegroudLabelling(image, index);
+    unsigned Cbar = this->BackgroundLabelling(image, index);
     unsigned label;
     if (Cbar==0)
         label =   2 ; //interior point
@@ -215,6 +215,12 @@ PostProcessSkeleton<TInputImage>::TopologicalLabel(IndexType index){
     return label;
 }
 
+template< class TInputImage>
+unsigned
+PostProcessSkeleton<TInputImage>::GetTopologicalLabel(const TInputImage *skeleton, IndexType index) const{
+    return this->TopologicalLabel(skeleton, index);
+}
+
 template< class TInputImage>
 void
 PostProcessSkeleton<TInputImage>::GenerateData() {
@@ -237,7 +243,7 @@ PostProcessSkeleton<TInputImage>::GenerateData() {
     while(!outIt.IsAtEnd()) {
         if (outIt.Get() > 0) {
             IndexType index = outIt.GetIndex();
-            unsigned label = this->TopologicalLabel(index);
+            unsigned label = this->TopologicalLabel(this->m_Output.GetPointer(), index);
             if (label == 3 || label == 5 || label == 6) {
                 outIt.Set(0);
             }
@@ -0,0 +1,93 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+#ifndef SKELTOOLS_ITKSPACINGPOLICY_H
+#define SKELTOOLS_ITKSPACINGPOLICY_H
+
+#include <cmath>
+
+#include <itkVector.h>
+
+namespace itk
+{
+
+/// \brief Shape of a voxel, used to select a compile time specialisation of the per voxel kernels.
+enum class SpacingKind {
+    Isotropic,  // sx == sy == sz
+    Axial,      // sx == sy < sz, e.g. 4.13 x 4.13 x 8 (about 2:1)
+    General
+};
+
+/// \brief Classifies a scale (spacing relative to the finest axis, so its smallest entry is 1).
+template<unsigned int VDimension>
+SpacingKind ClassifySpacing(const Vector<double, VDimension> &scale, double tolerance = 1e-3)
+{
+    for (unsigned int d = 0; d + 1 < VDimension; ++d) {
+        if (std::abs(scale[d] - 1.0) > tolerance) return SpacingKind::General;
+    }
+    return std::abs(scale[VDimension - 1] - 1.0) > tolerance ? SpacingKind::Axial : SpacingKind::Isotropic;
+}
+
+/// \brief Spacing policies. Scale(v) converts an index space vector to physical units relative
+/// to the finest axis, so a kernel written against a policy compiles down to no scaling for
+/// isotropic data and a single multiply along z for the usual axially anisotropic stacks.
+template<unsigned int VDimension>
+struct IsotropicSpacingPolicy {
+    static constexpr SpacingKind Kind = SpacingKind::Isotropic;
+    explicit IsotropicSpacingPolicy(const Vector<double, VDimension> &) {}
+    template<typename TVector>
+    void Scale(TVector &) const {}
+};
+
+template<unsigned int VDimension>
+struct AxialSpacingPolicy {
+    static constexpr SpacingKind Kind = SpacingKind::Axial;
+    explicit AxialSpacingPolicy(const Vector<double, VDimension> &scale) : m_Ratio(scale[VDimension - 1]) {}
+    template<typename TVector>
+    void Scale(TVector &v) const { v[VDimension - 1] *= m_Ratio; }
+private:
+    double m_Ratio;
+};
+
+template<unsigned int VDimension>
+struct GeneralSpacingPolicy {
+    static constexpr SpacingKind Kind = SpacingKind::General;
+    explicit GeneralSpacingPolicy(const Vector<double, VDimension> &scale) : m_Scale(scale) {}
+    template<typename TVector>
+    void Scale(TVector &v) const { for (unsigned int d = 0; d < VDimension; ++d) v[d] *= m_Scale[d]; }
+private:
+    Vector<double, VDimension> m_Scale;
+};
+
+/// \brief Calls compute(policy) with the spacing policy matching scale.
+template<unsigned int VDimension, typename TCompute>
+void DispatchOnSpacing(const Vector<double, VDimension> &scale, TCompute &&compute)
+{
+    switch (ClassifySpacing(scale)) {
+        case SpacingKind::Isotropic:
+            compute(IsotropicSpacingPolicy<VDimension>(scale));
+            break;
+        case SpacingKind::Axial:
+            compute(AxialSpacingPolicy<VDimension>(scale));
+            break;
+        default:
+            compute(GeneralSpacingPolicy<VDimension>(scale));
+    }
+}
+
+} // end namespace itk
+
+#endif //SKELTOOLS_ITKSPACINGPOLICY_H
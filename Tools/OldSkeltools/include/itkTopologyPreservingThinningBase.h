@@ -161,7 +161,10 @@ namespace itk
         /// in the 18 neighborhood.
         virtual bool IsExtSimple( OutputIndexType p );
 
-        ///\brief Returns true if the point has less than two object neighbors.
+        ///\brief Returns true if the point has less than two object neighbors. This is a topological
+        /// count and needs no spacing: resampling z finer only splits voxels along z, which leaves the
+        /// end points of a thin object where they were. The spacing reaches the thinning through the
+        /// physical distance map and AOF that order the deletions.
         virtual bool IsEnd( OutputIndexType p );
 
         ///\brief Computes the binary object from its  signed m_Distance transform representation.
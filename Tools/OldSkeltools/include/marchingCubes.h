@@ -0,0 +1,63 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+
+#ifndef SKELTOOLS_MARCHINGCUBES_H
+#define SKELTOOLS_MARCHINGCUBES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// \brief Options of extractSurface.
+struct SurfaceOptions {
+    /// iso value; voxels above it are inside.
+    double level = 0.5;
+    /// keep only the connected component with the most vertices (the first one on ties).
+    bool keepLargest = false;
+    /// number of cube layers along the slowest axis triangulated at once by one thread.
+    std::size_t slabDepth = 32;
+    /// 0 uses std::thread::hardware_concurrency().
+    unsigned numThreads = 0;
+};
+
+/// \brief Indexed triangle mesh with every vertex referenced by a face.
+struct SurfaceMesh {
+    std::vector<std::array<double, 3>> vertices;
+    std::vector<std::array<uint32_t, 3>> faces;
+    /// connected components before keepLargest (0 if it was not requested).
+    uint64_t numComponents = 0;
+};
+
+/// \brief Marching cubes surface of input at options.level.
+///
+/// input is an x fastest buffer of size[0] x size[1] x size[2] voxels. Voxels past the border count
+/// as 0 (and NaN as 0), so objects touching it are closed without padding the volume. Vertices are
+/// placed at voxel index * spacing, interpolated linearly along the crossed grid edge, and faces are
+/// oriented with their normals pointing out of the voxels above the level.
+///
+/// Cube configurations are triangulated from their faces: on a face with two diagonal inside
+/// corners the inside corners are joined, and every face is resolved identically from both of its
+/// cubes, so the surface is closed. Slabs of cube layers are triangulated in parallel; each slab
+/// welds its vertices with a hash from grid edge id to vertex, and the vertices of the edges on a
+/// slab's top plane are taken from the slab above, so no vertex is ever duplicated.
+template<typename TPixel>
+SurfaceMesh extractSurface(const TPixel *input, const std::array<std::size_t, 3> &size,
+                           const std::array<double, 3> &spacing, const SurfaceOptions &options);
+
+#include "marchingCubes.hxx"
+#endif //SKELTOOLS_MARCHINGCUBES_H
@@ -0,0 +1,284 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+
+#ifndef SKELTOOLS_MARCHINGCUBES_HXX
+#define SKELTOOLS_MARCHINGCUBES_HXX
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+#include "streamingUtils.h"
+
+namespace streaming {
+
+    /// cube corner c is at (c & 1, c >> 1 & 1, c >> 2 & 1); cube edge e runs along axis e / 4 from
+    /// the corner whose other two coordinates are the bits of e % 4.
+    inline int cubeEdgeCorner(int edge) {
+        const int axis = edge / 4, u = (axis + 1) % 3, v = (axis + 2) % 3;
+        return ((edge & 1) << u) | ((edge >> 1 & 1) << v);
+    }
+
+    inline int cubeEdgeBetween(int cornerA, int cornerB) {
+        const int low = std::min(cornerA, cornerB), bit = cornerA ^ cornerB;
+        const int axis = bit == 1 ? 0 : (bit == 2 ? 1 : 2), u = (axis + 1) % 3, v = (axis + 2) % 3;
+        return axis * 4 + (low >> u & 1) + 2 * (low >> v & 1);
+    }
+
+    /// bit 2 * axis + side for each of the two cube faces containing the edge.
+    inline int cubeEdgeFaces(int edge) {
+        const int axis = edge / 4, corner = cubeEdgeCorner(edge);
+        int faces = 0;
+        for (int a = 0; a < 3; ++a) {
+            if (a != axis) faces |= 1 << (2 * a + (corner >> a & 1));
+        }
+        return faces;
+    }
+
+    using CubeTriangles = std::array<std::vector<std::array<uint8_t, 3>>, 256>;
+
+    /// triangles (as cube edges) of every configuration of inside corners.
+    ///
+    /// On each face the isoline runs from the edge where the counter-clockwise walk (seen from
+    /// outside the cube) enters the inside corners to the edge where it last left them, which joins
+    /// the inside corners of ambiguous faces. Every crossed edge starts exactly one face segment, so
+    /// the segments close into loops that are triangulated as fans.
+    inline const CubeTriangles &cubeTriangles() {
+        static const CubeTriangles table = [] {
+            CubeTriangles triangles;
+            for (int config = 0; config < 256; ++config) {
+                auto inside = [config](int corner) { return (config >> corner & 1) != 0; };
+                int next[12];
+                std::fill(next, next + 12, -1);
+                for (int axis = 0; axis < 3; ++axis) {
+                    const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+                    for (int side = 0; side < 2; ++side) {
+                        static const int cycle[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+                        int corners[4];
+                        for (int k = 0; k < 4; ++k) {
+                            const int *uv = cycle[side ? k : (4 - k) % 4];
+                            corners[k] = (side << axis) | (uv[0] << u) | (uv[1] << v);
+                        }
+                        for (int k = 0; k < 4; ++k) {
+                            const int a = corners[k], b = corners[(k + 1) % 4];
+                            if (inside(a) || !inside(b)) continue;
+                            // the walk enters the inside at b: end at the edge where it last left it
+                            for (int m = 3; m >= 1; --m) {
+                                const int c = corners[(k + m) % 4], d = corners[(k + m + 1) % 4];
+                                if (inside(c) && !inside(d)) {
+                                    next[cubeEdgeBetween(a, b)] = cubeEdgeBetween(c, d);
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+                bool visited[12] = {false};
+                for (int first = 0; first < 12; ++first) {
+                    if (next[first] < 0 || visited[first]) continue;
+                    std::vector<uint8_t> loop;
+                    for (int e = first; !visited[e]; e = next[e]) {
+                        visited[e] = true;
+                        loop.push_back(static_cast<uint8_t>(e));
+                    }
+                    // fan from a vertex none of whose triangles lies in a cube face, as the
+                    // neighbouring cube would triangulate the same face the other way round
+                    const std::size_t k = loop.size();
+                    std::size_t apex = 0;
+                    for (; apex < k; ++apex) {
+                        bool flat = false;
+                        for (std::size_t i = 1; i + 1 < k; ++i) {
+                            flat = flat || (cubeEdgeFaces(loop[apex]) & cubeEdgeFaces(loop[(apex + i) % k]) &
+                                            cubeEdgeFaces(loop[(apex + i + 1) % k])) != 0;
+                        }
+                        if (!flat) break;
+                    }
+                    for (std::size_t i = 1; i + 1 < k; ++i) {
+                        triangles[config].push_back({{loop[apex % k], loop[(apex + i) % k], loop[(apex + i + 1) % k]}});
+                    }
+                }
+            }
+            return triangles;
+        }();
+        return table;
+    }
+
+    /// triangles of one slab of cube layers, indexed into its own welded vertices.
+    struct SlabSurface {
+        std::unordered_map<uint64_t, uint32_t> vertexOfEdge;
+        std::vector<std::array<double, 3>> vertices;
+        /// grid edge of every vertex.
+        std::vector<uint64_t> edges;
+        std::vector<std::array<uint32_t, 3>> faces;
+        /// vertices on edges of the slab, the others lie on the bottom plane of the next slab.
+        uint32_t numOwned = 0;
+    };
+}
+
+template<typename TPixel>
+SurfaceMesh extractSurface(const TPixel *input, const std::array<std::size_t, 3> &size,
+                           const std::array<double, 3> &spacing, const SurfaceOptions &options) {
+    using namespace streaming;
+    SurfaceMesh mesh;
+    const std::size_t nx = size[0], ny = size[1], nz = size[2];
+    if (nx == 0 || ny == 0 || nz == 0) return mesh;
+    // grid of voxel centres padded with one outside voxel on every side, and its cube layers
+    const std::size_t gx = nx + 2, gy = ny + 2, planeSize = gx * gy, numLayers = nz + 1;
+    const std::size_t slabDepth = std::max<std::size_t>(1, options.slabDepth);
+    const std::size_t numSlabs = (numLayers + slabDepth - 1) / slabDepth;
+    unsigned numThreads = options.numThreads;
+    if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+    const CubeTriangles &table = cubeTriangles();
+    const double level = options.level;
+
+    auto value = [&](std::size_t x, std::size_t y, std::size_t z) -> double {
+        if (x == 0 || y == 0 || z == 0 || x > nx || y > ny || z > nz) return 0;
+        const double v = static_cast<double>(input[((z - 1) * ny + (y - 1)) * nx + (x - 1)]);
+        return v == v ? v : 0;
+    };
+    auto fillPlane = [&](std::size_t z, std::vector<uint8_t> &plane) {
+        plane.assign(planeSize, 0);
+        if (z == 0 || z > nz) return;
+        for (std::size_t y = 1; y <= ny; ++y) {
+            for (std::size_t x = 1; x <= nx; ++x) plane[y * gx + x] = value(x, y, z) > level;
+        }
+    };
+
+    // Pass 1: triangulate every slab, welding its vertices by grid edge
+    std::vector<SlabSurface> slabs(numSlabs);
+    parallelFor(numSlabs, numThreads, [&](std::size_t s, unsigned) {
+        const std::size_t l0 = s * slabDepth, l1 = std::min(numLayers, l0 + slabDepth);
+        SlabSurface &slab = slabs[s];
+        std::vector<uint8_t> planes[2];
+        fillPlane(l0, planes[1]);
+        for (std::size_t l = l0; l < l1; ++l) {
+            std::swap(planes[0], planes[1]);
+            fillPlane(l + 1, planes[1]);
+            for (std::size_t y = 0; y + 1 < gy; ++y) {
+                for (std::size_t x = 0; x + 1 < gx; ++x) {
+                    int config = 0;
+                    for (int c = 0; c < 8; ++c) {
+                        config |= planes[c >> 2][(y + (c >> 1 & 1)) * gx + x + (c & 1)] << c;
+                    }
+                    if (table[config].empty()) continue;
+                    int64_t cubeVertex[12];
+                    std::fill(cubeVertex, cubeVertex + 12, -1);
+                    auto vertexOf = [&](int e) -> uint32_t {
+                        if (cubeVertex[e] >= 0) return static_cast<uint32_t>(cubeVertex[e]);
+                        const int corner = cubeEdgeCorner(e), axis = e / 4;
+                        const std::size_t p[3] = {x + (corner & 1), y + (corner >> 1 & 1), l + (corner >> 2 & 1)};
+                        const uint64_t edge = ((p[2] * gy + p[1]) * gx + p[0]) * 3 + axis;
+                        auto inserted = slab.vertexOfEdge.emplace(edge, static_cast<uint32_t>(slab.vertices.size()));
+                        if (inserted.second) {
+                            std::size_t q[3] = {p[0], p[1], p[2]};
+                            ++q[axis];
+                            const double va = value(p[0], p[1], p[2]), vb = value(q[0], q[1], q[2]);
+                            const double t = (level - va) / (vb - va);
+                            std::array<double, 3> position;
+                            for (int d = 0; d < 3; ++d) {
+                                position[d] = (static_cast<double>(p[d]) - 1 + (d == axis ? t : 0)) * spacing[d];
+                            }
+                            slab.vertices.push_back(position);
+                            slab.edges.push_back(edge);
+                            if (axis == 2 || p[2] < l1) ++slab.numOwned;
+                        }
+                        cubeVertex[e] = inserted.first->second;
+                        return inserted.first->second;
+                    };
+                    for (const auto &triangle : table[config]) {
+                        slab.faces.push_back({{vertexOf(triangle[0]), vertexOf(triangle[1]), vertexOf(triangle[2])}});
+                    }
+                }
+            }
+        }
+    });
+
+    // Pass 2: number the owned vertices of every slab, then resolve the shared ones from the slab above
+    std::vector<uint64_t> vertexOffsets(numSlabs + 1, 0), faceOffsets(numSlabs + 1, 0);
+    for (std::size_t s = 0; s < numSlabs; ++s) {
+        vertexOffsets[s + 1] = vertexOffsets[s] + slabs[s].numOwned;
+        faceOffsets[s + 1] = faceOffsets[s] + slabs[s].faces.size();
+    }
+    mesh.vertices.resize(vertexOffsets[numSlabs]);
+    mesh.faces.resize(faceOffsets[numSlabs]);
+    auto isOwned = [&](const SlabSurface &slab, std::size_t s, uint32_t i) {
+        const uint64_t edge = slab.edges[i];
+        return edge % 3 == 2 || edge / 3 / planeSize < std::min(numLayers, (s + 1) * slabDepth);
+    };
+    std::vector<std::vector<uint32_t>> globalIds(numSlabs);
+    parallelFor(numSlabs, numThreads, [&](std::size_t s, unsigned) {
+        const SlabSurface &slab = slabs[s];
+        globalIds[s].resize(slab.vertices.size());
+        uint64_t next = vertexOffsets[s];
+        for (uint32_t i = 0; i < slab.vertices.size(); ++i) {
+            if (!isOwned(slab, s, i)) continue;
+            globalIds[s][i] = static_cast<uint32_t>(next);
+            mesh.vertices[next++] = slab.vertices[i];
+        }
+    });
+    parallelFor(numSlabs, numThreads, [&](std::size_t s, unsigned) {
+        SlabSurface &slab = slabs[s];
+        for (uint32_t i = 0; i < slab.vertices.size(); ++i) {
+            if (!isOwned(slab, s, i)) globalIds[s][i] = globalIds[s + 1][slabs[s + 1].vertexOfEdge.at(slab.edges[i])];
+        }
+        std::array<uint32_t, 3> *faces = mesh.faces.data() + faceOffsets[s];
+        for (std::size_t f = 0; f < slab.faces.size(); ++f) {
+            for (int k = 0; k < 3; ++k) faces[f][k] = globalIds[s][slab.faces[f][k]];
+        }
+    });
+    std::vector<SlabSurface>().swap(slabs);
+    std::vector<std::vector<uint32_t>>().swap(globalIds);
+
+    if (options.keepLargest && !mesh.faces.empty()) {
+        const uint32_t numVertices = static_cast<uint32_t>(mesh.vertices.size());
+        std::vector<uint32_t> parent(numVertices);
+        std::iota(parent.begin(), parent.end(), 0);
+        for (const auto &face : mesh.faces) {
+            uniteRoots(parent, face[0], face[1]);
+            uniteRoots(parent, face[0], face[2]);
+        }
+        std::vector<uint32_t> sizes(numVertices, 0);
+        for (uint32_t v = 0; v < numVertices; ++v) {
+            parent[v] = findRoot(parent, v);
+            ++sizes[parent[v]];
+        }
+        uint32_t largest = 0;
+        for (uint32_t v = 0; v < numVertices; ++v) {
+            if (parent[v] != v) continue;
+            ++mesh.numComponents;
+            if (sizes[v] > sizes[largest]) largest = v;
+        }
+        std::vector<uint32_t> newIndex(numVertices, 0);
+        uint32_t numKept = 0;
+        for (uint32_t v = 0; v < numVertices; ++v) {
+            if (parent[v] != largest) continue;
+            newIndex[v] = numKept;
+            mesh.vertices[numKept++] = mesh.vertices[v];
+        }
+        mesh.vertices.resize(numKept);
+        std::size_t numFaces = 0;
+        for (const auto &face : mesh.faces) {
+            if (parent[face[0]] != largest) continue;
+            mesh.faces[numFaces++] = {{newIndex[face[0]], newIndex[face[1]], newIndex[face[2]]}};
+        }
+        mesh.faces.resize(numFaces);
+    }
+    return mesh;
+}
+
+#endif //SKELTOOLS_MARCHINGCUBES_HXX
@@ -21,6 +21,12 @@
 #define SKELTOOLS_MEDIAL_H
 
 #include <string>
+#include <cstdint>
+#include <fstream>
+#include <unordered_map>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
 #include <experimental/filesystem>
 
 #include <itkImage.h>
@@ -49,8 +55,10 @@
 #include <itkSampleClassifierFilter.h>
 #include <itkLogger.h>
 #include <itkCastImageFilter.h>
+#include <itkExtractImageFilter.h>
 
 #include "itkCommandLineArgumentParser.h"
+#include "medialParameters.h"
 #include "utils.h"
 
 namespace fs = std::experimental::filesystem;
@@ -63,6 +71,7 @@ typename OutputImageType::Pointer
 computeMedialCurve(const itk::CommandLineArgumentParser::Pointer &parser,
                    const typename DistanceImageType::Pointer &distanceMap, 
                    const typename FluxImageType::Pointer &aof,
+                   const MedialParameters &params,
                    const itk::Logger::Pointer &logger);
 
 template<typename DistanceImageType, typename FluxImageType, typename OutputImageType>
@@ -70,9 +79,73 @@ typename OutputImageType::Pointer
 computeMedialSurface(const itk::CommandLineArgumentParser::Pointer &parser,
                      const typename DistanceImageType::Pointer &distanceMap, 
                      const typename FluxImageType::Pointer &aof,
+                     const MedialParameters &params,
                      const itk::Logger::Pointer &logger);
 
-void mapWeightedSkeletonToBoundary(const std::string & weightedSkeletonFileName, const std::string & objectFileName);
+/// \brief One skeleton voxel of a medial point file (little endian, 36 bytes).
+///
+/// A medial point file starts with MedialPointFileHeader, followed by numPoints records and,
+/// if flags & 1, numEdges pairs of uint32 record ids of 26-adjacent voxels (each edge once).
+struct MedialPointRecord {
+    int32_t index[3];    // voxel index in the input image.
+    float position[3];   // physical coordinates.
+    float radius;        // distance to the boundary.
+    float aof;           // average outward flux.
+    uint32_t label;      // PostProcessSkeleton::GetTopologicalLabel.
+};
+static_assert(sizeof(MedialPointRecord) == 36, "MedialPointRecord must stay packed");
+
+struct MedialPointFileHeader {
+    char magic[4] = {'S', 'K', 'P', 'T'};
+    uint32_t version = 1;
+    uint32_t flags = 0;
+    uint32_t recordSize = sizeof(MedialPointRecord);
+    uint64_t numPoints = 0;
+    uint64_t numEdges = 0;
+};
+static_assert(sizeof(MedialPointFileHeader) == 32, "MedialPointFileHeader must stay packed");
+
+/// \brief Writes the voxels of medialSurface as a medial point file, with the 26-adjacency graph if withGraph.
+/// Positions use params.spacing, since images read back from the tif cache have unit spacing.
+template<typename DistanceImageType, typename FluxImageType, typename OutputImageType>
+bool
+writeMedialPoints(const std::string &filePath,
+                  const typename OutputImageType::Pointer &medialSurface,
+                  const typename DistanceImageType::Pointer &distanceMap,
+                  const typename FluxImageType::Pointer &aof,
+                  bool withGraph,
+                  const MedialParameters &params,
+                  const itk::Logger::Pointer &logger);
+
+/// \brief Multiplies the medial surface with the distance map, writes medialSurfaceWithThickness.mha
+/// and maps the thickness onto the boundary of the input object.
+template<typename DistanceImageType, typename OutputImageType>
+void
+writeMedialSurfaceWithThickness(const std::string &outputFoldername, const std::string &inputFilename,
+                                const typename OutputImageType::Pointer &medialSurface,
+                                const typename DistanceImageType::Pointer &distanceMap,
+                                const MedialParameters &params,
+                                const itk::Logger::Pointer &logger);
+
+/// \brief Updates the cached distance map, spokes, AOF and medial surface of a previous
+/// -medialSurface run after a local edit of the input mask. Only the edited region plus a halo
+/// is recomputed; the edit is given as -changedMask <image> or -changedRegion i0 j0 k0 i1 j1 k1.
+/// With -verifyUpdate the result is checked against a full recomputation.
+template<typename DistanceImageType, typename FluxImageType, typename OutputImageType>
+int
+updateMedialSurface(const itk::CommandLineArgumentParser::Pointer &parser,
+                    const MedialParameters &params,
+                    const itk::Logger::Pointer &logger);
+
+/// \brief Bounding box of the edit from -changedRegion (inclusive indices) or the non zero
+/// voxels of -changedMask, cropped to largestRegion. Returns false if neither can be read.
+bool readChangedRegion(const itk::CommandLineArgumentParser::Pointer &parser,
+                       const itk::ImageRegion<3> &largestRegion,
+                       itk::ImageRegion<3> &changedRegion,
+                       const itk::Logger::Pointer &logger);
+
+void mapWeightedSkeletonToBoundary(const std::string & weightedSkeletonFileName, const std::string & objectFileName,
+                                   const MedialParameters &params);
 
 template<typename SkeletonImageType, typename BoundaryImageType>
 typename SkeletonImageType::Pointer
@@ -82,25 +155,37 @@ template<class TDistanceImage>
 std::pair< typename TDistanceImage::Pointer,
         typename itk::Image<itk::Vector<float,TDistanceImage::ImageDimension>,TDistanceImage::ImageDimension>::Pointer>
 computeAstrocyteSignedDistanceMap(const itk::CommandLineArgumentParser::Pointer &parser,
+                                  const MedialParameters &params,
                                   const itk::Logger::Pointer &logger);
 
+/// \brief Smoothing, signed distance and masked spoke field of an already loaded mask.
+template<class TDistanceImage>
+std::pair< typename TDistanceImage::Pointer,
+        typename itk::Image<itk::Vector<float,TDistanceImage::ImageDimension>,TDistanceImage::ImageDimension>::Pointer>
+computeSignedDistanceAndSpokes(const typename itk::Image<unsigned char, TDistanceImage::ImageDimension>::Pointer &image,
+                               const MedialParameters &params);
+
 template<class TDistanceImage>
 typename TDistanceImage::Pointer
 computeAstrocyteSignedDistanceMapWithoutSpokes(const itk::CommandLineArgumentParser::Pointer &parser,
+                                               const MedialParameters &params,
                                                const itk::Logger::Pointer &logger);
 
 template<class TDistanceImage>
-typename TDistanceImage::Pointer computeAOF(typename TDistanceImage::Pointer signedDistanceFunction, bool lowMemory=false);
+typename TDistanceImage::Pointer computeAOF(typename TDistanceImage::Pointer signedDistanceFunction,
+                                            const MedialParameters &params, bool lowMemory=false);
 
 template<class TDistanceImage>
 typename TDistanceImage::Pointer computeAOF(const itk::CommandLineArgumentParser::Pointer &parser,
+                                            const MedialParameters &params,
                                             const itk::Logger::Pointer &logger, bool lowMemory);
 
 template<typename TInputValueType,
         unsigned int VImageDimension,
         typename TOutputValueType> //use std::conditional here..
 typename itk::Image<TOutputValueType,VImageDimension>::Pointer
-computeAOFFromSpokes(typename itk::Image<itk::Vector<TInputValueType, VImageDimension>, VImageDimension >::Pointer spokeField);
+computeAOFFromSpokes(typename itk::Image<itk::Vector<TInputValueType, VImageDimension>, VImageDimension >::Pointer spokeField,
+                     bool useImageSpacing = false);
 
 #include "medial.hxx"
 #endif //SKELTOOLS_MEDIAL_H
@@ -25,6 +25,7 @@ typename OutputImageType::Pointer
 computeMedialCurve(const itk::CommandLineArgumentParser::Pointer &parser,
                    const typename DistanceImageType::Pointer &distanceMap, 
                    const typename FluxImageType::Pointer &aof,
+                   const MedialParameters &params,
                    const itk::Logger::Pointer &logger){
 
     std::string outputFoldername;
@@ -34,6 +35,7 @@ computeMedialCurve(const itk::CommandLineArgumentParser::Pointer &parser,
 
     using MedialCurveFilterType = itk::AnchoredMedialCurveImageFilter<DistanceImageType, FluxImageType>;
     typename MedialCurveFilterType::Pointer medialCurveFilter = MedialCurveFilterType::New();
+    medialCurveFilter->SetThreshold(params.curveAofThreshold);
 
     logger->Info("Computing medial curve\n");
 
@@ -81,6 +83,7 @@ typename OutputImageType::Pointer
 computeMedialSurface(const itk::CommandLineArgumentParser::Pointer &parser,
                      const typename DistanceImageType::Pointer &distanceMap, 
                      const typename FluxImageType::Pointer &aof,
+                     const MedialParameters &params,
                      const itk::Logger::Pointer &logger){
 
     std::string outputFoldername;
@@ -89,7 +92,7 @@ computeMedialSurface(const itk::CommandLineArgumentParser::Pointer &parser,
     using ThresholdFilterType = itk::BinaryThresholdImageFilter< FluxImageType,OutputImageType>;
     typename ThresholdFilterType::Pointer thresholdFilter = ThresholdFilterType::New();
 
-    thresholdFilter->SetLowerThreshold(-40*0.4);
+    thresholdFilter->SetLowerThreshold(params.surfaceAofThreshold);
     thresholdFilter->SetUpperThreshold(std::numeric_limits<typename FluxImageType::PixelType>::max());
     //outside value here is where the aof is sufficiently negative enought aka the skeleton
     thresholdFilter->SetOutsideValue(1);
@@ -107,6 +110,27 @@ computeMedialSurface(const itk::CommandLineArgumentParser::Pointer &parser,
     typename OutputImageType::Pointer medialSurface = pp->GetOutput();
     writeImage<OutputImageType>(fs::path(outputFoldername) / "medialSurfaceThreshold.mha", medialSurface);
 
+    std::string inputFilename;
+    parser->GetCommandLineArgument("-input",inputFilename);
+    writeMedialSurfaceWithThickness<DistanceImageType, OutputImageType>(outputFoldername, inputFilename, medialSurface,
+                                                                        distanceMap, params, logger);
+    if (parser->ArgumentExists("-exportPoints") || parser->ArgumentExists("-exportGraph")) {
+        writeMedialPoints<DistanceImageType, FluxImageType, OutputImageType>(
+                fs::path(outputFoldername) / "medialSurfacePoints.skpt", medialSurface, distanceMap, aof,
+                parser->ArgumentExists("-exportGraph"), params, logger);
+    }
+
+    return medialSurface;
+}
+
+
+template<typename DistanceImageType, typename OutputImageType>
+void
+writeMedialSurfaceWithThickness(const std::string &outputFoldername, const std::string &inputFilename,
+                                const typename OutputImageType::Pointer &medialSurface,
+                                const typename DistanceImageType::Pointer &distanceMap,
+                                const MedialParameters &params,
+                                const itk::Logger::Pointer &logger){
     logger->Info("Thickness mapped medial surface computation\n");
     using MaskOutputFilterType = itk::MultiplyImageFilter<OutputImageType, DistanceImageType, DistanceImageType>;
     typename MaskOutputFilterType::Pointer maskSkeletonFilter = MaskOutputFilterType::New();
@@ -116,12 +140,340 @@ computeMedialSurface(const itk::CommandLineArgumentParser::Pointer &parser,
     std::string medialSurfaceWithThicknessFilename = fs::path(outputFoldername) / "medialSurfaceWithThickness.mha";
     writeImage<typename MaskOutputFilterType::OutputImageType>(medialSurfaceWithThicknessFilename, medialSurfaceWithThickness);
 
-    std::string inputFilename;
-    parser->GetCommandLineArgument("-input",inputFilename);
+    mapWeightedSkeletonToBoundary(medialSurfaceWithThicknessFilename, inputFilename, params);
+}
 
-    mapWeightedSkeletonToBoundary(fs::path(outputFoldername) / "medialSurfaceWithThickness.mha", inputFilename);
 
-    return medialSurface;
+template<typename DistanceImageType, typename FluxImageType, typename OutputImageType>
+bool
+writeMedialPoints(const std::string &filePath,
+                  const typename OutputImageType::Pointer &medialSurface,
+                  const typename DistanceImageType::Pointer &distanceMap,
+                  const typename FluxImageType::Pointer &aof,
+                  bool withGraph,
+                  const MedialParameters &params,
+                  const itk::Logger::Pointer &logger){
+    using IndexType = typename OutputImageType::IndexType;
+    std::vector<MedialPointRecord> points;
+    std::unordered_map<itk::OffsetValueType, uint32_t> pointIds;
+
+    using PostProcessor = itk::PostProcessSkeleton<OutputImageType>;
+    typename PostProcessor::Pointer labeller = PostProcessor::New();
+    itk::ImageRegionConstIteratorWithIndex<OutputImageType> skIt(medialSurface, medialSurface->GetLargestPossibleRegion());
+    const auto &origin = medialSurface->GetOrigin();
+    for (skIt.GoToBegin(); !skIt.IsAtEnd(); ++skIt) {
+        if (skIt.Get() == 0) continue;
+        const IndexType index = skIt.GetIndex();
+        MedialPointRecord record;
+        for (unsigned d = 0; d < 3; ++d) {
+            record.index[d] = static_cast<int32_t>(index[d]);
+            record.position[d] = static_cast<float>(origin[d] + index[d] * params.spacing[d]);
+        }
+        // the object is negative in the signed distance map.
+        record.radius = -distanceMap->GetPixel(index);
+        record.aof = aof->GetPixel(index);
+        record.label = labeller->GetTopologicalLabel(medialSurface, index);
+        if (withGraph) pointIds.emplace(medialSurface->ComputeOffset(index), static_cast<uint32_t>(points.size()));
+        points.push_back(record);
+    }
+
+    std::vector<uint32_t> edges;
+    if (withGraph) {
+        // visit only the 13 offsets that come after the centre in raster order so every edge appears once.
+        const auto &region = medialSurface->GetBufferedRegion();
+        for (uint32_t id = 0; id < points.size(); ++id) {
+            IndexType index;
+            for (unsigned d = 0; d < 3; ++d) index[d] = points[id].index[d];
+            for (int k = -1; k <= 1; ++k)
+                for (int j = -1; j <= 1; ++j)
+                    for (int i = -1; i <= 1; ++i) {
+                        if (k < 0 || (k == 0 && (j < 0 || (j == 0 && i <= 0)))) continue;
+                        IndexType neighbor = index;
+                        neighbor[0] += i; neighbor[1] += j; neighbor[2] += k;
+                        if (!region.IsInside(neighbor)) continue;
+                        auto found = pointIds.find(medialSurface->ComputeOffset(neighbor));
+                        if (found == pointIds.end()) continue;
+                        edges.push_back(id);
+                        edges.push_back(found->second);
+                    }
+        }
+    }
+
+    MedialPointFileHeader header;
+    header.flags = withGraph ? 1 : 0;
+    header.numPoints = points.size();
+    header.numEdges = edges.size() / 2;
+    std::ofstream file(filePath, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(points.data()), points.size() * sizeof(MedialPointRecord));
+    file.write(reinterpret_cast<const char *>(edges.data()), edges.size() * sizeof(uint32_t));
+    if (!file) {
+        logger->Error("Could not write " + filePath + "\n");
+        return false;
+    }
+    logger->Info("Wrote " + std::to_string(header.numPoints) + " medial points and " +
+                 std::to_string(header.numEdges) + " edges to " + filePath + "\n");
+    return true;
+}
+
+
+template<typename DistanceImageType, typename FluxImageType, typename OutputImageType>
+int
+updateMedialSurface(const itk::CommandLineArgumentParser::Pointer &parser,
+                    const MedialParameters &params,
+                    const itk::Logger::Pointer &logger){
+    constexpr unsigned Dimension = DistanceImageType::ImageDimension;
+    using AstrocyteImageType = itk::Image<unsigned char, Dimension>;
+    using SpokeFieldImageType = itk::Image<itk::Vector<float, Dimension>, Dimension>;
+    using RegionType = typename DistanceImageType::RegionType;
+
+    std::string outputFoldername, inputFilename;
+    parser->GetCommandLineArgument("-outputFolder", outputFoldername);
+    parser->GetCommandLineArgument("-input", inputFilename);
+    const fs::path outputFolderPath(outputFoldername);
+    const fs::path distanceMapFilePath = outputFolderPath / "signedDistanceMap.tif";
+    const fs::path spokeFilePath = outputFolderPath / "CPT.tif";
+    const fs::path aofFilePath = outputFolderPath / "aof.tif";
+    const fs::path skeletonFilePath = outputFolderPath / "medialSurfaceThreshold.mha";
+    for (const fs::path &path: {distanceMapFilePath, spokeFilePath, aofFilePath, skeletonFilePath}) {
+        if (!fs::exists(path)) {
+            logger->Critical("Incremental update needs " + path.string() + " from a previous full run\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    logger->Info("Reading cached distance map, spokes, AOF and medial surface..\n");
+    typename DistanceImageType::SpacingType spacing(params.spacing.data());
+    typename DistanceImageType::Pointer distanceMap = readImage<DistanceImageType>(distanceMapFilePath);
+    typename SpokeFieldImageType::Pointer spokeField = readImage<SpokeFieldImageType>(spokeFilePath);
+    typename FluxImageType::Pointer aof = readImage<FluxImageType>(aofFilePath);
+    typename OutputImageType::Pointer medialSurface = readImage<OutputImageType>(skeletonFilePath);
+    distanceMap->SetSpacing(spacing);
+    spokeField->SetSpacing(spacing);
+    aof->SetSpacing(spacing);
+    medialSurface->SetSpacing(spacing);
+
+    typename AstrocyteImageType::Pointer astrocyte = readImage<AstrocyteImageType>(inputFilename);
+    astrocyte->SetSpacing(spacing);
+    const RegionType largestRegion = distanceMap->GetLargestPossibleRegion();
+    if (astrocyte->GetLargestPossibleRegion() != largestRegion) {
+        logger->Critical("Edited input does not match the size of the cached results\n");
+        return EXIT_FAILURE;
+    }
+
+    RegionType changedRegion;
+    if (!readChangedRegion(parser, largestRegion, changedRegion, logger)) {
+        return EXIT_FAILURE;
+    }
+    if (changedRegion.GetNumberOfPixels() == 0) {
+        logger->Info("No changed voxels, cached results are up to date\n");
+        return EXIT_SUCCESS;
+    }
+
+    // Only the smoothed, thresholded mask around the edit can change: the edit plus the reach of the
+    // Gaussian kernel (about 4 sigma, at most half of the default maximum kernel width of 32) and a
+    // voxel for the boundary itself.
+    typename RegionType::SizeType kernelRadius;
+    double diagonal = 0;
+    for (unsigned d = 0; d < Dimension; ++d) {
+        kernelRadius[d] = std::min<itk::SizeValueType>(
+                static_cast<itk::SizeValueType>(std::ceil(4 * std::sqrt(params.gaussianVariance[d]))), 16) + 1;
+        diagonal += spacing[d] * spacing[d];
+    }
+    diagonal = std::sqrt(diagonal);
+    RegionType boundaryRegion = changedRegion;
+    boundaryRegion.PadByRadius(kernelRadius);
+    boundaryRegion.Crop(largestRegion);
+
+    auto maxAbsDistance = [&distanceMap](const RegionType &region) {
+        double maxDistance = 0;
+        itk::ImageRegionConstIterator<DistanceImageType> dit(distanceMap, region);
+        for (dit.GoToBegin(); !dit.IsAtEnd(); ++dit) {
+            maxDistance = std::max<double>(maxDistance, std::abs(dit.Get()));
+        }
+        return maxDistance;
+    };
+    auto padPhysical = [&spacing, &largestRegion](const RegionType &region, double distance) {
+        typename RegionType::SizeType radius;
+        for (unsigned d = 0; d < Dimension; ++d) {
+            radius[d] = static_cast<itk::SizeValueType>(std::ceil(distance / spacing[d]));
+        }
+        RegionType padded = region;
+        padded.PadByRadius(radius);
+        padded.Crop(largestRegion);
+        return padded;
+    };
+
+    // A voxel v keeps its distance unless a moved boundary voxel b is closer than its old boundary,
+    // |v - b| <= |D_old(v)|. |D_old| is 1-Lipschitz, so such a v outside the region within r of
+    // boundaryRegion would give |D_old| >= r on its rim: grow r to the largest |D_old| inside
+    // (plus a voxel diagonal) until the region stops growing.
+    RegionType updateRegion = boundaryRegion;
+    int halo = 0;
+    if (parser->GetCommandLineArgument("-halo", halo)) {
+        if (halo < 0) {
+            logger->Critical("-halo must be a non-negative number of voxels\n");
+            return EXIT_FAILURE;
+        }
+        updateRegion.PadByRadius(halo);
+        updateRegion.Crop(largestRegion);
+    } else {
+        for (;;) {
+            const RegionType grownRegion = padPhysical(boundaryRegion, maxAbsDistance(updateRegion) + diagonal);
+            if (grownRegion == updateRegion) break;
+            updateRegion = grownRegion;
+        }
+    }
+
+    // Danielsson on a crop only sees the boundaries inside it, and the smoothing treats the crop
+    // border as zero flux, which can move the boundary within a kernel radius of it. A recomputed
+    // distance is exact where it is shorter than the way out of the rest of the crop; otherwise
+    // the crop is widened and the distances recomputed.
+    auto distancesResolved = [&](const typename DistanceImageType::Pointer &patchDistance, const RegionType &context) {
+        const auto lower = context.GetIndex();
+        const auto upper = context.GetUpperIndex();
+        itk::ImageRegionConstIteratorWithIndex<DistanceImageType> pit(patchDistance, updateRegion);
+        for (pit.GoToBegin(); !pit.IsAtEnd(); ++pit) {
+            const auto index = pit.GetIndex();
+            double reach = std::numeric_limits<double>::max();
+            for (unsigned d = 0; d < Dimension; ++d) {
+                if (lower[d] > largestRegion.GetIndex(d)) {
+                    reach = std::min(reach, (static_cast<double>(index[d] - lower[d]) - kernelRadius[d]) * spacing[d]);
+                }
+                if (upper[d] < largestRegion.GetUpperIndex()[d]) {
+                    reach = std::min(reach, (static_cast<double>(upper[d] - index[d]) - kernelRadius[d]) * spacing[d]);
+                }
+            }
+            if (std::abs(pit.Get()) + diagonal >= reach) return false;
+        }
+        return true;
+    };
+    double contextDistance = maxAbsDistance(updateRegion) + diagonal;
+    RegionType contextRegion;
+    typename DistanceImageType::Pointer patchDistance;
+    typename SpokeFieldImageType::Pointer patchSpokes;
+    for (;;) {
+        contextRegion = padPhysical(updateRegion, contextDistance);
+        contextRegion.PadByRadius(kernelRadius);
+        contextRegion.Crop(largestRegion);
+        std::ostringstream ss;
+        ss << "Updating " << updateRegion.GetNumberOfPixels() << " of " << largestRegion.GetNumberOfPixels()
+           << " voxels from a context of " << contextRegion.GetNumberOfPixels() << "\n";
+        logger->Info(ss.str());
+
+        using ExtractFilterType = itk::ExtractImageFilter<AstrocyteImageType, AstrocyteImageType>;
+        typename ExtractFilterType::Pointer extract = ExtractFilterType::New();
+        extract->SetInput(astrocyte);
+        extract->SetExtractionRegion(contextRegion);
+        extract->SetDirectionCollapseToIdentity();
+        extract->Update();
+        auto patch = computeSignedDistanceAndSpokes<DistanceImageType>(extract->GetOutput(), params);
+        patchDistance = patch.first;
+        patchSpokes = patch.second;
+        if (contextRegion == largestRegion || distancesResolved(patchDistance, contextRegion)) break;
+        contextDistance *= 2;
+    }
+    copyImageRegion<DistanceImageType>(patchDistance, distanceMap, updateRegion);
+    copyImageRegion<SpokeFieldImageType>(patchSpokes, spokeField, updateRegion);
+
+    // The AOF samples the spokes one voxel away.
+    logger->Info("Updating AOF\n");
+    RegionType aofRegion = updateRegion;
+    aofRegion.PadByRadius(1);
+    aofRegion.Crop(largestRegion);
+    using AOFFilterType = itk::AverageOutwardFluxImageFilter2<SpokeFieldImageType, typename FluxImageType::PixelType>;
+    typename AOFFilterType::Pointer aofFilter = AOFFilterType::New();
+    aofFilter->SetUseImageSpacing(params.useImageSpacing);
+    aofFilter->SetInput(spokeField);
+    aofFilter->UpdateOutputInformation();
+    aofFilter->GetOutput()->SetRequestedRegion(aofRegion);
+    aofFilter->GetOutput()->Update();
+    copyImageRegion<FluxImageType>(aofFilter->GetOutput(), aof, aofRegion);
+
+    // The topological labels of the post processing look one voxel further, so the labels are
+    // redone one voxel around the new AOF on a patch thresholded one more voxel out, as the full
+    // run thresholds the whole image before post processing it.
+    logger->Info("Updating medial surface patch\n");
+    RegionType labelRegion = aofRegion;
+    labelRegion.PadByRadius(1);
+    labelRegion.Crop(largestRegion);
+    RegionType skeletonRegion = labelRegion;
+    skeletonRegion.PadByRadius(1);
+    skeletonRegion.Crop(largestRegion);
+    auto thresholdSkeleton = [&params, &medialSurface](const typename FluxImageType::Pointer &flux,
+                                                       const RegionType &region) {
+        typename OutputImageType::Pointer thickSkeleton = OutputImageType::New();
+        thickSkeleton->CopyInformation(medialSurface);
+        thickSkeleton->SetRegions(region);
+        thickSkeleton->Allocate();
+        itk::ImageRegionConstIterator<FluxImageType> aofIt(flux, region);
+        itk::ImageRegionIterator<OutputImageType> skeletonIt(thickSkeleton, region);
+        for (aofIt.GoToBegin(), skeletonIt.GoToBegin(); !aofIt.IsAtEnd(); ++aofIt, ++skeletonIt) {
+            skeletonIt.Set(aofIt.Get() < params.surfaceAofThreshold ? 1 : 0);
+        }
+        using PostProcessor = itk::PostProcessSkeleton<OutputImageType>;
+        typename PostProcessor::Pointer pp = PostProcessor::New();
+        pp->SetInput(thickSkeleton);
+        pp->Update();
+        typename OutputImageType::Pointer skeleton = pp->GetOutput();
+        return skeleton;
+    };
+    copyImageRegion<OutputImageType>(thresholdSkeleton(aof, skeletonRegion), medialSurface, labelRegion);
+
+    writeImage<DistanceImageType>(distanceMapFilePath, distanceMap);
+    writeImage<SpokeFieldImageType>(spokeFilePath, spokeField);
+    writeImage<FluxImageType>(aofFilePath, aof);
+    writeImage<OutputImageType>(skeletonFilePath, medialSurface);
+    writeMedialSurfaceWithThickness<DistanceImageType, OutputImageType>(outputFoldername, inputFilename, medialSurface,
+                                                                        distanceMap, params, logger);
+    if (parser->ArgumentExists("-exportPoints") || parser->ArgumentExists("-exportGraph")) {
+        writeMedialPoints<DistanceImageType, FluxImageType, OutputImageType>(
+                fs::path(outputFoldername) / "medialSurfacePoints.skpt", medialSurface, distanceMap, aof,
+                parser->ArgumentExists("-exportGraph"), params, logger);
+    }
+
+    if (parser->ArgumentExists("-verifyUpdate")) {
+        // The spokes may differ from a full run between equidistant boundary voxels, so the AOF and
+        // medial surface are checked against a full recomputation from the updated spokes: that is
+        // what the AOF and label halos have to get right.
+        logger->Info("Verifying the update against a full recomputation\n");
+        auto full = computeSignedDistanceAndSpokes<DistanceImageType>(astrocyte, params);
+        size_t distanceMismatches = 0, spokeMismatches = 0, aofMismatches = 0, skeletonMismatches = 0;
+        itk::ImageRegionConstIterator<DistanceImageType> fullIt(full.first, largestRegion);
+        itk::ImageRegionConstIterator<DistanceImageType> updatedIt(distanceMap, largestRegion);
+        for (fullIt.GoToBegin(), updatedIt.GoToBegin(); !fullIt.IsAtEnd(); ++fullIt, ++updatedIt) {
+            if (std::abs(fullIt.Get() - updatedIt.Get()) > 1e-3) ++distanceMismatches;
+        }
+        itk::ImageRegionConstIterator<SpokeFieldImageType> fullSpokeIt(full.second, largestRegion);
+        itk::ImageRegionConstIterator<SpokeFieldImageType> updatedSpokeIt(spokeField, largestRegion);
+        for (fullSpokeIt.GoToBegin(), updatedSpokeIt.GoToBegin(); !fullSpokeIt.IsAtEnd(); ++fullSpokeIt, ++updatedSpokeIt) {
+            if ((fullSpokeIt.Get() - updatedSpokeIt.Get()).GetNorm() > 1e-3) ++spokeMismatches;
+        }
+        typename FluxImageType::Pointer fullAOF =
+                computeAOFFromSpokes<float, Dimension, typename FluxImageType::PixelType>(spokeField, params.useImageSpacing);
+        itk::ImageRegionConstIterator<FluxImageType> fullAOFIt(fullAOF, largestRegion);
+        itk::ImageRegionConstIterator<FluxImageType> updatedAOFIt(aof, largestRegion);
+        for (fullAOFIt.GoToBegin(), updatedAOFIt.GoToBegin(); !fullAOFIt.IsAtEnd(); ++fullAOFIt, ++updatedAOFIt) {
+            if (std::abs(fullAOFIt.Get() - updatedAOFIt.Get()) > 1e-3) ++aofMismatches;
+        }
+        typename OutputImageType::Pointer fullSkeleton = thresholdSkeleton(fullAOF, largestRegion);
+        itk::ImageRegionConstIterator<OutputImageType> fullSkeletonIt(fullSkeleton, largestRegion);
+        itk::ImageRegionConstIterator<OutputImageType> updatedSkeletonIt(medialSurface, largestRegion);
+        for (fullSkeletonIt.GoToBegin(), updatedSkeletonIt.GoToBegin(); !fullSkeletonIt.IsAtEnd();
+             ++fullSkeletonIt, ++updatedSkeletonIt) {
+            if (fullSkeletonIt.Get() != updatedSkeletonIt.Get()) ++skeletonMismatches;
+        }
+        std::ostringstream ss;
+        ss << distanceMismatches << " distances, " << spokeMismatches << " spokes, " << aofMismatches
+           << " AOF values and " << skeletonMismatches
+           << " medial surface voxels differ from a full recomputation (spokes may differ between equidistant boundary voxels)\n";
+        if (distanceMismatches > 0 || aofMismatches > 0 || skeletonMismatches > 0) {
+            logger->Error(ss.str());
+            return EXIT_FAILURE;
+        }
+        logger->Info(ss.str());
+    }
+    return EXIT_SUCCESS;
 }
 
 
@@ -203,14 +555,12 @@ skeletonToBoundaryMap(typename SkeletonImageType::Pointer weightedSkeleton, type
 template<class TDistanceImage>
 typename TDistanceImage::Pointer
 computeAstrocyteSignedDistanceMapWithoutSpokes(const itk::CommandLineArgumentParser::Pointer &parser,
+                                               const MedialParameters &params,
                                                const itk::Logger::Pointer &logger){
     logger->Info("Starting computation of m_Distance map without spokes\n");
     using AstrocyteImageType = itk::Image<unsigned char, 3>;
     using DistanceImageType = TDistanceImage;
-    typename AstrocyteImageType::SpacingType spacing;
-    spacing[0] = 4.1341146;
-    spacing[1] = 4.1341146;
-    spacing[2] = 8;
+    typename AstrocyteImageType::SpacingType spacing(params.spacing.data());
     std::string outputFolderName, inputFilename;
     parser->GetCommandLineArgument("-outputFolder", outputFolderName);
     parser->GetCommandLineArgument("-input", inputFilename);
@@ -229,15 +579,14 @@ computeAstrocyteSignedDistanceMapWithoutSpokes(const itk::CommandLineArgumentPar
     using GaussianFilterType = itk::DiscreteGaussianImageFilter<AstrocyteImageType , DistanceImageType >;
     typename GaussianFilterType::Pointer smoother = GaussianFilterType::New();
     smoother->SetInput(astrocyte->GetOutput());
-    double variance[3] = {5, 5, 2.5};
-    smoother->SetVariance(variance);
+    smoother->SetVariance(params.gaussianVariance.data());
     smoother->SetUseImageSpacingOff();
 
 
     using ThresholdFilterType = itk::BinaryThresholdImageFilter< DistanceImageType , AstrocyteImageType >;
     typename ThresholdFilterType::Pointer thresholdFilter = ThresholdFilterType::New();
 
-    thresholdFilter->SetLowerThreshold(0.5);
+    thresholdFilter->SetLowerThreshold(params.smoothingThreshold);
     thresholdFilter->SetUpperThreshold(std::numeric_limits<typename DistanceImageType::PixelType>::max());
     thresholdFilter->SetOutsideValue(1);
     thresholdFilter->SetInsideValue(0);
@@ -267,14 +616,12 @@ template<class TDistanceImage>
 std::pair< typename TDistanceImage::Pointer,
         typename itk::Image<itk::Vector<float, TDistanceImage::ImageDimension>,TDistanceImage::ImageDimension>::Pointer>
 computeAstrocyteSignedDistanceMap(const itk::CommandLineArgumentParser::Pointer &parser,
+                                  const MedialParameters &params,
                                   const itk::Logger::Pointer &logger){
     logger->Info("Starting computation of m_Distance map \n");
     using AstrocyteImageType = itk::Image<unsigned char, 3>;
     using DistanceImageType = TDistanceImage;
-    typename AstrocyteImageType::SpacingType spacing;
-    spacing[0] = 4.1341146;
-    spacing[1] = 4.1341146;
-    spacing[2] = 8;
+    typename AstrocyteImageType::SpacingType spacing(params.spacing.data());
     std::string  inputFilename;
     parser->GetCommandLineArgument("-input", inputFilename);
 
@@ -291,29 +638,42 @@ computeAstrocyteSignedDistanceMap(const itk::CommandLineArgumentParser::Pointer
     changeSpacing->ChangeSpacingOn();
     typename AstrocyteImageType::Pointer image = changeSpacing->GetOutput();
 
+    logger->Info("Started Signed m_Distance map computation \n");
+    return computeSignedDistanceAndSpokes<TDistanceImage>(image, params);
+}
+
+
+template<class TDistanceImage>
+std::pair< typename TDistanceImage::Pointer,
+        typename itk::Image<itk::Vector<float, TDistanceImage::ImageDimension>,TDistanceImage::ImageDimension>::Pointer>
+computeSignedDistanceAndSpokes(const typename itk::Image<unsigned char, TDistanceImage::ImageDimension>::Pointer &image,
+                               const MedialParameters &params){
+    using AstrocyteImageType = itk::Image<unsigned char, TDistanceImage::ImageDimension>;
+    using DistanceImageType = TDistanceImage;
+
     using GaussianFilterType = itk::DiscreteGaussianImageFilter<AstrocyteImageType , DistanceImageType >;
     typename GaussianFilterType::Pointer smoother = GaussianFilterType::New();
     smoother->SetInput(image);
-    double variance[3] = {5, 5, 2.5};
-    smoother->SetVariance(variance);
+    smoother->SetVariance(params.gaussianVariance.data());
     smoother->SetUseImageSpacingOff();
 
 
     using ThresholdFilterType = itk::BinaryThresholdImageFilter< DistanceImageType , AstrocyteImageType >;
     typename ThresholdFilterType::Pointer thresholdFilter = ThresholdFilterType::New();
 
-    thresholdFilter->SetLowerThreshold(0.5);
+    thresholdFilter->SetLowerThreshold(params.smoothingThreshold);
     thresholdFilter->SetUpperThreshold(std::numeric_limits<typename ThresholdFilterType::InputImageType::PixelType>::max());
     thresholdFilter->SetOutsideValue(1);
     thresholdFilter->SetInsideValue(0);
     thresholdFilter->SetInput(smoother->GetOutput());
 
-    logger->Info("Started Signed m_Distance map computation \n");
     using SignedDistanceMapImageFilterType = itk::SignedDanielssonDistanceMapImageFilter<AstrocyteImageType, DistanceImageType>;
     typename SignedDistanceMapImageFilterType::Pointer distanceMapImageFilter = SignedDistanceMapImageFilterType::New();
     distanceMapImageFilter->SetInput(thresholdFilter->GetOutput());
     // inside true because threshold inverts the astrocyte.
     distanceMapImageFilter->SetInsideIsPositive(true);
+    // physical distances: they order the thinning and are compared with physical thresholds.
+    distanceMapImageFilter->UseImageSpacingOn();
     distanceMapImageFilter->Update();
     typename DistanceImageType::Pointer distanceMap = distanceMapImageFilter->GetOutput();
     using OffSetImageType =  typename SignedDistanceMapImageFilterType::VectorImageType ;
@@ -330,13 +690,15 @@ computeAstrocyteSignedDistanceMap(const itk::CommandLineArgumentParser::Pointer
     itk::ImageRegionIterator<DistanceImageType > dit(distanceMap, distanceMap->GetLargestPossibleRegion());
     itk::ImageRegionConstIterator<OffSetImageType> cpit(closestPointTransform, closestPointTransform->GetLargestPossibleRegion());
     typename FieldImageType::PixelType castValue;
+    // spokes of voxels too close to the boundary are dropped; the margin is a multiple of the z spacing.
+    const float spokeMaskDistance = -params.spokeMaskFactor * params.spacing[OffSetImageType::ImageDimension - 1];
     dit.GoToBegin();
     wit.GoToBegin();
     cpit.GoToBegin();
     while(!wit.IsAtEnd()){
     auto current = cpit.Get();
     auto dist = dit.Get();
-    float multiplier = dist < -1.5*spacing[2] ? 1:0;
+    float multiplier = dist < spokeMaskDistance ? 1:0;
     for(size_t d = 0; d < OffSetImageType::ImageDimension; ++d){
     castValue[d] = static_cast<float>(current.GetElement(d)) * multiplier;
     }
@@ -359,13 +721,15 @@ template<typename TInputValueType,
         unsigned int VImageDimension,
         typename TOutputValueType> //use std::conditional here..
 typename itk::Image<TOutputValueType,VImageDimension>::Pointer
-computeAOFFromSpokes(typename itk::Image<itk::Vector<TInputValueType, VImageDimension>, VImageDimension >::Pointer spokeField)
+computeAOFFromSpokes(typename itk::Image<itk::Vector<TInputValueType, VImageDimension>, VImageDimension >::Pointer spokeField,
+                     bool useImageSpacing)
 {
     std::cout << "Starting AOF computation using Spoke Vector Field" << std::endl;
     using OutputImageType = itk::Image<TOutputValueType,VImageDimension>;
     using SpokeFieldImageType = itk::Image<itk::Vector<TInputValueType, VImageDimension>, VImageDimension >;
     using AOFFilterType = itk::AverageOutwardFluxImageFilter2< SpokeFieldImageType, TOutputValueType >;
     typename AOFFilterType::Pointer aofFilter = AOFFilterType::New();
+    aofFilter->SetUseImageSpacing(useImageSpacing);
     aofFilter->SetInput(spokeField);
     aofFilter->Update();
     typename OutputImageType::Pointer aof = aofFilter->GetOutput();
@@ -375,6 +739,7 @@ computeAOFFromSpokes(typename itk::Image<itk::Vector<TInputValueType, VImageDime
 
 template<class TDistanceImage>
 typename TDistanceImage::Pointer computeAOF(const itk::CommandLineArgumentParser::Pointer &parser,
+                                            const MedialParameters &params,
                                             const itk::Logger::Pointer &logger,
                                             bool lowMemory){
     using DistanceImageType = TDistanceImage;
@@ -386,10 +751,7 @@ typename TDistanceImage::Pointer computeAOF(const itk::CommandLineArgumentParser
     using Reader =  itk::ImageFileReader<DistanceImageType>;
     typename Reader::Pointer reader = Reader::New();
     // reader->SetFileName(fs::path(outputFolderName) / "signedDistanceMap.mha");
-    typename DistanceImageType::SpacingType spacing;
-    spacing[0] = 4.1341146;
-    spacing[1] = 4.1341146;
-    spacing[2] = 8;
+    typename DistanceImageType::SpacingType spacing(params.spacing.data());
     using InformationChangeFilterTypeFloat = itk::ChangeInformationImageFilter<DistanceImageType>;
     typename InformationChangeFilterTypeFloat::Pointer distanceMap = InformationChangeFilterTypeFloat::New();
     distanceMap->SetInput(reader->GetOutput());
@@ -403,6 +765,8 @@ typename TDistanceImage::Pointer computeAOF(const itk::CommandLineArgumentParser
     if(!lowMemory) {
         using AOFFilterType = itk::AverageOutwardFluxImageFilter<DistanceImageType>;
         typename AOFFilterType::Pointer aofFilter = AOFFilterType::New();
+        aofFilter->SetUseImageSpacing(params.useImageSpacing);
+        aofFilter->SetObjectThreshold(params.objectThreshold);
         aofFilter->SetInput(distanceMap->GetOutput());
         aofFilter->SetGradientImage(gradientFilter->GetOutput());
         aof = aofFilter->GetOutput();
@@ -411,6 +775,7 @@ typename TDistanceImage::Pointer computeAOF(const itk::CommandLineArgumentParser
         std::cout << "Using Low memory aof computation will take longer. time" << std::endl;
         using AOFFilterType = itk::AverageOutwardFluxImageFilter3<typename GradientFilterType::OutputImageType, float>;
         typename AOFFilterType::Pointer aofFilter = AOFFilterType::New();
+        aofFilter->SetUseImageSpacing(params.useImageSpacing);
         aofFilter->SetInput(gradientFilter->GetOutput());
         using AstrocyteImageType = itk::Image<unsigned char, DistanceImageType::ImageDimension>;
         using AstrocyteReader =  itk::ImageFileReader<AstrocyteImageType>;
@@ -432,7 +797,8 @@ typename TDistanceImage::Pointer computeAOF(const itk::CommandLineArgumentParser
 
 
 template<class TDistanceImage>
-typename TDistanceImage::Pointer computeAOF(typename TDistanceImage::Pointer signedDistanceFunction, bool lowMemory){
+typename TDistanceImage::Pointer computeAOF(typename TDistanceImage::Pointer signedDistanceFunction,
+                                            const MedialParameters &params, bool lowMemory){
     using DistanceImageType = TDistanceImage;
     typename DistanceImageType::Pointer aof;
     std::cout << "Computing Gradient vector field..." << std::endl;
@@ -445,6 +811,8 @@ typename TDistanceImage::Pointer computeAOF(typename TDistanceImage::Pointer sig
     if(!lowMemory) {
         using AOFFilterType = itk::AverageOutwardFluxImageFilter<DistanceImageType>;
         typename AOFFilterType::Pointer aofFilter = AOFFilterType::New();
+        aofFilter->SetUseImageSpacing(params.useImageSpacing);
+        aofFilter->SetObjectThreshold(params.objectThreshold);
         aofFilter->SetInput(signedDistanceFunction);
         aofFilter->SetGradientImage(gradientFilter->GetOutput());
         aofFilter->Update();
@@ -454,13 +822,14 @@ typename TDistanceImage::Pointer computeAOF(typename TDistanceImage::Pointer sig
         std::cout << "Using Low memory aof computation will take longer. time" << std::endl;
         using AOFFilterType = itk::AverageOutwardFluxImageFilter3<typename GradientFilterType::OutputImageType, float>;
         typename AOFFilterType::Pointer aofFilter = AOFFilterType::New();
+        aofFilter->SetUseImageSpacing(params.useImageSpacing);
         aofFilter->SetInput(gradientFilter->GetOutput());
 
         using ThresholdFilterType = itk::BinaryThresholdImageFilter<DistanceImageType, DistanceImageType >;
         typename ThresholdFilterType::Pointer distanceMaskFilter = ThresholdFilterType::New();
         distanceMaskFilter->SetInput(signedDistanceFunction);
         distanceMaskFilter->SetLowerThreshold(std::numeric_limits<float>::lowest());
-        distanceMaskFilter->SetUpperThreshold(-8.5);
+        distanceMaskFilter->SetUpperThreshold(-params.objectThreshold);
         distanceMaskFilter->SetOutsideValue(0.0);
         distanceMaskFilter->SetInsideValue(1.0);
 
@@ -0,0 +1,67 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+#ifndef SKELTOOLS_MEDIALPARAMETERS_H
+#define SKELTOOLS_MEDIALPARAMETERS_H
+
+#include <array>
+#include <string>
+#include <cmath>
+
+#include <itkLogger.h>
+
+#include "itkCommandLineArgumentParser.h"
+
+/// \brief Per dataset parameters of the medial structure pipeline.
+///
+/// Defaults reproduce the values that used to be hardcoded for the 4.13 x 4.13 x 8 nm
+/// astrocyte data. Values are resolved (later wins) from the defaults, the input image
+/// header (-spacingFromHeader), a key = value config file (-config) and the command line.
+struct MedialParameters {
+    static constexpr unsigned Dimension = 3;
+
+    /// physical voxel size of the input mask.
+    std::array<double, Dimension> spacing{{4.1341146, 4.1341146, 8.0}};
+    /// variance (in voxels) of the gaussian used to smooth the mask before the distance map.
+    std::array<double, Dimension> gaussianVariance{{5.0, 5.0, 2.5}};
+    /// level at which the smoothed mask is thresholded back to a binary object.
+    double smoothingThreshold = 0.5;
+    /// distance from the boundary below which the low memory AOF is masked out.
+    double objectThreshold = 8.5;
+    /// spokes closer than spokeMaskFactor * z spacing to the boundary are dropped.
+    double spokeMaskFactor = 1.5;
+    /// AOF below which a voxel is considered part of the medial surface.
+    double surfaceAofThreshold = -40 * 0.4;
+    /// AOF below which an end point of the medial curve is preserved.
+    double curveAofThreshold = -(60 * 2 / 3.14159) * 0.4;
+    /// compute the AOF in physical space instead of index space.
+    bool useImageSpacing = true;
+
+    std::string ToString() const;
+};
+
+/// \brief Resolve the parameters for the current input; returns false if a config file
+/// or argument could not be parsed.
+bool readMedialParameters(const itk::CommandLineArgumentParser::Pointer &parser,
+                          const itk::Logger::Pointer &logger,
+                          MedialParameters &params);
+
+/// \brief Read `key = value` pairs (vector values separated by spaces or commas, # comments).
+bool readMedialParameterFile(const std::string &filePath,
+                             const itk::Logger::Pointer &logger,
+                             MedialParameters &params);
+
+#endif //SKELTOOLS_MEDIALPARAMETERS_H
@@ -0,0 +1,36 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+#ifndef SKELTOOLS_PREPROCESS_H
+#define SKELTOOLS_PREPROCESS_H
+
+#include <itkLogger.h>
+
+#include "itkCommandLineArgumentParser.h"
+
+/// \brief -preprocess module: prepares a binary mask for meshing or skeletonisation.
+///
+/// Reads -input as an 8 bit mask, applies the requested stages in place and writes -output
+/// (default <input stem>_preprocessed.tif next to the input):
+///   -minObjectSize <n> / -keepLargest   drop small 26-connected components (streamingComponents.h)
+///   -resampleSpacing <sx> <sy> <sz>     nearest neighbour resampling from the -spacing/-config
+///                                       input spacing (resampleNearest.h)
+/// and, with -surface <file.obj>, also writes the 0.5 marching cubes surface of the result in
+/// physical coordinates (marchingCubes.h), keeping only its largest component with -largestSurface.
+int preprocessVolume(const itk::CommandLineArgumentParser::Pointer &parser,
+                     const itk::Logger::Pointer &logger);
+
+#endif //SKELTOOLS_PREPROCESS_H
@@ -0,0 +1,51 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+
+#ifndef SKELTOOLS_RESAMPLENEAREST_H
+#define SKELTOOLS_RESAMPLENEAREST_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/// \brief Size of a volume of inputSize voxels of inputSpacing resampled to outputSpacing, such that
+/// the resampled grid starts at the first voxel and covers the last one: ceil((n-1)*in/out)+1.
+std::array<std::size_t, 3>
+resampledSize(const std::array<std::size_t, 3> &inputSize, const std::array<double, 3> &inputSpacing,
+              const std::array<double, 3> &outputSpacing);
+
+/// \brief Nearest input index of every output sample along one axis, -1 past the last input sample.
+///
+/// Output sample k sits at k*outputSpacing and input sample j at j*inputSpacing; halfway points go
+/// to the higher index, as interp3(..., 'nearest') does.
+std::vector<std::ptrdiff_t>
+nearestIndexMap(std::size_t inputSize, double inputSpacing, std::size_t outputSize, double outputSpacing);
+
+/// \brief Nearest neighbour resampling of an x fastest volume to new voxel dimensions.
+///
+/// Nearest neighbour resampling is separable: every output voxel reads the input voxel given by
+/// the index maps of its three coordinates, so no coordinate arrays are built. Output slices are
+/// filled in parallel. Samples past the input get outsideValue.
+template<typename TInput, typename TOutput>
+void resampleNearest(const TInput *input, const std::array<std::size_t, 3> &inputSize,
+                     const std::array<double, 3> &inputSpacing,
+                     TOutput *output, const std::array<std::size_t, 3> &outputSize,
+                     const std::array<double, 3> &outputSpacing,
+                     TOutput outsideValue, unsigned numThreads = 0);
+
+#include "resampleNearest.hxx"
+#endif //SKELTOOLS_RESAMPLENEAREST_H
@@ -0,0 +1,82 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+
+#ifndef SKELTOOLS_RESAMPLENEAREST_HXX
+#define SKELTOOLS_RESAMPLENEAREST_HXX
+
+#include <cmath>
+
+#include "streamingUtils.h"
+
+inline std::array<std::size_t, 3>
+resampledSize(const std::array<std::size_t, 3> &inputSize, const std::array<double, 3> &inputSpacing,
+              const std::array<double, 3> &outputSpacing) {
+    std::array<std::size_t, 3> outputSize{};
+    for (unsigned d = 0; d < 3; ++d) {
+        outputSize[d] = inputSize[d] == 0 ? 0 :
+                        static_cast<std::size_t>(std::ceil((inputSize[d] - 1) * inputSpacing[d] / outputSpacing[d])) + 1;
+    }
+    return outputSize;
+}
+
+inline std::vector<std::ptrdiff_t>
+nearestIndexMap(std::size_t inputSize, double inputSpacing, std::size_t outputSize, double outputSpacing) {
+    std::vector<std::ptrdiff_t> map(outputSize, -1);
+    if (inputSize == 0) return map;
+    const double last = (inputSize - 1) * inputSpacing;
+    for (std::size_t k = 0; k < outputSize; ++k) {
+        const double position = k * outputSpacing;
+        if (position > last) break;
+        map[k] = std::min<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(std::floor(position / inputSpacing + 0.5)),
+                                          inputSize - 1);
+    }
+    return map;
+}
+
+template<typename TInput, typename TOutput>
+void resampleNearest(const TInput *input, const std::array<std::size_t, 3> &inputSize,
+                     const std::array<double, 3> &inputSpacing,
+                     TOutput *output, const std::array<std::size_t, 3> &outputSize,
+                     const std::array<double, 3> &outputSpacing,
+                     TOutput outsideValue, unsigned numThreads) {
+    std::array<std::vector<std::ptrdiff_t>, 3> maps;
+    for (unsigned d = 0; d < 3; ++d) {
+        maps[d] = nearestIndexMap(inputSize[d], inputSpacing[d], outputSize[d], outputSpacing[d]);
+    }
+    const std::size_t inputRow = inputSize[0], inputSlice = inputSize[0] * inputSize[1];
+    const std::size_t outputRow = outputSize[0], outputSlice = outputSize[0] * outputSize[1];
+    streaming::parallelFor(outputSize[2], numThreads, [&](std::size_t z, unsigned) {
+        TOutput *out = output + z * outputSlice;
+        if (maps[2][z] < 0) {
+            std::fill(out, out + outputSlice, outsideValue);
+            return;
+        }
+        const TInput *slice = input + maps[2][z] * inputSlice;
+        for (std::size_t y = 0; y < outputSize[1]; ++y, out += outputRow) {
+            if (maps[1][y] < 0) {
+                std::fill(out, out + outputRow, outsideValue);
+                continue;
+            }
+            const TInput *row = slice + maps[1][y] * inputRow;
+            for (std::size_t x = 0; x < outputRow; ++x) {
+                out[x] = maps[0][x] < 0 ? outsideValue : static_cast<TOutput>(row[maps[0][x]]);
+            }
+        }
+    });
+}
+
+#endif //SKELTOOLS_RESAMPLENEAREST_HXX
@@ -0,0 +1,57 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+#ifndef SKELTOOLS_STREAMINGCOMPONENTS_H
+#define SKELTOOLS_STREAMINGCOMPONENTS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// \brief Options of removeSmallComponents.
+struct ComponentFilterOptions {
+    /// components with fewer voxels are removed.
+    uint64_t minSize = 0;
+    /// keep only the largest component (the first one in scan order on ties), ignoring minSize.
+    bool keepLargest = false;
+    /// number of slices along the slowest axis labelled at once by one thread.
+    std::size_t slabDepth = 32;
+    /// 0 uses std::thread::hardware_concurrency().
+    unsigned numThreads = 0;
+};
+
+struct ComponentFilterStatistics {
+    uint64_t numComponents = 0;
+    uint64_t numKept = 0;
+};
+
+/// \brief Keeps the 26-connected components of the non zero voxels of input that pass options.
+///
+/// input and output are x fastest buffers of size[0] x size[1] x size[2] voxels (the memory order
+/// of both ITK and MATLAB arrays) and may be the same buffer. output is set to 1 for kept voxels
+/// and 0 elsewhere.
+///
+/// Slabs of options.slabDepth slices are labelled independently in parallel and their
+/// components are joined across slab boundaries with a union-find over the slab components.
+/// Only the slabs in flight and two boundary slices per slab are ever labelled at the same time,
+/// so no label volume is held; the slabs are labelled a second time to write the output.
+template<typename TPixel>
+ComponentFilterStatistics
+removeSmallComponents(const TPixel *input, uint8_t *output, const std::array<std::size_t, 3> &size,
+                      const ComponentFilterOptions &options);
+
+#include "streamingComponents.hxx"
+#endif //SKELTOOLS_STREAMINGCOMPONENTS_H
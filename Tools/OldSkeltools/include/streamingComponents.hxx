@@ -0,0 +1,181 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+#ifndef SKELTOOLS_STREAMINGCOMPONENTS_HXX
+#define SKELTOOLS_STREAMINGCOMPONENTS_HXX
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "streamingUtils.h"
+
+namespace streaming {
+
+    /// 26-connected components of the non zero voxels of one slab.
+    struct SlabLabels {
+        /// 0 for background, else 1 ... sizes.size() numbered in order of the first voxel.
+        std::vector<uint32_t> labels;
+        std::vector<uint64_t> sizes;
+        /// provisional label equivalences, kept to reuse the allocation.
+        std::vector<uint32_t> parent;
+    };
+
+    /// labels slices [z0, z1) of input with a raster scan over the 13 already visited neighbours.
+    template<typename TPixel>
+    void labelSlab(const TPixel *input, const std::array<std::size_t, 3> &size,
+                   std::size_t z0, std::size_t z1, SlabLabels &slab) {
+        const std::size_t nx = size[0], ny = size[1], sliceSize = nx * ny;
+        slab.labels.assign((z1 - z0) * sliceSize, 0);
+        slab.parent.assign(1, 0);
+        for (std::size_t z = z0; z < z1; ++z) {
+            for (std::size_t y = 0; y < ny; ++y) {
+                for (std::size_t x = 0; x < nx; ++x) {
+                    const std::size_t local = ((z - z0) * ny + y) * nx + x;
+                    if (!input[z * sliceSize + y * nx + x]) continue;
+                    uint32_t label = 0;
+                    auto visit = [&](std::size_t neighbour) {
+                        const uint32_t other = slab.labels[neighbour];
+                        if (!other) return;
+                        if (!label) label = other;
+                        else uniteRoots(slab.parent, label, other);
+                    };
+                    for (int dz = -1; dz <= 0; ++dz) {
+                        if (dz < 0 && z == z0) continue;
+                        for (int dy = -1; dy <= (dz < 0 ? 1 : 0); ++dy) {
+                            if ((dy < 0 && y == 0) || (dy > 0 && y + 1 == ny)) continue;
+                            for (int dx = -1; dx <= ((dz < 0 || dy < 0) ? 1 : -1); ++dx) {
+                                if ((dx < 0 && x == 0) || (dx > 0 && x + 1 == nx)) continue;
+                                visit(local + dz * sliceSize + dy * nx + dx);
+                            }
+                        }
+                    }
+                    if (!label) {
+                        label = static_cast<uint32_t>(slab.parent.size());
+                        slab.parent.push_back(label);
+                    }
+                    slab.labels[local] = label;
+                }
+            }
+        }
+
+        std::vector<uint32_t> compact(slab.parent.size(), 0);
+        slab.sizes.clear();
+        for (auto &label : slab.labels) {
+            if (!label) continue;
+            const uint32_t root = findRoot(slab.parent, label);
+            if (!compact[root]) {
+                slab.sizes.push_back(0);
+                compact[root] = static_cast<uint32_t>(slab.sizes.size());
+            }
+            label = compact[root];
+            ++slab.sizes[label - 1];
+        }
+    }
+}
+
+template<typename TPixel>
+ComponentFilterStatistics
+removeSmallComponents(const TPixel *input, uint8_t *output, const std::array<std::size_t, 3> &size,
+                      const ComponentFilterOptions &options) {
+    using namespace streaming;
+    ComponentFilterStatistics statistics;
+    const std::size_t nx = size[0], ny = size[1], nz = size[2], sliceSize = nx * ny;
+    if (nx == 0 || ny == 0 || nz == 0) return statistics;
+    const std::size_t slabDepth = std::max<std::size_t>(1, options.slabDepth);
+    const std::size_t numSlabs = (nz + slabDepth - 1) / slabDepth;
+    unsigned numThreads = options.numThreads;
+    if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Pass 1: components of every slab, keeping only their sizes and boundary slices
+    std::vector<std::vector<uint64_t>> slabSizes(numSlabs);
+    std::vector<std::vector<uint32_t>> firstSlices(numSlabs), lastSlices(numSlabs);
+    std::vector<SlabLabels> scratch(numThreads);
+    parallelFor(numSlabs, numThreads, [&](std::size_t s, unsigned t) {
+        const std::size_t z0 = s * slabDepth, z1 = std::min(nz, z0 + slabDepth);
+        SlabLabels &slab = scratch[t];
+        labelSlab(input, size, z0, z1, slab);
+        slabSizes[s] = slab.sizes;
+        firstSlices[s].assign(slab.labels.begin(), slab.labels.begin() + sliceSize);
+        lastSlices[s].assign(slab.labels.end() - sliceSize, slab.labels.end());
+    });
+
+    // Join the slab components across the boundaries
+    std::vector<uint64_t> offsets(numSlabs + 1, 0);
+    for (std::size_t s = 0; s < numSlabs; ++s) offsets[s + 1] = offsets[s] + slabSizes[s].size();
+    const uint64_t numSlabComponents = offsets[numSlabs];
+    std::vector<uint64_t> parent(numSlabComponents);
+    std::iota(parent.begin(), parent.end(), 0);
+    for (std::size_t s = 1; s < numSlabs; ++s) {
+        const std::vector<uint32_t> &below = lastSlices[s - 1], &above = firstSlices[s];
+        for (std::size_t y = 0; y < ny; ++y) {
+            for (std::size_t x = 0; x < nx; ++x) {
+                const uint32_t a = above[y * nx + x];
+                if (!a) continue;
+                for (std::size_t yy = (y ? y - 1 : 0); yy <= std::min(ny - 1, y + 1); ++yy) {
+                    for (std::size_t xx = (x ? x - 1 : 0); xx <= std::min(nx - 1, x + 1); ++xx) {
+                        const uint32_t b = below[yy * nx + xx];
+                        if (b) uniteRoots(parent, offsets[s] + a - 1, offsets[s - 1] + b - 1);
+                    }
+                }
+            }
+        }
+        std::vector<uint32_t>().swap(lastSlices[s - 1]);
+        std::vector<uint32_t>().swap(firstSlices[s]);
+    }
+
+    std::vector<uint64_t> rootSizes(numSlabComponents, 0);
+    for (std::size_t s = 0; s < numSlabs; ++s) {
+        for (std::size_t c = 0; c < slabSizes[s].size(); ++c) {
+            rootSizes[findRoot(parent, offsets[s] + c)] += slabSizes[s][c];
+        }
+    }
+    std::vector<char> keep(numSlabComponents, 0);
+    uint64_t largest = numSlabComponents;
+    for (uint64_t c = 0; c < numSlabComponents; ++c) {
+        if (parent[c] != c) continue;
+        ++statistics.numComponents;
+        if (options.keepLargest) {
+            if (largest == numSlabComponents || rootSizes[c] > rootSizes[largest]) largest = c;
+        } else if (rootSizes[c] >= options.minSize) {
+            keep[c] = 1;
+            ++statistics.numKept;
+        }
+    }
+    if (options.keepLargest && largest < numSlabComponents) {
+        keep[largest] = 1;
+        statistics.numKept = 1;
+    }
+    // per slab component, so that pass 2 only reads
+    for (uint64_t c = 0; c < numSlabComponents; ++c) keep[c] = keep[findRoot(parent, c)];
+    std::vector<uint64_t>().swap(parent);
+    std::vector<uint64_t>().swap(rootSizes);
+
+    // Pass 2: label every slab again and write the kept voxels
+    parallelFor(numSlabs, numThreads, [&](std::size_t s, unsigned t) {
+        const std::size_t z0 = s * slabDepth, z1 = std::min(nz, z0 + slabDepth);
+        SlabLabels &slab = scratch[t];
+        labelSlab(input, size, z0, z1, slab);
+        uint8_t *out = output + z0 * sliceSize;
+        for (std::size_t i = 0; i < slab.labels.size(); ++i) {
+            out[i] = slab.labels[i] && keep[offsets[s] + slab.labels[i] - 1] ? 1 : 0;
+        }
+    });
+    return statistics;
+}
+
+#endif //SKELTOOLS_STREAMINGCOMPONENTS_HXX
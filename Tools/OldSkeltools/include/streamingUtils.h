@@ -0,0 +1,67 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+
+#ifndef SKELTOOLS_STREAMINGUTILS_H
+#define SKELTOOLS_STREAMINGUTILS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace streaming {
+
+    template<typename TIndex>
+    TIndex findRoot(std::vector<TIndex> &parent, TIndex x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    /// links the root with the larger id below the other, so every root is the lowest id of its set.
+    template<typename TIndex>
+    void uniteRoots(std::vector<TIndex> &parent, TIndex a, TIndex b) {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a < b) parent[b] = a;
+        else if (b < a) parent[a] = b;
+    }
+
+    /// runs work(i, thread) for i in [0, count) on up to numThreads threads (0: all cores).
+    template<typename Work>
+    void parallelFor(std::size_t count, unsigned numThreads, const Work &work) {
+        if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+        numThreads = static_cast<unsigned>(std::min<std::size_t>(numThreads, count));
+        if (numThreads <= 1) {
+            for (std::size_t i = 0; i < count; ++i) work(i, 0u);
+            return;
+        }
+        std::atomic<std::size_t> next(0);
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (std::size_t i = next++; i < count; i = next++) work(i, t);
+            });
+        }
+        for (auto &thread : threads) thread.join();
+    }
+}
+
+#endif //SKELTOOLS_STREAMINGUTILS_H
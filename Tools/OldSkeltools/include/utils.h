@@ -33,5 +33,10 @@ typename TImage::Pointer readImage(const std::string & filePath);
 template<typename TData>
 typename itk::Array2D<TData> readCSV(const std::string & datapath);
 
+/// copies the pixels of region from source into destination; both must buffer region.
+template<typename TImage>
+void copyImageRegion(const typename TImage::Pointer &source, const typename TImage::Pointer &destination,
+                     const typename TImage::RegionType &region);
+
 #include "utils.hxx"
 #endif //MEDIALTOOLS_UTILS_H
@@ -21,6 +21,8 @@
 
 #include <itkImageFileWriter.h>
 #include <itkImageFileReader.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
 
 template<typename TImage>
 void writeImage(const std::string & filePath, const typename TImage::Pointer &image,unsigned divisions) {
@@ -68,4 +70,14 @@ typename itk::Array2D<TData> readCSV(const std::string & datapath) {
         return dataObject->GetMatrix();
 }
 
+template<typename TImage>
+void copyImageRegion(const typename TImage::Pointer &source, const typename TImage::Pointer &destination,
+                     const typename TImage::RegionType &region) {
+    itk::ImageRegionConstIterator<TImage> sourceIt(source, region);
+    itk::ImageRegionIterator<TImage> destinationIt(destination, region);
+    for (sourceIt.GoToBegin(), destinationIt.GoToBegin(); !sourceIt.IsAtEnd(); ++sourceIt, ++destinationIt) {
+        destinationIt.Set(sourceIt.Get());
+    }
+}
+
 #endif //MEDIALTOOLS_UTILS_HXX
@@ -29,6 +29,7 @@
 #include "itkCommandLineArgumentParser.h"
 #include "utils.h"
 #include "medial.h"
+#include "preprocess.h"
 
 namespace fs = std::experimental::filesystem;
 
@@ -154,6 +155,20 @@ int computeMedialStructure(const itk::CommandLineArgumentParser::Pointer &parser
     bool lowMemory = parser->ArgumentExists("-lowMemory");
     if(lowMemory) logger->Info("Using The low memory option!\n");
 
+    MedialParameters params;
+    if (!readMedialParameters(parser, logger, params)) {
+        logger->Critical("Could not resolve medial parameters\n");
+        return EXIT_FAILURE;
+    }
+
+    if (parser->ArgumentExists("-changedMask") || parser->ArgumentExists("-changedRegion")) {
+        if (lowMemory || !parser->ArgumentExists("-medialSurface")) {
+            logger->Critical("Incremental updates are only supported for -medialSurface without -lowMemory\n");
+            return EXIT_FAILURE;
+        }
+        return updateMedialSurface<DistanceImageType, FluxImageType, OutputImageType>(parser, params, logger);
+    }
+
     fs::path distanceMapFilePath = outputFolderPath / "signedDistanceMap.tif";
     fs::path spokeFilePath = outputFolderPath / "CPT.tif";
     typename DistanceImageType::Pointer distanceMap;
@@ -166,12 +181,12 @@ int computeMedialStructure(const itk::CommandLineArgumentParser::Pointer &parser
     if (!fs::exists(distanceMapFilePath) || (!lowMemory && !fs::exists(spokeFilePath)) ) {
         if (lowMemory){
             logger->Info("Computing distance map without spokes\n");
-            distanceMap = computeAstrocyteSignedDistanceMapWithoutSpokes<DistanceImageType>(parser,logger);
+            distanceMap = computeAstrocyteSignedDistanceMapWithoutSpokes<DistanceImageType>(parser,params,logger);
             //writeImage<DistanceImageType>(distanceMapFileName, distanceMap);
         }
         else {
             logger->Info("Computing distance map\n");
-            auto distClosesPointPair = computeAstrocyteSignedDistanceMap<DistanceImageType>(parser, logger);
+            auto distClosesPointPair = computeAstrocyteSignedDistanceMap<DistanceImageType>(parser, params, logger);
             distanceMap = distClosesPointPair.first;
             writeImage<DistanceImageType>(distanceMapFilePath, distanceMap);
             spokeField = distClosesPointPair.second;
@@ -186,26 +201,30 @@ int computeMedialStructure(const itk::CommandLineArgumentParser::Pointer &parser
             logger->Info("reading already computed distance map + spokeFile..\n");
             distanceMap = readImage<DistanceImageType>(distanceMapFilePath);
             spokeField = readImage<DisplacementImageType>(spokeFilePath);
+            spokeField->SetSpacing(typename DisplacementImageType::SpacingType(params.spacing.data()));
         }
+        // tif does not keep the physical spacing the AOF and the outputs rely on.
+        distanceMap->SetSpacing(typename DistanceImageType::SpacingType(params.spacing.data()));
     }
     fs::path aofFilePath = outputFolderPath / "aof.tif";
     typename FluxImageType::Pointer aof, aof2;
 
     if (!fs::exists(aofFilePath) ){
         if(lowMemory){
-            aof = computeAOF<DistanceImageType>(parser,logger,lowMemory);
+            aof = computeAOF<DistanceImageType>(parser,params,logger,lowMemory);
             //writeImage<FluxImageType>(aofFileName, aof);
         }
         else {
             aof = computeAOFFromSpokes<DistanceValueType, DistanceImageType::ImageDimension, DistanceValueType>(
-                    spokeField);
+                    spokeField, params.useImageSpacing);
             writeImage<FluxImageType>(aofFilePath, aof);
         }
     }else{
         logger->Info("reading already computed m_AOF map..\n");
         aof = readImage<FluxImageType >(aofFilePath);
+        aof->SetSpacing(typename FluxImageType::SpacingType(params.spacing.data()));
     }
-    compute(parser, distanceMap, aof, logger);
+    compute(parser, distanceMap, aof, params, logger);
 
     return EXIT_SUCCESS;
 }
@@ -227,12 +246,72 @@ std::string helpstring() {
     ss << "\t -endpoints\n";
     ss << "\t\t path to file containing endpoints to be fixed for medial surface\n";
 
+    ss << "\t -config\n";
+    ss << "\t\t path to a key = value parameter file (spacing, gaussianVariance, smoothingThreshold,\n";
+    ss << "\t\t objectThreshold, spokeMaskFactor, surfaceAofThreshold, curveAofThreshold)\n";
+
+    ss << "\t -spacingFromHeader\n";
+    ss << "\t\t take the voxel spacing from the input image header\n";
+
+    ss << "\t -spacing <sx> <sy> <sz>\n";
+    ss << "\t\t voxel spacing (default 4.1341146 4.1341146 8)\n";
+
+    ss << "\t -useImageSpacing <0|1>\n";
+    ss << "\t\t compute the AOF in physical space (default 1, 0 for index space)\n";
+
+    ss << "\t -gaussianVariance, -smoothingThreshold, -objectThreshold, -spokeMaskFactor,\n";
+    ss << "\t -surfaceAofThreshold, -curveAofThreshold\n";
+    ss << "\t\t override the corresponding config file entry\n";
+
+    ss << "\t -exportPoints\n";
+    ss << "\t\t also write medialSurfacePoints.skpt: skeleton voxels with physical position,\n";
+    ss << "\t\t radius, AOF and topological label\n";
+
+    ss << "\t -exportGraph\n";
+    ss << "\t\t as -exportPoints, plus the 26-adjacency edges between skeleton voxels\n";
+
+    ss << "\t -changedMask\n";
+    ss << "\t\t non zero where the input was edited; updates the cached results of a previous\n";
+    ss << "\t\t -medialSurface run around the edit instead of recomputing everything\n";
+
+    ss << "\t -changedRegion <i0> <j0> <k0> <i1> <j1> <k1>\n";
+    ss << "\t\t index bounding box of the edit, alternative to -changedMask\n";
+
+    ss << "\t -halo\n";
+    ss << "\t\t fixed number of voxels recomputed around the edit and the smoothing kernel\n";
+    ss << "\t\t (default: grown until the old distances show nothing further out can change)\n";
+
+    ss << "\t -verifyUpdate\n";
+    ss << "\t\t after an update, compare the distance map with a full recomputation\n";
+
+    ss << "\t -output\n";
+    ss << "\t\t -preprocess: path of the preprocessed mask (default <input stem>_preprocessed.tif)\n";
+
+    ss << "\t -minObjectSize <n>\n";
+    ss << "\t\t -preprocess: remove 26-connected objects with fewer than n voxels\n";
+
+    ss << "\t -keepLargest\n";
+    ss << "\t\t -preprocess: keep only the largest 26-connected object\n";
+
+    ss << "\t -resampleSpacing <sx> <sy> <sz>\n";
+    ss << "\t\t -preprocess: nearest neighbour resampling of the mask from -spacing to this spacing\n";
+
+    ss << "\t -surface <file.obj>\n";
+    ss << "\t\t -preprocess: also write the marching cubes surface of the preprocessed mask\n";
+
+    ss << "\t -largestSurface\n";
+    ss << "\t\t -preprocess: keep only the largest connected component of -surface\n";
+
+    ss << "\t -slabDepth <n>, -threads <n>\n";
+    ss << "\t\t -preprocess: slices per slab (default 32) and number of threads (default all)\n";
+
     ss << "\t -h, --help\n";
     ss << "\t\t display this help\n";
 
     ss << "\t -medialSurface       ::(medial Surface computation)\n";
     ss << "\t -medialCurve         ::(medial curve computation)\n";
     ss << "\t -lowMemory           ::(use when system memory is limited)\n";
+    ss << "\t -preprocess          ::(mask clean up before meshing)\n";
     //------------------------------------------------------------------------
     ss << "\n\n";
     ss << "Examples:\n";
@@ -270,12 +349,14 @@ int main(int argc, char* argv[]){
     std::map<int, std::string> modesMap;
     modesMap[0] = "Medial Surface\n";
     modesMap[1] = "Medial Curve\n";
+    modesMap[2] = "Preprocess\n";
     modesMap[93] = "Undocumented/Experimental\n";
 
     std::vector<std::string> modules;
     modules.emplace_back("-medialSurface");
     modules.emplace_back("-experiment");
     modules.emplace_back("-medialCurve");
+    modules.emplace_back("-preprocess");
 
     parser->SetCommandLineArguments(argc, argv);
     parser->SetProgramHelpText(helpstring());
@@ -304,6 +385,9 @@ int main(int argc, char* argv[]){
     } else if(parser->ArgumentExists("-medialCurve")) {
         module = 1;
         logger->Info("Selected: " + modesMap[module] + "\n");
+    } else if(parser->ArgumentExists("-preprocess")) {
+        module = 2;
+        logger->Info("Selected: " + modesMap[module] + "\n");
     } else if (parser->ArgumentExists("-experiment")) {
         module = 93;
         logger->Info("Selected : " + modesMap[module] + "\n");
@@ -323,6 +407,8 @@ int main(int argc, char* argv[]){
         case 1: // medial Curve Computation
             computeMedialStructure<DistanceImageType, FluxImageType, AstrocyteImageType>(parser, logger, computeMedialCurve<DistanceImageType, FluxImageType, AstrocyteImageType>);
             break;
+        case 2: // mask preprocessing
+            return preprocessVolume(parser, logger);
         case 93:
             // experiment(parser, logger);
             break;
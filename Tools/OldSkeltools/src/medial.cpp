@@ -22,19 +22,22 @@
 template
 itk::Image<float,3>::Pointer
 computeAstrocyteSignedDistanceMapWithoutSpokes<itk::Image<float,3>>(const itk::CommandLineArgumentParser::Pointer &parser,
+                                                                    const MedialParameters &params,
                                                                     const itk::Logger::Pointer &logger);
 
 template itk::Image<float,3>::Pointer computeAOF< itk::Image<float,3> >(const itk::CommandLineArgumentParser::Pointer &parser,
+                                                                        const MedialParameters &params,
                                                                         const itk::Logger::Pointer &logger,bool);
 
 //template itk::Image<float,3>::Pointer computeAOF< itk::Image<float,3> >(itk::Image<float,3>::Pointer signedDistanceFunction,bool);
 
 template itk::Image<float,3>::Pointer
-computeAOFFromSpokes<float,3,float>(itk::Image<itk::Vector<float, 3>, 3>::Pointer spokeField);
+computeAOFFromSpokes<float,3,float>(itk::Image<itk::Vector<float, 3>, 3>::Pointer spokeField, bool useImageSpacing);
 
 template
 std::pair<itk::Image<float,3>::Pointer, itk::Image<itk::Vector<float,3>, 3>::Pointer>
 computeAstrocyteSignedDistanceMap<itk::Image<float,3>>(const itk::CommandLineArgumentParser::Pointer &parser,
+                                                       const MedialParameters &params,
                                                        const itk::Logger::Pointer &logger);
 
 template
@@ -43,13 +46,70 @@ skeletonToBoundaryMap<itk::Image<float,3>, itk::Image<unsigned char,3>>( itk::Im
                                                                          itk::Image<unsigned char,3>::Pointer boundary);
 
 
-void mapWeightedSkeletonToBoundary(const std::string & weightedSkeletonFileName, const std::string & objectFileName){
+bool readChangedRegion(const itk::CommandLineArgumentParser::Pointer &parser,
+                       const itk::ImageRegion<3> &largestRegion,
+                       itk::ImageRegion<3> &changedRegion,
+                       const itk::Logger::Pointer &logger){
+    constexpr unsigned Dimension = 3;
+    using IndexType = itk::ImageRegion<Dimension>::IndexType;
+    using SizeType = itk::ImageRegion<Dimension>::SizeType;
+    IndexType lower, upper;
+
+    std::vector<itk::IndexValueType> bounds;
+    std::string changedMaskFilename;
+    if (parser->GetCommandLineArgument("-changedRegion", bounds)) {
+        if (bounds.size() != 2 * Dimension) {
+            logger->Critical("-changedRegion expects i0 j0 k0 i1 j1 k1\n");
+            return false;
+        }
+        for (unsigned d = 0; d < Dimension; ++d) {
+            lower[d] = std::min(bounds[d], bounds[d + Dimension]);
+            upper[d] = std::max(bounds[d], bounds[d + Dimension]);
+        }
+    } else if (parser->GetCommandLineArgument("-changedMask", changedMaskFilename)) {
+        using ChangedImageType = itk::Image<unsigned char, Dimension>;
+        ChangedImageType::Pointer changed = readImage<ChangedImageType>(changedMaskFilename);
+        if (changed->GetLargestPossibleRegion() != largestRegion) {
+            logger->Critical("Changed mask does not match the size of the cached results\n");
+            return false;
+        }
+        lower = largestRegion.GetUpperIndex();
+        upper = largestRegion.GetIndex();
+        bool anyChanged = false;
+        itk::ImageRegionConstIteratorWithIndex<ChangedImageType> cit(changed, largestRegion);
+        for (cit.GoToBegin(); !cit.IsAtEnd(); ++cit) {
+            if (cit.Get() == 0) continue;
+            anyChanged = true;
+            const IndexType &index = cit.GetIndex();
+            for (unsigned d = 0; d < Dimension; ++d) {
+                lower[d] = std::min(lower[d], index[d]);
+                upper[d] = std::max(upper[d], index[d]);
+            }
+        }
+        if (!anyChanged) {
+            changedRegion = itk::ImageRegion<Dimension>(largestRegion.GetIndex(), SizeType{{0, 0, 0}});
+            return true;
+        }
+    } else {
+        logger->Critical("Incremental update needs -changedMask or -changedRegion\n");
+        return false;
+    }
+
+    changedRegion.SetIndex(lower);
+    changedRegion.SetUpperIndex(upper);
+    if (!changedRegion.Crop(largestRegion)) {
+        changedRegion.SetSize(SizeType{{0, 0, 0}});
+    }
+    return true;
+}
+
+void mapWeightedSkeletonToBoundary(const std::string & weightedSkeletonFileName, const std::string & objectFileName,
+                                   const MedialParameters &params){
     constexpr unsigned Dimension = 3;
     using SkeletonImageType = itk::Image<float, Dimension>;
     using BoundaryPixelType = unsigned char;
     using BoundaryImageType =itk::Image<BoundaryPixelType, Dimension>;
-    BoundaryImageType::SpacingType spacing;
-    spacing[0] = 4.1341146; spacing[1] = 4.1341146; spacing[2] = 8.0;
+    BoundaryImageType::SpacingType spacing(params.spacing.data());
 
     typename SkeletonImageType::Pointer skel = readImage<SkeletonImageType>(weightedSkeletonFileName);
     using SkeletonInformationChangeFilterType = itk::ChangeInformationImageFilter< SkeletonImageType >;
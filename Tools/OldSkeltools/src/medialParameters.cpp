@@ -0,0 +1,160 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+
+#include <itkImageIOFactory.h>
+
+#include "medialParameters.h"
+
+namespace {
+    bool parseValues(const std::string &text, std::vector<double> &values) {
+        std::string cleaned(text);
+        std::replace(cleaned.begin(), cleaned.end(), ',', ' ');
+        std::istringstream ss(cleaned);
+        double value;
+        values.clear();
+        while (ss >> value) values.push_back(value);
+        return ss.eof() && !values.empty();
+    }
+
+    template<size_t N>
+    bool assignArray(const std::vector<double> &values, std::array<double, N> &target) {
+        if (values.size() == 1) {
+            target.fill(values[0]);
+            return true;
+        }
+        if (values.size() != N) return false;
+        std::copy(values.begin(), values.end(), target.begin());
+        return true;
+    }
+
+    bool assignParameter(const std::string &key, const std::vector<double> &values, MedialParameters &params) {
+        if (key == "spacing") return assignArray(values, params.spacing);
+        if (key == "gaussianVariance") return assignArray(values, params.gaussianVariance);
+        if (values.size() != 1) return false;
+        if (key == "smoothingThreshold") params.smoothingThreshold = values[0];
+        else if (key == "objectThreshold") params.objectThreshold = values[0];
+        else if (key == "spokeMaskFactor") params.spokeMaskFactor = values[0];
+        else if (key == "surfaceAofThreshold") params.surfaceAofThreshold = values[0];
+        else if (key == "curveAofThreshold") params.curveAofThreshold = values[0];
+        else if (key == "useImageSpacing") params.useImageSpacing = values[0] != 0;
+        else return false;
+        return true;
+    }
+}
+
+std::string MedialParameters::ToString() const {
+    std::ostringstream ss;
+    ss << "spacing = " << spacing[0] << " " << spacing[1] << " " << spacing[2] << "\n";
+    ss << "gaussianVariance = " << gaussianVariance[0] << " " << gaussianVariance[1] << " " << gaussianVariance[2] << "\n";
+    ss << "smoothingThreshold = " << smoothingThreshold << "\n";
+    ss << "objectThreshold = " << objectThreshold << "\n";
+    ss << "spokeMaskFactor = " << spokeMaskFactor << "\n";
+    ss << "surfaceAofThreshold = " << surfaceAofThreshold << "\n";
+    ss << "curveAofThreshold = " << curveAofThreshold << "\n";
+    ss << "useImageSpacing = " << useImageSpacing << "\n";
+    return ss.str();
+}
+
+bool readMedialParameterFile(const std::string &filePath,
+                             const itk::Logger::Pointer &logger,
+                             MedialParameters &params) {
+    std::ifstream file(filePath);
+    if (!file) {
+        logger->Error("Could not open parameter file " + filePath + "\n");
+        return false;
+    }
+    std::string line;
+    std::vector<double> values;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                logger->Error(filePath + ":" + std::to_string(lineNumber) + " expected key = value\n");
+                return false;
+            }
+            continue;
+        }
+        std::string key = line.substr(0, separator);
+        key.erase(std::remove_if(key.begin(), key.end(), ::isspace), key.end());
+        if (!parseValues(line.substr(separator + 1), values) || !assignParameter(key, values, params)) {
+            logger->Error(filePath + ":" + std::to_string(lineNumber) + " invalid parameter " + key + "\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool readMedialParameters(const itk::CommandLineArgumentParser::Pointer &parser,
+                          const itk::Logger::Pointer &logger,
+                          MedialParameters &params) {
+    std::string inputFilename;
+    if (parser->ArgumentExists("-spacingFromHeader") && parser->GetCommandLineArgument("-input", inputFilename)) {
+        itk::ImageIOBase::Pointer imageIO =
+                itk::ImageIOFactory::CreateImageIO(inputFilename.c_str(), itk::ImageIOFactory::ReadMode);
+        if (!imageIO) {
+            logger->Error("No ImageIO available to read the header of " + inputFilename + "\n");
+            return false;
+        }
+        imageIO->SetFileName(inputFilename);
+        imageIO->ReadImageInformation();
+        for (unsigned d = 0; d < std::min(imageIO->GetNumberOfDimensions(), MedialParameters::Dimension); ++d) {
+            params.spacing[d] = imageIO->GetSpacing(d);
+        }
+    }
+
+    std::string configFilename;
+    if (parser->GetCommandLineArgument("-config", configFilename) &&
+        !readMedialParameterFile(configFilename, logger, params)) {
+        return false;
+    }
+
+    const std::vector<std::pair<std::string, std::string>> overrides = {
+            {"-spacing",             "spacing"},
+            {"-gaussianVariance",    "gaussianVariance"},
+            {"-smoothingThreshold",  "smoothingThreshold"},
+            {"-objectThreshold",     "objectThreshold"},
+            {"-spokeMaskFactor",     "spokeMaskFactor"},
+            {"-surfaceAofThreshold", "surfaceAofThreshold"},
+            {"-curveAofThreshold",   "curveAofThreshold"},
+            {"-useImageSpacing",     "useImageSpacing"}};
+    std::vector<double> values;
+    for (const auto &entry: overrides) {
+        if (!parser->ArgumentExists(entry.first)) continue;
+        values.clear();
+        if (!parser->GetCommandLineArgument(entry.first, values) || !assignParameter(entry.second, values, params)) {
+            logger->Error("Invalid value for " + entry.first + "\n");
+            return false;
+        }
+    }
+
+    for (double s: params.spacing) {
+        if (!(s > 0)) {
+            logger->Error("Voxel spacing must be positive\n");
+            return false;
+        }
+    }
+    logger->Info("Medial parameters:\n" + params.ToString());
+    return true;
+}
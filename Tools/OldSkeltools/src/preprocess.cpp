@@ -0,0 +1,140 @@
+//**********************************************************
+//Copyright 2021 Tabish Syed
+//
+//Licensed under the Apache License, Version 2.0 (the "License");
+//you may not use this file except in compliance with the License.
+//You may obtain a copy of the License at
+//
+//http://www.apache.org/licenses/LICENSE-2.0
+//
+//Unless required by applicable law or agreed to in writing, software
+//distributed under the License is distributed on an "AS IS" BASIS,
+//WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//See the License for the specific language governing permissions and
+//limitations under the License.
+//**********************************************************
+
+#include <cstdlib>
+#include <experimental/filesystem>
+#include <fstream>
+
+#include <itkImage.h>
+
+#include "marchingCubes.h"
+#include "medialParameters.h"
+#include "preprocess.h"
+#include "resampleNearest.h"
+#include "streamingComponents.h"
+#include "utils.h"
+
+namespace fs = std::experimental::filesystem;
+
+static bool writeObj(const std::string &filename, const SurfaceMesh &mesh) {
+    std::ofstream file(filename);
+    if (!file) return false;
+    file.precision(10);
+    for (const auto &vertex : mesh.vertices) {
+        file << "v " << vertex[0] << " " << vertex[1] << " " << vertex[2] << "\n";
+    }
+    for (const auto &face : mesh.faces) {
+        file << "f " << face[0] + 1 << " " << face[1] + 1 << " " << face[2] + 1 << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+int preprocessVolume(const itk::CommandLineArgumentParser::Pointer &parser,
+                     const itk::Logger::Pointer &logger) {
+    using MaskImageType = itk::Image<unsigned char, 3>;
+
+    std::string inputFilename, outputFilename;
+    if (!parser->GetCommandLineArgument("-input", inputFilename)) {
+        logger->Error("Input file not specified\n");
+        return EXIT_FAILURE;
+    }
+    fs::path inputFilePath = inputFilename;
+    if (!fs::exists(inputFilePath)) {
+        logger->Critical("File " + inputFilename + " not found\n");
+        return EXIT_FAILURE;
+    }
+    if (!parser->GetCommandLineArgument("-output", outputFilename)) {
+        outputFilename = (inputFilePath.parent_path() / (inputFilePath.stem().string() + "_preprocessed.tif")).string();
+        logger->Info("-output missing using default: " + outputFilename + "\n");
+    }
+    unsigned numThreads = 0;
+    parser->GetCommandLineArgument("-threads", numThreads);
+
+    logger->Info("Reading input image...\n");
+    MaskImageType::Pointer mask = readImage<MaskImageType>(inputFilename);
+    MaskImageType::SizeType size = mask->GetLargestPossibleRegion().GetSize();
+
+    if (parser->ArgumentExists("-minObjectSize") || parser->ArgumentExists("-keepLargest")) {
+        ComponentFilterOptions options;
+        options.numThreads = numThreads;
+        options.keepLargest = parser->ArgumentExists("-keepLargest");
+        parser->GetCommandLineArgument("-minObjectSize", options.minSize);
+        parser->GetCommandLineArgument("-slabDepth", options.slabDepth);
+        logger->Info("Removing small objects\n");
+        unsigned char *buffer = mask->GetBufferPointer();
+        ComponentFilterStatistics statistics =
+                removeSmallComponents(buffer, buffer, {size[0], size[1], size[2]}, options);
+        logger->Info("# of connected objects in original volume: " + std::to_string(statistics.numComponents) + "\n");
+        logger->Info("# of connected objects kept: " + std::to_string(statistics.numKept) + "\n");
+    }
+
+    std::vector<double> resampleSpacing;
+    if (parser->GetCommandLineArgument("-resampleSpacing", resampleSpacing)) {
+        MedialParameters params;
+        if (!readMedialParameters(parser, logger, params)) {
+            logger->Critical("Could not resolve the input spacing\n");
+            return EXIT_FAILURE;
+        }
+        if (resampleSpacing.size() == 1) resampleSpacing.resize(3, resampleSpacing[0]);
+        if (resampleSpacing.size() != 3) {
+            logger->Critical("-resampleSpacing expects 1 or 3 values\n");
+            return EXIT_FAILURE;
+        }
+        const std::array<double, 3> outputSpacing{{resampleSpacing[0], resampleSpacing[1], resampleSpacing[2]}};
+        const std::array<std::size_t, 3> inputSize{{size[0], size[1], size[2]}};
+        const std::array<std::size_t, 3> outputSize = resampledSize(inputSize, params.spacing, outputSpacing);
+        logger->Info("Resampling to " + std::to_string(outputSize[0]) + " x " + std::to_string(outputSize[1]) +
+                     " x " + std::to_string(outputSize[2]) + " voxels\n");
+
+        MaskImageType::SizeType resampledImageSize;
+        for (unsigned d = 0; d < 3; ++d) resampledImageSize[d] = outputSize[d];
+        MaskImageType::RegionType region;
+        region.SetSize(resampledImageSize);
+        MaskImageType::Pointer resampled = MaskImageType::New();
+        resampled->SetRegions(region);
+        resampled->SetSpacing(outputSpacing.data());
+        resampled->Allocate();
+        resampleNearest(mask->GetBufferPointer(), inputSize, params.spacing,
+                        resampled->GetBufferPointer(), outputSize, outputSpacing,
+                        static_cast<unsigned char>(0), numThreads);
+        mask = resampled;
+        size = resampledImageSize;
+    }
+
+    writeImage<MaskImageType>(outputFilename, mask);
+
+    std::string surfaceFilename;
+    if (parser->GetCommandLineArgument("-surface", surfaceFilename)) {
+        SurfaceOptions options;
+        options.numThreads = numThreads;
+        options.keepLargest = parser->ArgumentExists("-largestSurface");
+        parser->GetCommandLineArgument("-slabDepth", options.slabDepth);
+        const MaskImageType::SpacingType &spacing = mask->GetSpacing();
+        logger->Info("Extracting surface\n");
+        const SurfaceMesh mesh = extractSurface(mask->GetBufferPointer(), {size[0], size[1], size[2]},
+                                                {spacing[0], spacing[1], spacing[2]}, options);
+        if (options.keepLargest) {
+            logger->Info("# of connected surfaces: " + std::to_string(mesh.numComponents) + "\n");
+        }
+        logger->Info("Surface has " + std::to_string(mesh.vertices.size()) + " vertices and " +
+                     std::to_string(mesh.faces.size()) + " faces\n");
+        if (!writeObj(surfaceFilename, mesh)) {
+            logger->Critical("Could not write " + surfaceFilename + "\n");
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}